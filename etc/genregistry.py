@@ -19,6 +19,7 @@ parser.add_argument("config")
 parser.add_argument("config_header_path")
 parser.add_argument("out_path")
 parser.add_argument("--print_deps", action="store_true")
+parser.add_argument("--print_families", action="store_true")
 parser.add_argument("--print", action="store_true")
 parser.add_argument("--generate_files", action="store_true")
 parser.add_argument("--group", type=int)
@@ -99,6 +100,9 @@ algorithms_cpp_head = '''
     /* Autogenerated file by genregistry.py */
 '''
 
+def family_symbol(family_ident):
+    return "tdc_register_" + family_ident
+
 def root_cpp(kinds):
     r = Code()
 
@@ -113,8 +117,8 @@ def root_cpp(kinds):
     ''')
     r.emptyline()
 
-    # Generate calls to each template expansion of a kind of Registry
-    for (type, calls) in kinds:
+    # Register each family of a kind of Registry
+    for (type, families) in kinds:
         ident = type.lower()
         const = type.upper()
 
@@ -125,21 +129,22 @@ def root_cpp(kinds):
         ''', 1, { "$TYPE": type, "$IDENT": ident, "$CONST": const })
         r.emptyline()
 
-        # Forward-declare all template expansion calls
-        for call in calls:
+        # Weakly declare the families, such that they can be left out at
+        # link time
+        for family in families:
             r.code('''
-                void register_$CALL(Registry<$TYPE>& r);
-            ''', 1, { "$CALL": call, "$TYPE": type })
+                extern "C" void $SYMBOL(Registry<$TYPE>& r) __attribute__((weak));
+            ''', 1, { "$SYMBOL": family_symbol(family), "$TYPE": type })
         r.emptyline()
 
         # Define the register functions
         r.code('''
             void register_$IDENTs(Registry<$TYPE>& r) {
         ''', 1, { "$TYPE": type, "$IDENT": ident, "$CONST": const })
-        for call in calls:
+        for family in families:
             r.code('''
-                register_$CALL(r);
-            ''', 2, { "$CALL": call})
+                if ($SYMBOL) r.register_family($SYMBOL);
+            ''', 2, { "$SYMBOL": family_symbol(family) })
         r.code('''
             } // register_$IDENTs
         ''', 1, { "$TYPE": type, "$IDENT": ident, "$CONST": const })
@@ -149,6 +154,43 @@ def root_cpp(kinds):
     ''')
     return r.str()
 
+def family_cpp(kind, family_ident, calls):
+    r = Code()
+
+    # Header of family_*.cpp file
+    r.code(algorithms_cpp_head)
+    r.emptyline()
+    r.code('''
+        #include <tudocomp_driver/Registry.hpp>
+
+        namespace tdc_algorithms {
+            using namespace tdc;
+    ''')
+    r.emptyline()
+
+    # Forward-declare all template expansion calls
+    for call in calls:
+        r.code('''
+            void register_$CALL(Registry<$TYPE>& r);
+        ''', 1, { "$CALL": call, "$TYPE": kind })
+    r.emptyline()
+
+    # Define the family's register function
+    r.code('''
+        extern "C" void $SYMBOL(Registry<$TYPE>& r) {
+    ''', 1, { "$SYMBOL": family_symbol(family_ident), "$TYPE": kind })
+    for call in calls:
+        r.code('''
+            register_$CALL(r);
+        ''', 2, { "$CALL": call })
+    r.code('''
+        } // $SYMBOL
+    ''', 1, { "$SYMBOL": family_symbol(family_ident) })
+    r.code('''
+        } // namespace
+    ''')
+    return r.str()
+
 def single_expansion_cpp(kind, call_ident, call_type, headers):
     r = Code()
 
@@ -245,6 +287,55 @@ def update_file(path, content):
         if actually_written_content == content:
             break
 
+def escape(line):
+    return line \
+        .replace('<', '_') \
+        .replace('>', '_') \
+        .replace(',', '_') \
+        .replace(':', '_')
+
+# Splits the instances into up to n groups along their template hierachy
+def group_instances(instances, n):
+    instance_groups = [instances]
+    while len(instance_groups) < n:
+        first = instance_groups[0]
+        if len(first) == 1:
+            break
+        instance_groups.pop(0)
+
+        counter = OrderedDict()
+        for x in first:
+            # count each name only once per instance
+            for b in OrderedDict.fromkeys(x.hierachy):
+                if not b in counter: counter[b] = 0
+                counter[b] += 1
+
+        counter_l = []
+        for k in counter:
+            counter_l.append((k, counter[k]))
+
+        counter_l.sort(key=itemgetter(1))
+        counter_l.reverse()
+
+        while counter_l[0][1] == len(first):
+            counter_l.pop(0)
+        #pprint.pprint(counter_l)
+
+        head = []
+        tail = []
+        for ins in first:
+            if counter_l[0][0] in ins.hierachy:
+                head.append(ins)
+            else:
+                tail.append(ins)
+        instance_groups.append(head)
+        instance_groups.append(tail)
+
+        instance_groups.sort(key=lambda x: len(x))
+        instance_groups.reverse()
+
+    return instance_groups
+
 # Output algorithm.cpp
 def gen_algorithm_cpp():
     Instance = collections.namedtuple("Instance", [
@@ -254,43 +345,61 @@ def gen_algorithm_cpp():
         "content",
     ])
 
-    kind_instances = []
+    # Each top-level algorithm forms a family of all its template expansions,
+    # registered by a function in its own file. The root file references the
+    # families only weakly, so unused ones can be left out at link time.
+    Family = collections.namedtuple("Family", [
+        "identifier",
+        "instances",
+    ])
+
+    kind_families = []
 
     for (kind, l) in kinds:
-        instances = []
-        for (headers, line, hierachy) in gen_list(l):
-            hsh = make_hash(line)[0:10]
-            escaped_line = line \
-                .replace('<', '_') \
-                .replace('>', '_') \
-                .replace(',', '_') \
-                .replace(':', '_')
-            escaped_hash_line =  hsh + "_" + escaped_line
-            #print(escaped_hash_line, len(escaped_hash_line))
-
-            path = os.path.join(out_path, escaped_hash_line + ".cpp")
-            #print(path)
-
-            instance_content = single_expansion_cpp(kind, escaped_hash_line, line, headers)
-
-            instances.append(Instance(
-                escaped_hash_line,
-                hierachy,
-                path,
-                instance_content
+        families = []
+        for algorithm in l:
+            instances = []
+            for (headers, line, hierachy) in gen_list([algorithm]):
+                hsh = make_hash(line)[0:10]
+                escaped_hash_line =  hsh + "_" + escape(line)
+                #print(escaped_hash_line, len(escaped_hash_line))
+
+                path = os.path.join(out_path, escaped_hash_line + ".cpp")
+                #print(path)
+
+                instance_content = single_expansion_cpp(kind, escaped_hash_line, line, headers)
+
+                instances.append(Instance(
+                    escaped_hash_line,
+                    hierachy,
+                    path,
+                    instance_content
+                ))
+            families.append(Family(
+                kind.lower() + "_" + escape(algorithm.name),
+                instances
             ))
-        kind_instances.append((kind, instances))
+        kind_families.append((kind, families))
 
-    for (kind, instances) in kind_instances:
-        for instance in instances:
-            iprint(instance.hierachy)
-            iprint(instance.file_name)
-            iprint(instance.content)
+    if args.print_families:
+        family_idents = []
+        for (kind, families) in kind_families:
+            family_idents += [f.identifier for f in families]
+        sys.stdout.write(";".join(family_idents))
+        sys.stdout.flush()
 
-            if args.generate_files:
-                update_file(instance.file_name, instance.content)
+    for (kind, families) in kind_families:
+        for family in families:
+            for instance in family.instances:
+                iprint(instance.hierachy)
+                iprint(instance.file_name)
+                iprint(instance.content)
+
+                if args.generate_files:
+                    update_file(instance.file_name, instance.content)
 
-    root_content = root_cpp(list(map(lambda t: (t[0], list(map(lambda x: x.identifier, t[1]))), kind_instances)))
+    root_content = root_cpp([(kind, [f.identifier for f in families])
+                             for (kind, families) in kind_families])
     root_file =  os.path.join(out_path, "root" + ".cpp")
     iprint(root_file)
     iprint(root_content)
@@ -299,66 +408,43 @@ def gen_algorithm_cpp():
 
     dep_paths = [root_file]
 
-    for (kind, instances) in kind_instances:
-        if not args.group or len(instances) < args.group:
-            dep_paths += list(map(lambda x: x.file_name, instances))
-        else:
-            instance_groups = [instances]
-            while len(instance_groups) < args.group:
-                first = instance_groups[0]
-                if len(first) == 1:
-                    break
-                instance_groups.pop(0)
-
-                counter = OrderedDict()
-                for x in first:
-                    for b in x.hierachy:
-                        if not b in counter: counter[b] = 0
-                        counter[b] += 1
-
-                counter_l = []
-                for k in counter:
-                    counter_l.append((k, counter[k]))
-
-                counter_l.sort(key=itemgetter(1))
-                counter_l.reverse()
-
-                while counter_l[0][1] == len(first):
-                    counter_l.pop(0)
-                #pprint.pprint(counter_l)
-
-                head = []
-                tail = []
-                for ins in first:
-                    if counter_l[0][0] in ins.hierachy:
-                        head.append(ins)
-                    else:
-                        tail.append(ins)
-                instance_groups.append(head)
-                instance_groups.append(tail)
-
-                #pprint.pprint(list(map(lambda y: list(map(lambda x: x.file_name, y)), instance_groups)))
-
-                instance_groups.sort(key=lambda x: len(x))
-                instance_groups.reverse()
-
-                #print("Current grouping:")
-                #pprint.pprint([len(x) for x in instance_groups])
-
-            group_paths = []
-            for group in instance_groups:
-                conc = "".join([x.identifier for x in group])
-                group_file_name = "group_" + make_hash(conc) + ".cpp"
-                group_content = "".join([x.content for x in group])
-                group_file_path = os.path.join(out_path, group_file_name)
-                group_paths.append(group_file_path)
-
-                iprint(group_file_name)
-                iprint(group_content)
-                if args.generate_files:
-                    update_file(group_file_path, group_content)
+    for (kind, families) in kind_families:
+        kind_size = sum([len(f.instances) for f in families])
+        for family in families:
+            instances = family.instances
+
+            family_content = family_cpp(kind, family.identifier,
+                                        [x.identifier for x in instances])
+            family_file = os.path.join(out_path,
+                                       "family_" + family.identifier + ".cpp")
+            iprint(family_file)
+            iprint(family_content)
+            if args.generate_files:
+                update_file(family_file, family_content)
+            dep_paths.append(family_file)
 
-            dep_paths += group_paths
+            # distribute the groups among the families by their size
+            num_groups = 0
+            if args.group:
+                num_groups = max(1, (args.group * len(instances)) // kind_size)
+
+            if num_groups == 0 or len(instances) < num_groups:
+                dep_paths += list(map(lambda x: x.file_name, instances))
+            else:
+                group_paths = []
+                for group in group_instances(instances, num_groups):
+                    conc = "".join([x.identifier for x in group])
+                    group_file_name = "group_" + make_hash(conc) + ".cpp"
+                    group_content = "".join([x.content for x in group])
+                    group_file_path = os.path.join(out_path, group_file_name)
+                    group_paths.append(group_file_path)
+
+                    iprint(group_file_name)
+                    iprint(group_content)
+                    if args.generate_files:
+                        update_file(group_file_path, group_content)
+
+                dep_paths += group_paths
 
     dep_paths = list(set(dep_paths))
 
@@ -20,6 +20,7 @@ universal_coders = [
 # Entropy coders
 entropy_coders = [
     AlgorithmConfig(name="HuffmanCoder", header="coders/HuffmanCoder.hpp"),
+    AlgorithmConfig(name="BlockHuffmanCoder", header="coders/BlockHuffmanCoder.hpp"),
 ]
 
 # Entropy coders that may consume characters without immediately generating an
@@ -30,11 +31,18 @@ consuming_entropy_coders = [
     AlgorithmConfig(name="SLECoder", header="coders/SLECoder.hpp"),
 ]
 
+# Entropy coders that hold back their output blockwise, such that they keep
+# the order of the values they encode, but must not share their output stream
+# with other coders
+blockwise_entropy_coders = [
+    AlgorithmConfig(name="RANSCoder", header="coders/RANSCoder.hpp"),
+]
+
 # All non-consuming coders
 non_consuming_coders = universal_coders + entropy_coders
 
 # All coders
-all_coders = universal_coders + entropy_coders + consuming_entropy_coders
+all_coders = universal_coders + entropy_coders + consuming_entropy_coders + blockwise_entropy_coders
 
 ##### Text data structures #####
 
@@ -46,16 +54,19 @@ sa = [
 # Phi Array
 phi = [
     AlgorithmConfig(name="PhiFromSA", header="ds/PhiFromSA.hpp"),
+    AlgorithmConfig(name="PhiFromSAParallel", header="ds/PhiFromSAParallel.hpp"),
 ]
 
 # PLCP Array
 plcp = [
     AlgorithmConfig(name="PLCPFromPhi", header="ds/PLCPFromPhi.hpp"),
+    AlgorithmConfig(name="PLCPFromPhiParallel", header="ds/PLCPFromPhiParallel.hpp"),
 ]
 
 # Uncompressed LCP Array
 lcp_uncompressed = [
     AlgorithmConfig(name="LCPFromPLCP", header="ds/LCPFromPLCP.hpp"),
+    AlgorithmConfig(name="LCPFromPLCPParallel", header="ds/LCPFromPLCPParallel.hpp"),
 ]
 
 # All LCP Arrays
@@ -139,6 +150,8 @@ lcpcomp_coders = [
     AlgorithmConfig(name="ASCIICoder", header="coders/ASCIICoder.hpp"),
     AlgorithmConfig(name="SLECoder", header="coders/SLECoder.hpp"),
     AlgorithmConfig(name="HuffmanCoder", header="coders/HuffmanCoder.hpp"),
+    AlgorithmConfig(name="BlockHuffmanCoder", header="coders/BlockHuffmanCoder.hpp"),
+    AlgorithmConfig(name="RANSCoder", header="coders/RANSCoder.hpp"),
 ]
 
 # lcpcomp factorization strategies ("comp")
@@ -146,6 +159,7 @@ lcpcomp_comp = [
     AlgorithmConfig(name="lcpcomp::MaxHeapStrategy", header="compressors/lcpcomp/compress/MaxHeapStrategy.hpp"),
     AlgorithmConfig(name="lcpcomp::MaxLCPStrategy", header="compressors/lcpcomp/compress/MaxLCPStrategy.hpp"),
     AlgorithmConfig(name="lcpcomp::ArraysComp", header="compressors/lcpcomp/compress/ArraysComp.hpp"),
+    AlgorithmConfig(name="lcpcomp::PLCPArraysComp", header="compressors/lcpcomp/compress/PLCPArraysComp.hpp"),
     AlgorithmConfig(name="lcpcomp::PLCPPeaksStrategy", header="compressors/lcpcomp/compress/PLCPPeaksStrategy.hpp"),
 ]
 
@@ -161,6 +175,8 @@ lcpcomp_dec = [
     AlgorithmConfig(name="lcpcomp::DecodeForwardQueueListBuffer", header="compressors/lcpcomp/decompress/DecodeQueueListBuffer.hpp"),
     AlgorithmConfig(name="lcpcomp::CompactDec", header="compressors/lcpcomp/decompress/CompactDec.hpp"),
     AlgorithmConfig(name="lcpcomp::MultimapBuffer", header="compressors/lcpcomp/decompress/MultiMapBuffer.hpp"),
+    AlgorithmConfig(name="lcpcomp::ExtDec", header="compressors/lcpcomp/decompress/ExtDec.hpp"),
+    AlgorithmConfig(name="lcpcomp::ParallelDec", header="compressors/lcpcomp/decompress/ParallelDec.hpp"),
 ]
 
 # Allowed TextDS instances for lcpcomp (LCP array must be writable!)
@@ -172,6 +188,7 @@ lcpcomp_textds = [
 ipd = [
     AlgorithmConfig(name="esp::StdUnorderedMapIPD", header="compressors/esp/StdUnorderedMapIPD.hpp"),
     AlgorithmConfig(name="esp::HashMapIPD", header="compressors/esp/HashMapIPD.hpp"),
+    AlgorithmConfig(name="esp::LinearProbingIPD", header="compressors/esp/LinearProbingIPD.hpp"),
 ]
 
 ipddyn = ipd + [
@@ -231,8 +248,8 @@ tdc.compressors = [
     AlgorithmConfig(name="LiteralEncoder", header="compressors/LiteralEncoder.hpp", sub=[all_coders]),
     AlgorithmConfig(name="LZ78Compressor", header="compressors/LZ78Compressor.hpp", sub=[universal_coders, lz78_trie]),
     AlgorithmConfig(name="LZWCompressor", header="compressors/LZWCompressor.hpp", sub=[universal_coders, lz78_trie]),
-    AlgorithmConfig(name="RePairCompressor", header="compressors/RePairCompressor.hpp", sub=[non_consuming_coders]),
-    AlgorithmConfig(name="LZSSLCPCompressor", header="compressors/LZSSLCPCompressor.hpp", sub=[non_consuming_coders, textds]),
+    AlgorithmConfig(name="RePairCompressor", header="compressors/RePairCompressor.hpp", sub=[non_consuming_coders + blockwise_entropy_coders]),
+    AlgorithmConfig(name="LZSSLCPCompressor", header="compressors/LZSSLCPCompressor.hpp", sub=[non_consuming_coders + blockwise_entropy_coders, textds]),
     AlgorithmConfig(name="LZSSSlidingWindowCompressor", header="compressors/LZSSSlidingWindowCompressor.hpp", sub=[universal_coders]),
     AlgorithmConfig(name="MTFCompressor", header="compressors/MTFCompressor.hpp"),
     AlgorithmConfig(name="NoopCompressor", header="compressors/NoopCompressor.hpp"),
@@ -146,6 +146,74 @@ public:
     }
 };
 
+/// \cond INTERNAL
+namespace coder_batch {
+    // the coder's own batch implementation, if it has one for the range
+    template<typename coder_t, typename value_t, typename range_t>
+    inline auto encode(coder_t& coder, const value_t* values, size_t n,
+        const range_t& r, int) -> decltype(coder.encode_batch(values, n, r)) {
+
+        return coder.encode_batch(values, n, r);
+    }
+
+    template<typename coder_t, typename value_t, typename range_t>
+    inline void encode(coder_t& coder, const value_t* values, size_t n,
+        const range_t& r, long) {
+
+        for(size_t i = 0; i < n; ++i) coder.encode(values[i], r);
+    }
+
+    template<typename coder_t, typename value_t, typename range_t>
+    inline auto decode(coder_t& decoder, value_t* values, size_t n,
+        const range_t& r, int) -> decltype(decoder.decode_batch(values, n, r)) {
+
+        return decoder.decode_batch(values, n, r);
+    }
+
+    template<typename coder_t, typename value_t, typename range_t>
+    inline void decode(coder_t& decoder, value_t* values, size_t n,
+        const range_t& r, long) {
+
+        for(size_t i = 0; i < n; ++i) {
+            values[i] = decoder.template decode<value_t>(r);
+        }
+    }
+}
+/// \endcond
+
+/// \brief Encodes a sequence of values of the same range.
+///
+/// The result equals encoding each value on its own. Coders can provide a
+/// member \c encode_batch for a range to encode the values at once, e.g., to
+/// compute the properties of the range only once. Otherwise, the values are
+/// encoded one by one.
+///
+/// \param coder The encoder.
+/// \param values The values to encode.
+/// \param n The amount of values.
+/// \param r The range of all values.
+template<typename coder_t, typename value_t, typename range_t>
+inline void encode_batch(
+    coder_t& coder, const value_t* values, size_t n, const range_t& r) {
+
+    coder_batch::encode(coder, values, n, r, 0);
+}
+
+/// \brief Decodes a sequence of values encoded by \ref encode_batch.
+///
+/// Coders can provide a member \c decode_batch for a range analogously.
+///
+/// \param decoder The decoder.
+/// \param values The buffer to decode the values into.
+/// \param n The amount of values.
+/// \param r The range of all values.
+template<typename coder_t, typename value_t, typename range_t>
+inline void decode_batch(
+    coder_t& decoder, value_t* values, size_t n, const range_t& r) {
+
+    coder_batch::decode(decoder, values, n, r, 0);
+}
+
 /// \brief Defines constructors for clases inheriting from \ref tdc::Decoder.
 ///
 /// This includes a convenience constructor that automatically opens a
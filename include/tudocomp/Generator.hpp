@@ -1,22 +1,67 @@
 #pragma once
 
+#include <cstring>
 #include <functional>
 #include <memory>
 
 #include <tudocomp/pre_header/Registry.hpp>
 #include <tudocomp/pre_header/Env.hpp>
 #include <tudocomp/Algorithm.hpp>
+#include <tudocomp/io.hpp>
+#include <tudocomp/io/ChunkStream.hpp>
 
 namespace tdc {
 
 /// \brief Base for string generators.
 class Generator : public Algorithm {
 public:
+    /// \brief Creates a new fill function (see \ref io::ChunkStream)
+    ///        producing the generated string from its beginning.
+    using make_fill_fn_t = std::function<io::ChunkStream::fill_fn_t()>;
+
+    /// \brief Creates an input that streams a generated string chunk by chunk.
+    ///
+    /// Every stream opened on the input uses a new fill function, hence the
+    /// string is never held in memory as a whole unless a view on the input
+    /// is requested.
+    ///
+    /// \param make_fill creates the fill functions.
+    /// \param size the length of the generated string.
+    /// \return the streaming input.
+    inline static Input stream_input(make_fill_fn_t make_fill, size_t size) {
+        return Input([make_fill]() {
+            return std::unique_ptr<std::istream>(
+                new io::ChunkStream(make_fill()));
+        }, size);
+    }
+
     using Algorithm::Algorithm;
 
     /// \brief Generates a string based on the environment settings.
     /// \return the generated string.
     virtual std::string generate() = 0;
+
+    /// \brief Provides the string generated based on the environment
+    ///        settings as an input.
+    ///
+    /// The default implementation generates the whole string in memory.
+    /// Generators that can produce their string incrementally override this
+    /// to return a streaming input (see \ref stream_input), which allows
+    /// for strings larger than the available memory.
+    ///
+    /// \return the generated string as an input.
+    inline virtual Input input() {
+        auto s = std::make_shared<std::string>(generate());
+        return stream_input([s]() {
+            size_t pos = 0;
+            return [s, pos](char* buf, size_t n) mutable {
+                n = std::min(n, s->size() - pos);
+                std::memcpy(buf, s->data() + pos, n);
+                pos += n;
+                return n;
+            };
+        }, s->size());
+    }
 };
 
 }
@@ -34,17 +34,17 @@ namespace tdc {
 
         /// \brief Yields the range's minimum value
         /// \return the range's minimum value
-        inline size_t min() const { return m_min; }
+        inline constexpr size_t min() const { return m_min; }
 
         /// \brief Yields the range's maximum value
         /// \return the range's maximum value
-        inline size_t max() const { return m_max; }
+        inline constexpr size_t max() const { return m_max; }
 
         /// \brief Yields the difference between the range's minimum and maximum
         ///        values
         /// \return the difference between the range's minimum and maximum
         ///         values
-        inline size_t delta() const { return m_max - m_min; }
+        inline constexpr size_t delta() const { return m_max - m_min; }
     };
 
     /// \brief Represents a range of positive integers that tend to be
@@ -6,31 +6,116 @@
 /// \cond INTERNAL
 namespace tdc {
 
+template<typename algorithm_t>
+template<typename T>
+inline std::unique_ptr<algorithm_t> Registry<algorithm_t>::construct(Env&& env) {
+    return std::make_unique<T>(std::move(env));
+}
+
 template<typename algorithm_t>
 template<typename T>
 inline void Registry<algorithm_t>::register_algorithm() {
-    auto meta = T::meta();
+    auto& families = m_data->m_families;
+    if (!m_data->m_in_family) {
+        families.emplace_back();
+    }
+    families.back().m_entries.push_back(Entry {
+        &T::meta, &construct<T>
+    });
+}
 
-    ast::Value s = std::move(meta).build_static_args_ast_value();
+template<typename algorithm_t>
+inline void Registry<algorithm_t>::register_family(std::function<void(Registry&)> f) {
+    CHECK(!m_data->m_in_family) << "families cannot be nested";
+    m_data->m_families.emplace_back();
+    m_data->m_in_family = true;
+    f(*this);
+    m_data->m_in_family = false;
+}
 
-    gather_types(m_data->m_algorithms, std::move(meta));
+template<typename algorithm_t>
+inline const std::string& Registry<algorithm_t>::family_name(Family& family) const {
+    if (!family.m_named) {
+        if (!family.m_entries.empty()) {
+            family.m_name = family.m_entries.front().meta().name();
+        }
+        family.m_named = true;
+    }
+    return family.m_name;
+}
 
-    auto static_s
-        = eval::pattern_eval(std::move(s), m_root_type, m_data->m_algorithms);
+template<typename algorithm_t>
+inline void Registry<algorithm_t>::load_family(Family& family) const {
+    if (family.m_loaded) return;
+    family.m_loaded = true;
 
-    CHECK(m_data->m_registered.count(static_s) == 0) << "registered twice"; // Don't register twice...
-    m_data->m_registered[std::move(static_s)] = [](Env&& env) {
-        return std::make_unique<T>(std::move(env));
-    };
+    for (auto& entry : family.m_entries) {
+        auto meta = entry.meta();
+
+        ast::Value s = std::move(meta).build_static_args_ast_value();
+
+        gather_types(m_data->m_algorithms, std::move(meta));
+
+        auto static_s
+            = eval::pattern_eval(std::move(s), m_root_type, m_data->m_algorithms);
+
+        CHECK(m_data->m_registered.count(static_s) == 0) << "registered twice"; // Don't register twice...
+        m_data->m_registered[std::move(static_s)] = entry.construct;
+    }
+
+    family.m_entries.clear();
+    family.m_entries.shrink_to_fit();
+}
+
+template<typename algorithm_t>
+inline bool Registry<algorithm_t>::load_by_name(const std::string& name) const {
+    bool found = false;
+    for (auto& family : m_data->m_families) {
+        if (family_name(family) != name) continue;
+        found = true;
+
+        if (family.m_loaded) continue;
+        load_family(family);
+
+        // default values may refer to further algorithms of the root type
+        for (auto& algo : m_data->m_algorithms[m_root_type]) {
+            if (algo.name() != name) continue;
+            for (auto& arg : algo.arguments()) {
+                if (arg.type() == m_root_type && arg.has_default()) {
+                    load_for(arg.default_value());
+                }
+            }
+        }
+    }
+    return found;
+}
+
+template<typename algorithm_t>
+inline void Registry<algorithm_t>::load_all() const {
+    for (auto& family : m_data->m_families) {
+        load_family(family);
+    }
+}
+
+template<typename algorithm_t>
+inline void Registry<algorithm_t>::load_for(const ast::Value& value) const {
+    if (!value.is_invokation()) return;
+
+    load_by_name(value.invokation_name());
+    for (auto& arg : value.invokation_arguments()) {
+        load_for(arg.value());
+    }
 }
 
 template<typename algorithm_t>
 inline eval::AlgorithmTypes& Registry<algorithm_t>::algorithm_map() {
+    load_all();
     return m_data->m_algorithms;
 }
 
 template<typename algorithm_t>
 inline const eval::AlgorithmTypes& Registry<algorithm_t>::algorithm_map() const {
+    load_all();
     return m_data->m_algorithms;
 }
 
@@ -125,6 +210,7 @@ template<typename algorithm_t>
 inline std::vector<pattern::Algorithm> Registry<algorithm_t>::all_algorithms_with_static(View type) const {
     std::vector<pattern::Algorithm> filtered_r;
 
+    load_all();
     std::vector<AlreadySeenPair> already_seen;
     for (auto x : all_algorithms_with_static_internal(already_seen, type)) {
         if (m_data->m_registered.count(x) > 0) {
@@ -183,6 +269,8 @@ inline std::string Registry<algorithm_t>::generate_doc_string(const std::string&
         return indent_lines(make_table(cells, 2), iden);
     };
 
+    load_all();
+
     std::stringstream ss;
 
     ss << "  [" << title << "]\n";
@@ -202,6 +290,8 @@ inline std::string Registry<algorithm_t>::generate_doc_string(const std::string&
 
 template<typename algorithm_t>
 inline std::unique_ptr<algorithm_t> Registry<algorithm_t>::select_algorithm(const AlgorithmValue& algo) const {
+    load_by_name(algo.name());
+
     auto& static_only_evald_algo = algo.static_selection();
 
     if (m_data->m_registered.count(static_only_evald_algo) > 0) {
@@ -223,6 +313,14 @@ inline AlgorithmValue Registry<algorithm_t>::parse_algorithm_id(
 
     ast::Parser p { text };
     auto parsed_algo = p.parse_value();
+
+    if (!parsed_algo.is_invokation()
+        || !load_by_name(parsed_algo.invokation_name())) {
+        // unknown name, evaluate everything for a complete error message
+        load_all();
+    }
+    load_for(parsed_algo);
+
     auto options = eval::cl_eval(std::move(parsed_algo),
                                     m_root_type,
                                     m_data->m_algorithms);
@@ -10,6 +10,10 @@ namespace tdc {
 ///
 /// All values are encoded a binary, using as many bits as necessary to store
 /// the maximum value of the respective \ref Range.
+///
+/// For ranges known at compile time (\ref FixedRange and \ref TypeRange,
+/// e.g., \ref literal_r and \ref len_r), the bit width is a constant, so the
+/// bit stream operations are specialized for it.
 class BitCoder : public Algorithm {
 public:
     inline static Meta meta() {
@@ -23,12 +27,70 @@ public:
     class Encoder : public tdc::Encoder {
     public:
         using tdc::Encoder::Encoder;
+        using tdc::Encoder::encode;
+
+        /// \brief Encodes a value of a range fixed at compile time.
+        template<typename value_t, size_t t_min, size_t t_max>
+        inline void encode(value_t v, const FixedRange<t_min, t_max>&) {
+            constexpr size_t bits = bits_for(t_max - t_min);
+            m_out->write_int(v - t_min, bits);
+        }
+
+        /// \brief Encodes a value of the range of a type.
+        template<typename value_t, typename T>
+        inline void encode(value_t v, const TypeRange<T>&) {
+            constexpr size_t bits = bits_for(std::numeric_limits<T>::max());
+            m_out->write_int(v, bits);
+        }
+
+        /// \brief Encodes a sequence of values of the same range at once.
+        template<typename value_t>
+        inline void encode_batch(const value_t* values, size_t n, const Range& r) {
+            m_out->write_ints(values, n, bits_for(r.max() - r.min()), r.min());
+        }
+
+        template<typename value_t>
+        inline void encode_batch(const value_t* values, size_t n, const BitRange&) {
+            BitOStream& out = *m_out;
+            for(size_t i = 0; i < n; ++i) out.write_bit(values[i]);
+        }
     };
 
     /// \brief Decodes data from a binary stream.
     class Decoder : public tdc::Decoder {
     public:
         using tdc::Decoder::Decoder;
+        using tdc::Decoder::decode;
+
+        /// \brief Decodes a value of a range fixed at compile time.
+        template<typename value_t, size_t t_min, size_t t_max>
+        inline value_t decode(const FixedRange<t_min, t_max>&) {
+            constexpr size_t bits = bits_for(t_max - t_min);
+            return value_t(t_min) + m_in->read_int<value_t>(bits);
+        }
+
+        /// \brief Decodes a value of the range of a type.
+        template<typename value_t, typename T>
+        inline value_t decode(const TypeRange<T>&) {
+            constexpr size_t bits = bits_for(std::numeric_limits<T>::max());
+            return m_in->read_int<value_t>(bits);
+        }
+
+        /// \brief Decodes a sequence of values of the same range at once.
+        template<typename value_t>
+        inline void decode_batch(value_t* values, size_t n, const Range& r) {
+            BitIStream& in = *m_in;
+            const size_t bits = bits_for(r.max() - r.min());
+            for(size_t i = 0; i < n; ++i) {
+                values[i] = value_t(r.min()) + in.read_int<value_t>(bits);
+            }
+        }
+
+        template<typename value_t>
+        inline void decode_batch(value_t* values, size_t n, const BitRange&) {
+            BitIStream& in = *m_in;
+            for(size_t i = 0; i < n; ++i) values[i] = value_t(in.read_bit());
+        }
     };
 };
 
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+
+#include <tudocomp/Coder.hpp>
+#include <tudocomp/coders/HuffmanCoder.hpp>
+
+namespace tdc {
+
+/// \cond INTERNAL
+namespace huff {
+
+    /**
+     * A canonical Huffman code that is rebuilt after every block of literals.
+     *
+     * The code of a block is computed from the literal frequencies of the
+     * previous block, so encoder and decoder derive the same code without
+     * storing it. The first block uses a code of equal lengths.
+     * Each frequency is incremented by one such that every literal keeps
+     * a codeword.
+     */
+    class BlockModel {
+        static constexpr size_t sigma = size_t(ULITERAL_MAX)+1;
+        static constexpr size_t max_length = 64;
+
+        const size_t m_block;
+        size_t m_seen;
+        len_compact_t m_counts[sigma];
+
+        // encoding: codeword and its length for each literal
+        size_t m_codeword[sigma];
+        uint8_t m_length[sigma];
+
+        // decoding: literals sorted by (codeword length, value),
+        // and for each length its smallest codeword, the amount of codewords
+        // and the rank of the first literal with that length in m_sorted
+        uliteral_t m_sorted[sigma];
+        size_t m_first_code[max_length+1];
+        size_t m_num[max_length+1];
+        size_t m_first_index[max_length+1];
+
+        inline void rebuild() {
+            len_compact_t C[sigma];
+            uliteral_t map_from_effective[sigma];
+            for(size_t c = 0; c < sigma; ++c) {
+                C[c] = m_counts[c] + 1;
+                map_from_effective[c] = c;
+            }
+
+            const uint8_t*const codelengths = gen_codelengths(C, map_from_effective, sigma);
+            std::copy(codelengths, codelengths + sigma, m_length);
+            delete [] codelengths;
+
+            std::fill(m_num, m_num + max_length + 1, 0);
+            for(size_t c = 0; c < sigma; ++c) {
+                DCHECK_GT(m_length[c], 0);
+                DCHECK_LE(m_length[c], max_length);
+                ++m_num[m_length[c]];
+            }
+
+            size_t code = 0;
+            size_t index = 0;
+            for(size_t l = 1; l <= max_length; ++l) {
+                m_first_code[l] = code;
+                m_first_index[l] = index;
+                code = (code + m_num[l]) << 1;
+                index += m_num[l];
+            }
+
+            size_t fill[max_length+1];
+            std::copy(m_first_index, m_first_index + max_length + 1, fill);
+            for(size_t c = 0; c < sigma; ++c) {
+                const size_t l = m_length[c];
+                m_codeword[c] = m_first_code[l] + (fill[l] - m_first_index[l]);
+                m_sorted[fill[l]++] = c;
+            }
+
+            std::fill(m_counts, m_counts + sigma, 0);
+            m_seen = 0;
+        }
+
+        inline void update(uliteral_t c) {
+            ++m_counts[c];
+            if(++m_seen == m_block) rebuild();
+        }
+
+    public:
+        inline BlockModel(size_t block) : m_block(block) {
+            CHECK_GT(block, 0u) << "the block size must be positive";
+            CHECK_LT(block, size_t(std::numeric_limits<len_compact_t>::max()));
+            std::fill(m_counts, m_counts + sigma, 0);
+            rebuild();
+        }
+
+        inline void encode(tdc::io::BitOStream& os, uliteral_t c) {
+            os.write_int(m_codeword[c], m_length[c]);
+            update(c);
+        }
+
+        inline uliteral_t decode(tdc::io::BitIStream& is) {
+            size_t code = 0;
+            for(size_t l = 1; l <= max_length; ++l) {
+                DCHECK(!is.eof());
+                code = (code << 1) | is.read_bit();
+                if(code - m_first_code[l] < m_num[l]) {
+                    const uliteral_t c = m_sorted[m_first_index[l] + (code - m_first_code[l])];
+                    update(c);
+                    return c;
+                }
+            }
+            DCHECK(false) << "invalid codeword";
+            return 0;
+        }
+    };
+
+}//ns
+/// \endcond
+
+/// \brief Encodes literals with a canonical Huffman code that adapts
+///        blockwise.
+///
+/// Unlike \ref HuffmanCoder, the literals are not scanned in advance.
+/// Instead, the code for each block of literals is computed from the
+/// frequencies in the previous block, so encoding needs constant memory
+/// and can start as soon as the first literal is known.
+/// The decoder rebuilds the same codes, hence no tables are stored.
+class BlockHuffmanCoder : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("coder", "bhuff", "Blockwise adaptive canonical Huffman Coder");
+        m.option("block").dynamic(1 << 16); // literals per block
+        return m;
+    }
+
+    BlockHuffmanCoder() = delete;
+
+    class Encoder : public tdc::Encoder {
+        huff::BlockModel m_model;
+    public:
+        template<typename literals_t>
+        inline Encoder(Env&& env, std::shared_ptr<BitOStream> out, literals_t&& literals)
+            : tdc::Encoder(std::move(env), out, literals)
+            , m_model(this->env().option("block").as_integer()) {
+        }
+
+        template<typename literals_t>
+        inline Encoder(Env&& env, Output& out, literals_t&& literals)
+            : Encoder(std::move(env), std::make_shared<BitOStream>(out), literals) {
+        }
+
+        using tdc::Encoder::encode; // default encoding as fallback
+
+        template<typename value_t>
+        inline void encode(value_t v, const LiteralRange&) {
+            m_model.encode(*m_out, static_cast<uliteral_t>(v));
+        }
+
+        template<typename value_t>
+        inline void encode_batch(const value_t* values, size_t n, const LiteralRange&) {
+            BitOStream& out = *m_out;
+            for(size_t i = 0; i < n; ++i) {
+                m_model.encode(out, static_cast<uliteral_t>(values[i]));
+            }
+        }
+    };
+
+    class Decoder : public tdc::Decoder {
+        huff::BlockModel m_model;
+    public:
+        DECODER_CTOR(env, in)
+            , m_model(this->env().option("block").as_integer()) {
+        }
+
+        using tdc::Decoder::decode; // default decoding as fallback
+
+        template<typename value_t>
+        inline value_t decode(const LiteralRange&) {
+            return value_t(m_model.decode(*m_in));
+        }
+
+        template<typename value_t>
+        inline void decode_batch(value_t* values, size_t n, const LiteralRange&) {
+            BitIStream& in = *m_in;
+            for(size_t i = 0; i < n; ++i) values[i] = value_t(m_model.decode(in));
+        }
+    };
+};
+
+}//ns
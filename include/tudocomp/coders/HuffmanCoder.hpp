@@ -86,6 +86,12 @@ namespace huff {
      *
      **/
     inline uint8_t* gen_codelengths(const len_compact_t*const C, const uliteral_t*const map_from_effective, const size_t alphabet_size) {
+        if(tdc_unlikely(alphabet_size == 1)) {
+            // a tree with a single leaf has no edges, so give the only character a one-bit codeword
+            DVLOG(2) << "Char " << map_from_effective[0] << " : 1";
+            return new uint8_t[1] { 1 };
+        }
+
         size_t A[2*alphabet_size];
         for(size_t i=0; i < alphabet_size; i++) {
             DVLOG(2) << "Char " << map_from_effective[i] << " : " << size_t(C[map_from_effective[i]]);
@@ -437,7 +443,7 @@ namespace huff {
     /** Generates the Huffman table based on some input text
      * @param C @see count_alphabet
      * @attention Deletes the input array C!
-     * @attention C must contain at least two non-zero values
+     * @attention C must contain at least one non-zero value
      */
     inline extended_huffmantable gen_huffmantable(const len_compact_t*const C) {
         const size_t alphabet_size = effective_alphabet_size(C);
@@ -567,6 +573,19 @@ public:
             else
                 huff::huffman_encode(v, *m_out, m_table.ordered_codelengths, ordered_map_to_effective, m_table.alphabet_size, m_table.codewords);
         }
+
+        template<typename value_t>
+        inline void encode_batch(const value_t* values, size_t n, const LiteralRange&) {
+            DCHECK_NE(m_table.alphabet_size,0);
+            if(tdc_unlikely(m_table.alphabet_size == 1)) {
+                m_out->write_ints(values, n, 8*sizeof(uliteral_t));
+                return;
+            }
+            BitOStream& out = *m_out;
+            for(size_t i = 0; i < n; ++i) {
+                huff::huffman_encode(values[i], out, m_table.ordered_codelengths, ordered_map_to_effective, m_table.alphabet_size, m_table.codewords);
+            }
+        }
     };
 
     class Decoder : public tdc::Decoder {
@@ -609,6 +628,18 @@ public:
                 return m_in->read_int<uliteral_t>();
             return huff::huffman_decode(*m_in, ordered_map_from_effective, prefix_sum_lengths.get(), firstcodes);
         }
+
+        template<typename value_t>
+        inline void decode_batch(value_t* values, size_t n, const LiteralRange&) {
+            BitIStream& in = *m_in;
+            if(tdc_unlikely(ordered_map_from_effective == nullptr)) {
+                for(size_t i = 0; i < n; ++i) values[i] = in.read_int<uliteral_t>();
+                return;
+            }
+            for(size_t i = 0; i < n; ++i) {
+                values[i] = huff::huffman_decode(in, ordered_map_from_effective, prefix_sum_lengths.get(), firstcodes);
+            }
+        }
     };
 };
 
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <tudocomp/Coder.hpp>
+
+namespace tdc {
+
+/// \cond INTERNAL
+namespace rans {
+
+    /// The amount of interleaved coder states.
+    constexpr size_t lanes = 8;
+
+    /// The frequencies of a model sum up to 2^prob_bits.
+    constexpr size_t prob_bits = 12;
+    constexpr uint32_t prob_scale = uint32_t(1) << prob_bits;
+
+    /// The lower bound of a normalized coder state.
+    constexpr uint32_t state_low = uint32_t(1) << 23;
+
+    /**
+     * A static model of the literal frequencies of a block.
+     *
+     * The frequencies are normalized such that they sum up to
+     * \ref prob_scale and every literal occurring in the block keeps a
+     * frequency of at least one.
+     */
+    class Model {
+        static constexpr size_t sigma = size_t(ULITERAL_MAX)+1;
+
+    public:
+        uint32_t freq[sigma];
+        uint32_t start[sigma];
+
+        /// Computes the model of the given literals.
+        inline Model(const uliteral_t* literals, size_t n) {
+            DCHECK_GT(n, 0u);
+
+            size_t counts[sigma] = {};
+            for(size_t i = 0; i < n; ++i) ++counts[literals[i]];
+
+            uint32_t sum = 0;
+            for(size_t c = 0; c < sigma; ++c) {
+                freq[c] = counts[c]
+                    ? std::max(uint32_t(1), uint32_t(uint64_t(counts[c]) * prob_scale / n))
+                    : 0;
+                sum += freq[c];
+            }
+
+            // fix rounding errors at the expense of the most frequent
+            // literals, which are least affected relatively
+            while(sum != prob_scale) {
+                const size_t max = std::max_element(freq, freq + sigma) - freq;
+                if(sum < prob_scale) {
+                    freq[max] += prob_scale - sum;
+                    sum = prob_scale;
+                } else {
+                    // freq[max] > 1, since the frequencies sum up to more
+                    // than prob_scale with at most sigma < prob_scale literals
+                    const uint32_t d = std::min(sum - prob_scale, freq[max] / 2);
+                    freq[max] -= d;
+                    sum -= d;
+                }
+            }
+            init_start();
+        }
+
+        /// Reads a model written by \ref encode.
+        inline Model(BitIStream& in) {
+            std::fill(freq, freq + sigma, 0);
+            const size_t num = size_t(in.read_int<uliteral_t>()) + 1;
+            for(size_t i = 0; i < num; ++i) {
+                const uliteral_t c = in.read_int<uliteral_t>();
+                freq[c] = in.read_int<uint32_t>(prob_bits) + 1;
+            }
+            init_start();
+        }
+
+        inline void init_start() {
+            uint32_t s = 0;
+            for(size_t c = 0; c < sigma; ++c) {
+                start[c] = s;
+                s += freq[c];
+            }
+            DCHECK_EQ(s, prob_scale);
+        }
+
+        /// Writes the model.
+        inline void encode(BitOStream& out) const {
+            const size_t num = sigma - std::count(freq, freq + sigma, 0);
+            out.write_int(uliteral_t(num - 1));
+            for(size_t c = 0; c < sigma; ++c) {
+                if(freq[c]) {
+                    out.write_int(uliteral_t(c));
+                    out.write_int(freq[c] - 1, prob_bits);
+                }
+            }
+        }
+    };
+
+    /**
+     * Encodes the given literals with \ref lanes interleaved rANS states,
+     * the i-th literal with the state i mod \ref lanes.
+     *
+     * The states are renormalized bytewise. Since rANS works like a stack,
+     * the literals are encoded in reverse order into the back of the buffer.
+     *
+     * \return the encoded bytes.
+     */
+    inline std::vector<uint8_t> encode(
+        const Model& model, const uliteral_t* literals, size_t n) {
+
+        // renormalization emits at most two bytes per literal,
+        // plus the final states
+        std::vector<uint8_t> buffer(n * 2 + lanes * sizeof(uint32_t));
+        uint8_t* const end = buffer.data() + buffer.size();
+        uint8_t* p = end;
+
+        uint32_t x[lanes];
+        std::fill(x, x + lanes, state_low);
+
+        for(size_t i = n; i-- > 0;) {
+            uint32_t& s = x[i % lanes];
+            const uint32_t freq = model.freq[literals[i]];
+            DCHECK_GT(freq, 0u);
+
+            const uint32_t max = ((state_low >> prob_bits) << 8) * freq;
+            while(s >= max) {
+                *--p = uint8_t(s);
+                s >>= 8;
+            }
+            s = ((s / freq) << prob_bits) + (s % freq) + model.start[literals[i]];
+        }
+
+        // the decoder reads the states of the lanes in order
+        for(size_t j = lanes; j-- > 0;) {
+            p -= sizeof(uint32_t);
+            p[0] = uint8_t(x[j]);
+            p[1] = uint8_t(x[j] >> 8);
+            p[2] = uint8_t(x[j] >> 16);
+            p[3] = uint8_t(x[j] >> 24);
+        }
+        DCHECK_GE(p, buffer.data());
+
+        return std::vector<uint8_t>(p, end);
+    }
+
+    /**
+     * Decodes \c n literals encoded by \ref encode.
+     *
+     * The interleaved states are independent, so the decoding of
+     * consecutive literals can be pipelined.
+     */
+    inline void decode(
+        const Model& model, const uint8_t* p, uliteral_t* literals, size_t n) {
+
+        constexpr uint32_t mask = prob_scale - 1;
+
+        // maps each slot of the probability scale to its literal
+        uliteral_t slots[prob_scale];
+        for(size_t c = 0; c < size_t(ULITERAL_MAX)+1; ++c) {
+            std::fill(slots + model.start[c],
+                      slots + model.start[c] + model.freq[c], uliteral_t(c));
+        }
+
+        uint32_t x[lanes];
+        for(size_t j = 0; j < lanes; ++j) {
+            x[j] = uint32_t(p[0]) | (uint32_t(p[1]) << 8)
+                | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+            p += sizeof(uint32_t);
+        }
+
+        auto step = [&](uint32_t& s, uliteral_t& out) {
+            const uliteral_t c = slots[s & mask];
+            s = model.freq[c] * (s >> prob_bits) + (s & mask) - model.start[c];
+            while(s < state_low) s = (s << 8) | *p++;
+            out = c;
+        };
+
+        size_t i = 0;
+        for(; i + lanes <= n; i += lanes) {
+            for(size_t j = 0; j < lanes; ++j) step(x[j], literals[i + j]);
+        }
+        for(size_t j = 0; i < n; ++i, ++j) step(x[j], literals[i]);
+    }
+
+}//ns
+/// \endcond
+
+/// \brief Encodes literals using rANS with interleaved states.
+///
+/// The literals are grouped in blocks of up to `block` literals. Each
+/// block is encoded with a static model of its own literal frequencies by
+/// \ref rans::lanes interleaved rANS states, so consecutive literals can be
+/// decoded independently of each other. The decoder decodes a whole block
+/// at once when its first literal is requested.
+///
+/// Since rANS encodes backwards, the encoder holds back all values encoded
+/// from the first literal of a block on, until the block is complete. The
+/// block is then written in front of these values. Hence, the values encoded
+/// by this coder keep their order, but the coder must not share its output
+/// with other encoders.
+class RANSCoder : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("coder", "rans", "Blockwise static rANS Coder with interleaved states");
+        m.option("block").dynamic(1 << 16); // literals per block
+        return m;
+    }
+
+    RANSCoder() = delete;
+
+    class Encoder : public tdc::Encoder {
+        const size_t m_block;
+
+        // the actual output, m_out is redirected to the held back values
+        // while a block is open
+        std::shared_ptr<BitOStream> m_target;
+
+        std::vector<uint8_t> m_held;
+        Output m_held_output;
+        std::shared_ptr<BitOStream> m_held_stream;
+
+        std::vector<uliteral_t> m_literals;
+
+        inline void flush_block() {
+            DCHECK(!m_literals.empty());
+
+            const rans::Model model(m_literals.data(), m_literals.size());
+            const auto code = rans::encode(model, m_literals.data(), m_literals.size());
+
+            m_target->write_compressed_int(m_literals.size());
+            model.encode(*m_target);
+            m_target->write_compressed_int(code.size());
+            m_target->write_bytes(code.data(), code.size());
+
+            // append the held back values
+            m_target->write_bytes(m_held.data(), m_held.size());
+            const size_t pending = m_held_stream->pending_bits();
+            m_target->write_int(m_held_stream->take_pending_bits(), pending);
+
+            m_held.clear();
+            m_literals.clear();
+            m_out = m_target;
+        }
+
+    public:
+        template<typename literals_t>
+        inline Encoder(Env&& env, std::shared_ptr<BitOStream> out, literals_t&& literals)
+            : tdc::Encoder(std::move(env), out, literals)
+            , m_block(this->env().option("block").as_integer())
+            , m_target(out)
+            , m_held_output(m_held)
+            , m_held_stream(std::make_shared<BitOStream>(m_held_output)) {
+
+            CHECK_GT(m_block, 0u) << "the block size must be positive";
+        }
+
+        template<typename literals_t>
+        inline Encoder(Env&& env, Output& out, literals_t&& literals)
+            : Encoder(std::move(env), std::make_shared<BitOStream>(out), literals) {
+        }
+
+        ~Encoder() {
+            if(!m_literals.empty()) flush_block();
+        }
+
+        using tdc::Encoder::encode; // default encoding as fallback
+
+        template<typename value_t>
+        inline void encode(value_t v, const LiteralRange&) {
+            if(m_literals.size() == m_block) flush_block();
+
+            // a block starts with its first literal
+            if(m_literals.empty()) m_out = m_held_stream;
+            m_literals.push_back(static_cast<uliteral_t>(v));
+        }
+
+        template<typename value_t>
+        inline void encode_batch(const value_t* values, size_t n, const LiteralRange&) {
+            while(n > 0) {
+                if(m_literals.size() == m_block) flush_block();
+                if(m_literals.empty()) m_out = m_held_stream;
+
+                const size_t k = std::min(n, m_block - m_literals.size());
+                for(size_t i = 0; i < k; ++i) {
+                    m_literals.push_back(static_cast<uliteral_t>(values[i]));
+                }
+                values += k;
+                n -= k;
+            }
+        }
+    };
+
+    class Decoder : public tdc::Decoder {
+        std::vector<uliteral_t> m_literals;
+        size_t m_next = 0;
+
+        inline void read_block() {
+            const size_t n = m_in->read_compressed_int<size_t>();
+            const rans::Model model(*m_in);
+            std::vector<uint8_t> code(m_in->read_compressed_int<size_t>());
+            m_in->read_bytes(code.data(), code.size());
+
+            m_literals.resize(n);
+            rans::decode(model, code.data(), m_literals.data(), n);
+            m_next = 0;
+        }
+
+    public:
+        DECODER_CTOR(env, in) {
+        }
+
+        /// Tests whether the input is exhausted, including the literals of
+        /// the current block.
+        inline bool eof() const {
+            return m_next == m_literals.size() && tdc::Decoder::eof();
+        }
+
+        using tdc::Decoder::decode; // default decoding as fallback
+
+        template<typename value_t>
+        inline value_t decode(const LiteralRange&) {
+            if(m_next == m_literals.size()) read_block();
+            return value_t(m_literals[m_next++]);
+        }
+
+        template<typename value_t>
+        inline void decode_batch(value_t* values, size_t n, const LiteralRange&) {
+            while(n > 0) {
+                if(m_next == m_literals.size()) read_block();
+
+                const size_t k = std::min(n, m_literals.size() - m_next);
+                std::copy(m_literals.begin() + m_next,
+                          m_literals.begin() + m_next + k, values);
+                m_next += k;
+                values += k;
+                n -= k;
+            }
+        }
+    };
+};
+
+}//ns
+
@@ -52,10 +52,7 @@ inline void decode_text_internal(Env&& env, coder_t& decoder, std::ostream& outs
             else  num = 0;
 
             // decode characters
-            while(num--) {
-                auto c = decoder.template decode<uliteral_t>(literal_r);
-                buffer.decode_literal(c);
-            }
+            lzss::decode_literals(decoder, buffer, num);
 
             if(!decoder.eof()) {
                 //decode factor
@@ -7,6 +7,7 @@
 #include <tudocomp/Compressor.hpp>
 #include <tudocomp/Range.hpp>
 #include <tudocomp/util.hpp>
+#include <tudocomp/util/Parallel.hpp>
 
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
 #include <tudocomp/compressors/lzss/LZSSLiterals.hpp>
@@ -18,8 +19,14 @@
 
 namespace tdc {
 
-/// Computes the LZ77 factorization of the input using its suffix array and
-/// LCP table.
+/// Computes the LZ77 factorization of the input using its suffix array.
+///
+/// By default, the factors are computed in linear time from the suffix
+/// array alone (mode "kkp"). Mode "parallel" computes the longest previous
+/// factor of every text position with multiple threads (see the `threads`
+/// option). Mode "scan" uses the suffix array, its inverse and the LCP table
+/// instead, but takes quadratic time in the worst case. All modes yield the
+/// same factors.
 template<typename coder_t, typename text_t = TextDS<>>
 class LZSSLCPCompressor : public Compressor {
 public:
@@ -28,15 +35,316 @@ public:
         m.option("coder").templated<coder_t>("coder");
         m.option("textds").templated<text_t, TextDS<>>("textds");
         m.option("threshold").dynamic(3);
+        m.option("mode").dynamic("kkp"); // "kkp", "parallel" or "scan"
+        m.option("threads").dynamic(0); // mode "parallel", 0 = OpenMP default
         m.uses_textds<text_t>(text_t::SA | text_t::ISA | text_t::LCP);
         return m;
     }
 
+private:
+    /// The factorization modes.
+    enum class Mode { kkp, parallel, scan };
+
+    Mode m_mode;
+    len_t m_threshold; //! factor threshold
+    size_t m_threads; //! mode "parallel", 0 = OpenMP default
+
+    /// Computes the factorization by scanning the LCP array upwards and
+    /// downwards for the previous and next smaller suffix array values.
+    ///
+    /// This needs the suffix array, its inverse and the LCP array and takes
+    /// quadratic time in the worst case (e.g., on highly repetitive texts).
+    inline static void factorize_scan(
+        text_t& text, len_t threshold, lzss::FactorBuffer& factors) {
+
+        auto& sa = text.require_sa();
+        auto& isa = text.require_isa();
+        auto& lcp = text.require_lcp();
+
+        const len_t text_length = text.size();
+        for(len_t i = 0; i+1 < text_length;) { // we omit T[text_length-1] since we assume that it is the \0 byte!
+            //get SA position for suffix i
+            const size_t& cur_pos = isa[i];
+            DCHECK_NE(cur_pos,0); // isa[i] == 0 <=> T[i] = 0
+
+            //compute naively PSV
+            //search "upwards" in LCP array
+            //include current, exclude last
+            size_t psv_lcp = lcp[cur_pos];
+            ssize_t psv_pos = cur_pos - 1;
+            if (psv_lcp > 0) {
+                while (psv_pos >= 0 && sa[psv_pos] > sa[cur_pos]) {
+                    psv_lcp = std::min<size_t>(psv_lcp, lcp[psv_pos--]);
+                }
+            }
+
+            //compute naively NSV
+            //search "downwards" in LCP array
+            //exclude current, include last
+            size_t nsv_lcp = 0;
+            size_t nsv_pos = cur_pos + 1;
+            if (nsv_pos < text_length) {
+                nsv_lcp = SSIZE_MAX;
+                do {
+                    nsv_lcp = std::min<size_t>(nsv_lcp, lcp[nsv_pos]);
+                    if (sa[nsv_pos] < sa[cur_pos]) {
+                        break;
+                    }
+                } while (++nsv_pos < text_length);
+
+                if (nsv_pos >= text_length) {
+                    nsv_lcp = 0;
+                }
+            }
+
+            //select maximum
+            const size_t& max_lcp = std::max(psv_lcp, nsv_lcp);
+            if(max_lcp >= threshold) {
+                const ssize_t& max_pos = max_lcp == psv_lcp ? psv_pos : nsv_pos;
+                DCHECK_LT(max_pos, text_length);
+                DCHECK_GE(max_pos, 0);
+                // new factor
+                factors.emplace_back(i, sa[max_pos], max_lcp);
+
+                i += max_lcp; //advance
+            } else {
+                ++i; //advance
+            }
+        }
+    }
+
+    /// Minimum amount of text positions per thread in mode "parallel".
+    static constexpr size_t MIN_PER_THREAD = 1ULL << 16;
+
+    /// Computes, for every text position i, the text positions of the
+    /// previous and next smaller suffix array values of i's suffix (PSV and
+    /// NSV), or the text length if there is none.
+    ///
+    /// This takes a single pass over the suffix array, which is released
+    /// afterwards. The stack of the pass is stored within the PSV array.
+    ///
+    /// With multiple threads, the suffix array is split into one contiguous
+    /// range per thread and each thread runs the pass on its range. The
+    /// values lacking a PSV within their range are the range's prefix minima.
+    /// These are then resolved sequentially against the stacks left by the
+    /// preceding ranges.
+    inline static void compute_psv_nsv(
+        text_t& text, std::vector<len_t>& psv, std::vector<len_t>& nsv,
+        size_t threads = 1) {
+
+        const len_t n = text.size();
+        const len_t none = n;
+
+        psv.assign(n, none);
+        nsv.assign(n, none);
+
+        auto sa = text.release_sa();
+        threads = threads_for(n, MIN_PER_THREAD, threads);
+
+        // the prefix minima and the stack top at the end of every range
+        std::vector<std::vector<len_t>> minima(threads);
+        std::vector<len_t> tops(threads, none);
+
+        #pragma omp parallel num_threads(threads)
+        {
+            const size_t team = num_threads();
+            const size_t t = thread_num();
+            const len_t b = range_begin(n, t, team, ArrayDS::ARRAY_CHUNK);
+            const len_t e = range_begin(n, t + 1, team, ArrayDS::ARRAY_CHUNK);
+
+            // read the suffix array in chunks
+            uint64_t buf[ArrayDS::ARRAY_CHUNK];
+            len_t top = none;
+            for(len_t begin = b; begin < e; begin += ArrayDS::ARRAY_CHUNK) {
+                const len_t len = std::min<len_t>(ArrayDS::ARRAY_CHUNK, e - begin);
+                sa.unpack(begin, len, buf);
+                for(len_t j = 0; j < len; ++j) {
+                    const len_t x = buf[j];
+                    while(top != none && top > x) {
+                        nsv[top] = x;
+                        top = psv[top];
+                    }
+                    if(top == none) minima[t].push_back(x);
+                    psv[x] = top;
+                    top = x;
+                }
+            }
+            tops[t] = top;
+        }
+
+        // the bottom of a range's stack is its last prefix minimum,
+        // so its stack continues the stack of the preceding ranges
+        len_t top = none;
+        for(size_t t = 0; t < threads; ++t) {
+            for(const len_t x : minima[t]) {
+                while(top != none && top > x) {
+                    nsv[top] = x;
+                    top = psv[top];
+                }
+                psv[x] = top;
+            }
+            if(tops[t] != none) top = tops[t];
+        }
+    }
+
+    /// Computes the factorization in linear time using only the suffix
+    /// array, in the style of KKP (Kärkkäinen, Kempa and Puglisi, 2013).
+    ///
+    /// The length of a factor starting at i is the longer common prefix of
+    /// i's suffix with the suffixes at its PSV and NSV, computed by
+    /// comparing characters. Since the comparisons are bounded by the
+    /// factor length, this takes linear time overall.
+    ///
+    /// The factors are identical to those of \ref factorize_scan.
+    inline static void factorize_kkp(
+        text_t& text, len_t threshold, lzss::FactorBuffer& factors) {
+
+        const len_t n = text.size();
+        const len_t none = n;
+
+        std::vector<len_t> psv, nsv;
+        StatPhase::wrap("PSV/NSV", [&]{
+            compute_psv_nsv(text, psv, nsv);
+        });
+
+        auto lce = [&](len_t i, len_t p) -> len_t {
+            if(p == none) return 0;
+            len_t l = 0;
+            // the text ends with a unique 0 byte, so the comparison stops
+            // before the end of the text
+            while(text[i + l] == text[p + l]) ++l;
+            return l;
+        };
+
+        for(len_t i = 0; i+1 < n;) { // we omit T[n-1] since we assume that it is the \0 byte!
+            const len_t psv_pos = psv[i];
+            const len_t nsv_pos = nsv[i];
+            const len_t psv_lcp = lce(i, psv_pos);
+            const len_t nsv_lcp = lce(i, nsv_pos);
+
+            const len_t max_lcp = std::max(psv_lcp, nsv_lcp);
+            if(max_lcp >= threshold) {
+                // new factor
+                factors.emplace_back(i,
+                    (max_lcp == psv_lcp) ? psv_pos : nsv_pos, max_lcp);
+
+                i += max_lcp; //advance
+            } else {
+                ++i; //advance
+            }
+        }
+    }
+
+    /// Computes the factorization using multiple threads.
+    ///
+    /// PSV and NSV are computed in parallel (see \ref compute_psv_nsv).
+    /// Unlike \ref factorize_kkp, the longest previous factor (LPF) is then
+    /// computed for every text position, which allows to split the text
+    /// into one contiguous range per thread. Within a range, the common
+    /// prefix lengths with the PSV and NSV suffixes are computed like the
+    /// PLCP array (Kasai et al.): if the suffix at i-1 shares l > 0
+    /// characters with the suffix at its PSV p, then the suffix at p+1 is
+    /// smaller than the suffix at i and shares l-1 characters with it, hence
+    /// so does the suffix at the PSV of i (the same holds for the NSV). The
+    /// total work is thus linear plus one longest common prefix per thread.
+    ///
+    /// The greedy parse is then obtained by a sequential pass that jumps
+    /// from factor to factor. The PSV and NSV arrays are overwritten by the
+    /// LPF sources and lengths, so no additional memory is needed.
+    ///
+    /// The factors are identical to those of \ref factorize_kkp.
+    inline static void factorize_parallel(
+        text_t& text, len_t threshold, size_t threads,
+        lzss::FactorBuffer& factors) {
+
+        const len_t n = text.size();
+        const len_t none = n;
+
+        std::vector<len_t> psv, nsv;
+        StatPhase::wrap("PSV/NSV", [&]{
+            compute_psv_nsv(text, psv, nsv, threads);
+        });
+
+        // we omit T[n-1] since we assume that it is the \0 byte!
+        const len_t m = (n > 0) ? n - 1 : 0;
+        threads = threads_for(m, MIN_PER_THREAD, threads);
+
+        StatPhase::wrap("LPF", [&]{
+            #pragma omp parallel num_threads(threads)
+            {
+                const size_t team = num_threads();
+                const len_t b = range_begin(m, thread_num(), team);
+                const len_t e = range_begin(m, thread_num() + 1, team);
+
+                len_t psv_lcp = 0, nsv_lcp = 0;
+                for(len_t i = b; i < e; ++i) {
+                    const len_t psv_pos = psv[i];
+                    const len_t nsv_pos = nsv[i];
+
+                    // the text ends with a unique 0 byte, so the comparisons
+                    // stop before the end of the text
+                    if(psv_pos == none) {
+                        psv_lcp = 0;
+                    } else {
+                        while(text[i + psv_lcp] == text[psv_pos + psv_lcp]) ++psv_lcp;
+                    }
+                    if(nsv_pos == none) {
+                        nsv_lcp = 0;
+                    } else {
+                        while(text[i + nsv_lcp] == text[nsv_pos + nsv_lcp]) ++nsv_lcp;
+                    }
+
+                    // replace PSV and NSV by the LPF source and length
+                    if(psv_lcp >= nsv_lcp) {
+                        nsv[i] = psv_lcp;
+                    } else {
+                        psv[i] = nsv_pos;
+                        nsv[i] = nsv_lcp;
+                    }
+
+                    if(psv_lcp) --psv_lcp;
+                    if(nsv_lcp) --nsv_lcp;
+                }
+            }
+            StatPhase::log("threads", threads);
+        });
+
+        const auto& source = psv;
+        const auto& lpf = nsv;
+        for(len_t i = 0; i < m;) {
+            if(lpf[i] >= threshold) {
+                // new factor
+                factors.emplace_back(i, source[i], lpf[i]);
+
+                i += lpf[i]; //advance
+            } else {
+                ++i; //advance
+            }
+        }
+    }
+
+public:
     /// Default constructor (not supported).
     inline LZSSLCPCompressor() = delete;
 
     /// Construct the class with an environment.
+    ///
+    /// The options are resolved here once, so that repeated calls of
+    /// \ref compress do not look them up again.
     inline LZSSLCPCompressor(Env&& env) : Compressor(std::move(env)) {
+        const std::string mode = this->env().option("mode").as_string();
+        if(mode == "kkp") {
+            m_mode = Mode::kkp;
+        } else if(mode == "parallel") {
+            m_mode = Mode::parallel;
+        } else if(mode == "scan") {
+            m_mode = Mode::scan;
+        } else {
+            CHECK(false) << "unknown factorization mode: " << mode;
+        }
+
+        m_threshold = this->env().option("threshold").as_integer();
+        m_threads = this->env().option("threads").as_integer();
     }
 
     inline virtual void compress(Input& input, Output& output) override {
@@ -44,73 +352,26 @@ public:
         DCHECK(view.ends_with(uint8_t(0)));
 
         // Construct text data structures
+        typename text_t::dsflags_t flags = text_t::SA;
+        if(m_mode == Mode::scan) flags |= text_t::ISA | text_t::LCP;
+
         text_t text = StatPhase::wrap("Construct Text DS", [&]{
-            return text_t(env().env_for_option("textds"), view,
-                    text_t::SA | text_t::ISA | text_t::LCP);
+            return text_t(env().env_for_option("textds"), view, flags);
         });
 
-        auto& sa = text.require_sa();
-        auto& isa = text.require_isa();
-        auto& lcp = text.require_lcp();
-
         // Factorize
-        const len_t text_length = text.size();
         lzss::FactorBuffer factors;
 
         StatPhase::wrap("Factorize", [&]{
-            const len_t threshold = env().option("threshold").as_integer(); //factor threshold
-
-            for(len_t i = 0; i+1 < text_length;) { // we omit T[text_length-1] since we assume that it is the \0 byte!
-                //get SA position for suffix i
-                const size_t& cur_pos = isa[i];
-			    DCHECK_NE(cur_pos,0); // isa[i] == 0 <=> T[i] = 0
-
-			    //compute naively PSV
-                //search "upwards" in LCP array
-                //include current, exclude last
-                size_t psv_lcp = lcp[cur_pos];
-                ssize_t psv_pos = cur_pos - 1;
-                if (psv_lcp > 0) {
-                    while (psv_pos >= 0 && sa[psv_pos] > sa[cur_pos]) {
-                        psv_lcp = std::min<size_t>(psv_lcp, lcp[psv_pos--]);
-                    }
-                }
-
-			    //compute naively NSV, TODO: use NSV data structure
-                //search "downwards" in LCP array
-                //exclude current, include last
-                size_t nsv_lcp = 0;
-                size_t nsv_pos = cur_pos + 1;
-                if (nsv_pos < text_length) {
-                    nsv_lcp = SSIZE_MAX;
-                    do {
-                        nsv_lcp = std::min<size_t>(nsv_lcp, lcp[nsv_pos]);
-                        if (sa[nsv_pos] < sa[cur_pos]) {
-                            break;
-                        }
-                    } while (++nsv_pos < text_length);
-
-                    if (nsv_pos >= text_length) {
-                        nsv_lcp = 0;
-                    }
-                }
-
-                //select maximum
-                const size_t& max_lcp = std::max(psv_lcp, nsv_lcp);
-                if(max_lcp >= threshold) {
-				    const ssize_t& max_pos = max_lcp == psv_lcp ? psv_pos : nsv_pos;
-				    DCHECK_LT(max_pos, text_length);
-				    DCHECK_GE(max_pos, 0);
-                    // new factor
-                    factors.emplace_back(i, sa[max_pos], max_lcp);
-
-                    i += max_lcp; //advance
-                } else {
-                    ++i; //advance
-                }
+            if(m_mode == Mode::kkp) {
+                factorize_kkp(text, m_threshold, factors);
+            } else if(m_mode == Mode::parallel) {
+                factorize_parallel(text, m_threshold, m_threads, factors);
+            } else {
+                factorize_scan(text, m_threshold, factors);
             }
 
-            StatPhase::log("threshold", threshold);
+            StatPhase::log("threshold", m_threshold);
             StatPhase::log("factors", factors.size());
         });
 
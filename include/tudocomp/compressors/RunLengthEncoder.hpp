@@ -1,5 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <tudocomp/util.hpp>
 #include <tudocomp/util/vbyte.hpp>
 #include <tudocomp/Env.hpp>
@@ -7,45 +15,272 @@
 
 namespace tdc {
 
+/// \cond INTERNAL
+namespace rle {
+
+    /// Returns the smallest `i` in `[from, n)` with `s[i] == s[i-1]`,
+    /// or `n` if there is none. Requires `from >= 1`.
+    inline size_t find_pair_scalar(const uint8_t* s, size_t from, size_t n) {
+        for(size_t i = from; i < n; ++i) {
+            if(s[i] == s[i-1]) return i;
+        }
+        return n;
+    }
+
+    /// Returns the smallest `i` in `[from, n)` with `s[i] != c`,
+    /// or `n` if there is none.
+    inline size_t find_mismatch_scalar(const uint8_t* s, size_t from, size_t n, uint8_t c) {
+        for(size_t i = from; i < n; ++i) {
+            if(s[i] != c) return i;
+        }
+        return n;
+    }
+
+#ifdef __SSE2__
+    /// SSE2 variant of \ref find_pair_scalar comparing 16 pairs at once.
+    inline size_t find_pair_sse2(const uint8_t* s, size_t from, size_t n) {
+        size_t i = from;
+        for(; i + 16 <= n; i += 16) {
+            const __m128i x = _mm_loadu_si128((const __m128i*)(s + i));
+            const __m128i y = _mm_loadu_si128((const __m128i*)(s + i - 1));
+            const int eq = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+            if(eq) return i + __builtin_ctz(eq);
+        }
+        return find_pair_scalar(s, i, n);
+    }
+
+    /// SSE2 variant of \ref find_mismatch_scalar comparing 16 characters
+    /// at once.
+    inline size_t find_mismatch_sse2(const uint8_t* s, size_t from, size_t n, uint8_t c) {
+        const __m128i cc = _mm_set1_epi8(char(c));
+        size_t i = from;
+        for(; i + 16 <= n; i += 16) {
+            const __m128i x = _mm_loadu_si128((const __m128i*)(s + i));
+            const int ne = ~_mm_movemask_epi8(_mm_cmpeq_epi8(x, cc)) & 0xFFFF;
+            if(ne) return i + __builtin_ctz(ne);
+        }
+        return find_mismatch_scalar(s, i, n, c);
+    }
+#endif
+
+    inline size_t find_pair(const uint8_t* s, size_t from, size_t n) {
+#ifdef __SSE2__
+        return find_pair_sse2(s, from, n);
+#else
+        return find_pair_scalar(s, from, n);
+#endif
+    }
+
+    inline size_t find_mismatch(const uint8_t* s, size_t from, size_t n, uint8_t c) {
+#ifdef __SSE2__
+        return find_mismatch_sse2(s, from, n, c);
+#else
+        return find_mismatch_scalar(s, from, n, c);
+#endif
+    }
+
+    /// Collects small pieces of output and writes them in blocks.
+    class OutputBuffer {
+        static constexpr size_t capacity = 1ULL << 16;
+
+        std::ostream& m_out;
+        std::vector<uint8_t> m_buffer;
+        size_t m_size = 0;
+
+    public:
+        inline OutputBuffer(std::ostream& out) : m_out(out), m_buffer(capacity) {
+        }
+
+        inline ~OutputBuffer() {
+            flush();
+        }
+
+        inline void flush() {
+            m_out.write((const char*) m_buffer.data(), m_size);
+            m_size = 0;
+        }
+
+        inline void write(const uint8_t* data, size_t n) {
+            if(m_size + n > capacity) {
+                flush();
+                if(n > capacity / 2) {
+                    m_out.write((const char*) data, n);
+                    return;
+                }
+            }
+            std::memcpy(m_buffer.data() + m_size, data, n);
+            m_size += n;
+        }
+
+        inline void fill(uint8_t c, size_t n) {
+            while(n > 0) {
+                if(m_size == capacity) flush();
+                const size_t k = std::min(n, capacity - m_size);
+                std::memset(m_buffer.data() + m_size, c, k);
+                m_size += k;
+                n -= k;
+            }
+        }
+
+        template<class int_t>
+        inline void write_vbyte(int_t v) {
+            if(m_size + VBYTE_MAX_BYTES > capacity) flush();
+            m_size = tdc::write_vbyte(m_buffer.data() + m_size, v) - m_buffer.data();
+        }
+    };
+
+    /// The size of the blocks that streams are read in.
+    constexpr size_t STREAM_CHUNK = 1ULL << 16;
+
+    /// Encodes a buffer, see \ref rle_encode.
+    inline void encode(const uint8_t* in, size_t n, OutputBuffer& out, size_t offset) {
+        size_t literals = 0; // start of the characters not yet written
+        size_t i = 1;
+        while(i < n) {
+            // find the next two equal characters, which start a run
+            const size_t j = find_pair(in, i, n);
+            if(j == n) break;
+
+            out.write(in + literals, j + 1 - literals);
+
+            const size_t end = find_mismatch(in, j + 1, n, in[j]);
+            out.write_vbyte(end - j - 1 + offset);
+
+            literals = end;
+            i = end + 1;
+        }
+        if(literals < n) out.write(in + literals, n - literals);
+    }
+
+    /// Encodes a single run of `n` characters `c`.
+    inline void encode_run(uint8_t c, size_t n, OutputBuffer& out, size_t offset) {
+        const uint8_t pair[] = { c, c };
+        out.write(pair, std::min(n, size_t(2)));
+        if(n >= 2) out.write_vbyte(n - 2 + offset);
+    }
+
+    /// Decodes a buffer, see \ref rle_decode.
+    ///
+    /// Unless `last` is set, more input follows, so the decoding stops in
+    /// front of a character that may start a pair with the next input and
+    /// in front of a pair whose run length is incomplete.
+    ///
+    /// \return The amount of bytes decoded.
+    inline size_t decode(const uint8_t* in, size_t n, OutputBuffer& out, size_t offset, bool last) {
+        const uint8_t* const end = in + n;
+
+        size_t literals = 0; // start of the characters not yet written
+        size_t i = 1;
+        while(i < n) {
+            // two equal characters are followed by the length of the run
+            const size_t j = find_pair(in, i, n);
+            if(j == n) break;
+
+            const uint8_t* p = in + j + 1;
+            if(!last && std::find_if(p, end, [](uint8_t b) { return !(b & 0x80); }) == end) {
+                // in[j-1] starts the pair, as in[j-2] is not equal to it
+                out.write(in + literals, j - 1 - literals);
+                return j - 1;
+            }
+
+            out.write(in + literals, j + 1 - literals);
+
+            const size_t run = read_vbyte<size_t>(p, end) - offset;
+            out.fill(in[j], run);
+
+            literals = p - in;
+            i = literals + 1;
+        }
+
+        const size_t stop = (!last && literals < n) ? n - 1 : n;
+        if(literals < stop) out.write(in + literals, stop - literals);
+        return std::max(literals, stop);
+    }
+
+}//ns
+/// \endcond
+
 /**
  * Encode a byte-stream with run length encoding
  * each run of the same character is substituted with two occurrences of the same character and the length of the run minus two,
  * encoded in vbyte coding.
+ *
+ * Runs are found by comparing blocks of characters at once and the output
+ * is written in blocks.
+ */
+inline void rle_encode(const uint8_t* in, size_t n, std::ostream& os, size_t offset = 0) {
+	rle::OutputBuffer out(os);
+	rle::encode(in, n, out, offset);
+}
+
+/**
+ * Decodes a run length encoded buffer
+ */
+inline void rle_decode(const uint8_t* in, size_t n, std::ostream& os, size_t offset = 0) {
+	rle::OutputBuffer out(os);
+	rle::decode(in, n, out, offset, true);
+}
+
+/**
+ * Encode a byte-stream with run length encoding, see above.
+ *
+ * The stream is read in blocks. The run at the end of a block is held back,
+ * as it may continue in the next one.
  */
 template<class char_type>
 void rle_encode(std::basic_istream<char_type>& is, std::basic_ostream<char_type>& os, size_t offset = 0) {
-	char_type prev;
-	if(tdc_unlikely(!is.get(prev))) return;
-	os << prev;
-	char_type c;
-	while(is.get(c)) {
-		if(prev == c) {
-			size_t run = 0;
-			while(is.peek() == c) { ++run; is.get(); }
-			os << c;
-			write_vbyte(os, run+offset);
-		} else {
-			os << c;
+	static_assert(sizeof(char_type) == 1, "only byte streams are supported");
+	rle::OutputBuffer out(os);
+	std::vector<uint8_t> buffer(rle::STREAM_CHUNK);
+
+	uint8_t c = 0;  // the character of the held back run
+	size_t run = 0; // its length
+	while(is.read((char_type*) buffer.data(), buffer.size()), is.gcount() > 0) {
+		const uint8_t* in = buffer.data();
+		const size_t n = is.gcount();
+
+		size_t i = 0;
+		if(run > 0) {
+			i = rle::find_mismatch(in, 0, n, c);
+			run += i;
+			if(i == n) continue;
+			rle::encode_run(c, run, out, offset);
 		}
-		prev = c;
+
+		// in[i] differs from the run before, and so does the last run
+		// from the characters before it
+		size_t k = n - 1;
+		while(k > i && in[k - 1] == in[k]) --k;
+		rle::encode(in + i, k - i, out, offset);
+
+		c = in[k];
+		run = n - k;
 	}
+	if(run > 0) rle::encode_run(c, run, out, offset);
 }
+
 /**
  * Decodes a run length encoded stream
+ *
+ * The stream is read in blocks. The few bytes at the end of a block that
+ * depend on the next one are moved to the front of the buffer.
  */
 template<class char_type>
 void rle_decode(std::basic_istream<char_type>& is, std::basic_ostream<char_type>& os, size_t offset = 0) {
-	char_type prev;
-	if(tdc_unlikely(!is.get(prev))) return;
-	os << prev;
-	char_type c;
-	while(is.get(c)) {
-		if(prev == c) {
-			size_t run = read_vbyte<size_t>(is)-offset;
-			while(run-- > 0) { os << c; }
-		}
-		os << c;
-		prev = c;
+	static_assert(sizeof(char_type) == 1, "only byte streams are supported");
+	rle::OutputBuffer out(os);
+	std::vector<uint8_t> buffer(rle::STREAM_CHUNK);
+
+	size_t n = 0; // the amount of bytes in the buffer
+	bool last = false;
+	while(!last) {
+		is.read((char_type*) buffer.data() + n, buffer.size() - n);
+		n += is.gcount();
+		last = !is;
+
+		const size_t done = rle::decode(buffer.data(), n, out, offset, last);
+		std::memmove(buffer.data(), buffer.data() + done, n - done);
+		n -= done;
 	}
 }
 
@@ -62,17 +297,16 @@ public:
     }
 
     inline virtual void compress(Input& input, Output& output) override {
-		auto is = input.as_stream();
+		auto view = input.as_view();
 		auto os = output.as_stream();
-		rle_encode(is,os,m_offset);
+		rle_encode(view.data(), view.size(), os, m_offset);
 	}
     inline virtual void decompress(Input& input, Output& output) override {
-		auto is = input.as_stream();
+		auto view = input.as_view();
 		auto os = output.as_stream();
-		rle_decode(is,os,m_offset);
+		rle_decode(view.data(), view.size(), os, m_offset);
 	}
 };
 
 
 }//ns
-
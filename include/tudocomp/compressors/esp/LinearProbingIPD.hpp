@@ -0,0 +1,223 @@
+#pragma once
+
+#include <tudocomp/Algorithm.hpp>
+#include <tudocomp/compressors/esp/HashArray.hpp>
+
+namespace tdc {namespace esp {
+    /// IPD backed by a flat open-addressing hash table with linear probing.
+    ///
+    /// A key of `N` symbols is bit-packed into a single 64 bit word
+    /// with `64 / N` bits per symbol, so that a lookup touches exactly one
+    /// slot array and never dispatches through virtual calls.
+    /// Keys that do not fit the packed representation are rare in practice
+    /// (they require more than 2^32 distinct symbols per round) and
+    /// are kept in a node-based overflow map.
+    ///
+    /// Growing the table does not rehash all entries at once. Instead,
+    /// a bounded number of slots of the old table are migrated
+    /// on each access, so a round does not stall on a resize.
+    class LinearProbingIPD: public Algorithm {
+    public:
+        inline static Meta meta() {
+            Meta m("ipd", "linear_probing");
+            return m;
+        };
+
+        using Algorithm::Algorithm;
+
+        template<size_t N, typename K, typename V>
+        class IPDMap {
+            static_assert(N >= 2, "only blocks of at least two symbols can be packed");
+
+            static constexpr size_t KEY_BITS = 64 / N;
+            static constexpr uint64_t KEY_MAX = (1ull << KEY_BITS) - 1;
+
+            // Can never be the result of pack(), since either a symbol of
+            // value KEY_MAX is required (N = 2), or the top bits stay unused.
+            static constexpr uint64_t EMPTY = uint64_t(-1);
+
+            static constexpr size_t MIN_BITS = 4;
+            static constexpr size_t MIGRATE_STEP = 16;
+
+            struct Slot {
+                uint64_t key;
+                V val;
+            };
+
+            class Table {
+                std::vector<Slot> m_slots;
+                size_t m_shift = 64;
+                size_t m_mask = 0;
+
+                inline size_t home(uint64_t key) const {
+                    // fibonacci hashing
+                    return (key * 0x9E3779B97F4A7C15ull) >> m_shift;
+                }
+            public:
+                inline Table() = default;
+                inline Table(size_t bits):
+                    m_slots(size_t(1) << bits, Slot { EMPTY, V() }),
+                    m_shift(64 - bits),
+                    m_mask((size_t(1) << bits) - 1) {}
+
+                inline size_t capacity() const {
+                    return m_slots.size();
+                }
+
+                inline size_t bits() const {
+                    return 64 - m_shift;
+                }
+
+                inline Slot* find(uint64_t key) {
+                    for (size_t i = home(key);; i = (i + 1) & m_mask) {
+                        auto& slot = m_slots[i];
+                        if (slot.key == key) return &slot;
+                        if (slot.key == EMPTY) return nullptr;
+                    }
+                }
+
+                /// Inserts a key that is known to not be in the table.
+                inline Slot* insert(uint64_t key, const V& val) {
+                    for (size_t i = home(key);; i = (i + 1) & m_mask) {
+                        auto& slot = m_slots[i];
+                        if (slot.key == EMPTY) {
+                            slot.key = key;
+                            slot.val = val;
+                            return &slot;
+                        }
+                    }
+                }
+
+                inline const Slot& operator[](size_t i) const {
+                    return m_slots[i];
+                }
+            };
+
+            Table m_table;
+            size_t m_table_fill = 0;
+
+            // Old table during an incremental resize.
+            // Slots `< m_migrated` are already contained in `m_table`.
+            Table m_old;
+            size_t m_migrated = 0;
+            bool m_migrating = false;
+
+            std::unordered_map<Array<N, K>, V> m_overflow;
+
+            size_t m_size = 0;
+
+            inline static bool fits(const Array<N, K>& key) {
+                for(size_t i = 0; i < N; i++) {
+                    if (uint64_t(key.m_data[i]) >= KEY_MAX) return false;
+                }
+                return true;
+            }
+
+            inline static uint64_t pack(const Array<N, K>& key) {
+                uint64_t r = 0;
+                for(size_t i = 0; i < N; i++) {
+                    r |= uint64_t(key.m_data[i]) << (i * KEY_BITS);
+                }
+                return r;
+            }
+
+            inline static Array<N, K> unpack(uint64_t packed) {
+                Array<N, K> r;
+                for(size_t i = 0; i < N; i++) {
+                    r.m_data[i] = K((packed >> (i * KEY_BITS)) & KEY_MAX);
+                }
+                return r;
+            }
+
+            inline void migrate(size_t steps) {
+                if (!m_migrating) return;
+
+                const size_t end = std::min(m_migrated + steps, m_old.capacity());
+                for(; m_migrated < end; m_migrated++) {
+                    const auto& slot = m_old[m_migrated];
+                    if (slot.key != EMPTY) {
+                        m_table.insert(slot.key, slot.val);
+                        m_table_fill++;
+                    }
+                }
+
+                if (m_migrated == m_old.capacity()) {
+                    m_old = Table();
+                    m_migrating = false;
+                }
+            }
+
+            inline void grow() {
+                // Only happens if a lot of new keys arrive
+                // before the last resize got finished.
+                migrate(m_old.capacity());
+
+                m_old = std::move(m_table);
+                m_table = Table(m_old.bits() + 1);
+                m_table_fill = 0;
+                m_migrated = 0;
+                m_migrating = true;
+            }
+        public:
+            inline IPDMap(size_t bucket_count, const Array<N, K>& empty):
+                m_table(std::max(MIN_BITS, size_t(bits_for(bucket_count * 2)))) {}
+
+            template<typename Updater>
+            inline V access(const Array<N, K>& key, Updater updater) {
+                if (!fits(key)) {
+                    const size_t old_size = m_overflow.size();
+                    auto& val = m_overflow[key];
+                    m_size += m_overflow.size() - old_size;
+                    updater(val);
+                    return val;
+                }
+
+                const uint64_t packed = pack(key);
+
+                migrate(MIGRATE_STEP);
+
+                Slot* slot = m_table.find(packed);
+                if (slot == nullptr && m_migrating) {
+                    slot = m_old.find(packed);
+                }
+                if (slot == nullptr) {
+                    // keep the load factor at or below 1/2
+                    if ((m_table_fill + 1) * 2 > m_table.capacity()) {
+                        grow();
+                    }
+                    slot = m_table.insert(packed, V());
+                    m_table_fill++;
+                    m_size++;
+                }
+
+                updater(slot->val);
+                return slot->val;
+            }
+
+            inline size_t size() const {
+                return m_size;
+            }
+
+            template<typename F>
+            void for_all(F f) const {
+                for(size_t i = 0; i < m_table.capacity(); i++) {
+                    const auto& slot = m_table[i];
+                    if (slot.key != EMPTY) {
+                        f(unpack(slot.key), slot.val);
+                    }
+                }
+                if (m_migrating) {
+                    for(size_t i = m_migrated; i < m_old.capacity(); i++) {
+                        const auto& slot = m_old[i];
+                        if (slot.key != EMPTY) {
+                            f(unpack(slot.key), slot.val);
+                        }
+                    }
+                }
+                for(auto& kv : m_overflow) {
+                    f(kv.first, kv.second);
+                }
+            }
+        };
+    };
+}}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <tudocomp/Algorithm.hpp>
+#include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/def.hpp>
+
+#include <tudocomp/compressors/lzss/LZSSFactors.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+namespace lcpcomp {
+
+/**
+ * A memory efficient variant of @class ArraysComp.
+ *
+ * Instead of SA, ISA and LCP, it works on the Phi and PLCP arrays only:
+ * A candidate is identified by its text position p, so the LCP value
+ * lcp[isa[p]] is plcp[p] and the source sa[isa[p]-1] is phi[p].
+ * Erasing and correcting the candidates covered by a factor thus needs
+ * no ISA.
+ *
+ * The candidates are stored in buckets by their PLCP value, which are laid
+ * out in a single bit-compressed array after counting the bucket sizes.
+ * Candidates whose value decreased are moved to the bucket of their new
+ * value by chaining them into a list of that bucket. Nodes of these lists
+ * are recycled once they got processed.
+ */
+class PLCPArraysComp : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("lcpcomp_comp", "plcp_arrays",
+            "Like arrays, but using only the Phi and PLCP arrays.");
+        return m;
+    }
+
+    inline static ds::dsflags_t textds_flags() {
+        return ds::PHI | ds::PLCP;
+    }
+
+    using Algorithm::Algorithm; //import constructor
+
+    template<typename text_t>
+    inline void factorize(text_t& text, size_t threshold, lzss::FactorBuffer& factors) {
+
+        // Construct Phi and PLCP
+        auto plcp = StatPhase::wrap("Construct Index Data Structures", [&] {
+            text.require(text_t::PHI | text_t::PLCP);
+
+            auto plcp = text.release_plcp();
+            StatPhase::log("maxlcp", plcp.max_lcp());
+            return plcp;
+        });
+
+        auto& phi = text.require_phi();
+
+        const len_t n = text.size();
+        if(n < 2) return;
+
+        // the suffix at position n-1 is the smallest one and has no
+        // predecessor in the suffix array, PLCPFromPhi does not set its value
+        plcp[n-1] = 0;
+
+        if(plcp.max_lcp()+1 <= threshold) return; // nothing to factorize
+        const len_t cand_length = plcp.max_lcp()+1-threshold;
+
+        // bucket b covers the positions with PLCP value b+threshold,
+        // it starts at offset[b] in cand
+        DynamicIntVector offset;
+        DynamicIntVector cand;
+
+        StatPhase::wrap("Fill candidates", [&]{
+            len_t entries = 0;
+            {
+                DynamicIntVector count(cand_length, 0, bits_for(n));
+                for(len_t i = 0; i+1 < n; ++i) {
+                    if(plcp[i] < threshold) continue;
+                    count[plcp[i]-threshold] = count[plcp[i]-threshold] + 1;
+                    ++entries;
+                }
+
+                offset = DynamicIntVector(cand_length+1, 0, bits_for(entries));
+                for(len_t b = 0; b < cand_length; ++b) {
+                    offset[b+1] = offset[b] + count[b];
+                }
+            }
+
+            cand = DynamicIntVector(entries, 0, bits_for(n));
+            {
+                // use the end of each bucket as its fill cursor
+                DynamicIntVector fill(offset);
+                for(len_t i = 0; i+1 < n; ++i) {
+                    if(plcp[i] < threshold) continue;
+                    const len_t b = plcp[i]-threshold;
+                    cand[fill[b]] = i;
+                    fill[b] = fill[b] + 1;
+                }
+            }
+
+            StatPhase::log("entries", entries);
+        });
+
+        StatPhase::wrap("Compute Factors", [&]{
+            // singly linked lists of moved candidates, one per bucket
+            // (0 denotes the empty list, node k is stored at index k-1)
+            DynamicIntVector head(cand_length, 0, bits_for(cand.size()));
+            std::vector<len_compact_t> node_pos;
+            std::vector<len_compact_t> node_next;
+            len_t free_list = 0;
+
+            IF_STATS(len_t moved = 0);
+
+            auto move_down = [&](len_t pos) {
+                const len_t b = plcp[pos]-threshold;
+                len_t k;
+                if(free_list) {
+                    k = free_list;
+                    free_list = node_next[k-1];
+                    node_pos[k-1] = pos;
+                    node_next[k-1] = head[b];
+                } else {
+                    node_pos.push_back(pos);
+                    node_next.push_back(head[b]);
+                    k = node_pos.size();
+                }
+                head[b] = k;
+                IF_STATS(++moved);
+            };
+
+            auto process = [&](len_t pos, len_t maxlcp) {
+                const len_t lcp_value = plcp[pos];
+                if(lcp_value < maxlcp) { // if it got resized, we push it down
+                    if(lcp_value >= threshold) move_down(pos); // otherwise it is already erased
+                    return;
+                }
+
+                //generate factor
+                const len_t pos_target = pos;
+                const len_t pos_source = phi[pos];
+                const len_t factor_length = lcp_value;
+
+                factors.emplace_back(pos_target, pos_source, factor_length);
+
+                //erase suffixes on the replaced area
+                for(len_t k = 0; k < factor_length; ++k) {
+                    plcp[pos_target + k] = 0;
+                }
+
+                const len_t max_affect = std::min(factor_length, pos_target); //if pos_target is at the very beginning, we have less to scan
+                //correct intersecting entries
+                for(len_t k = 0; k < max_affect; ++k) {
+                    const len_t pos_suffix = pos_target - k - 1;
+                    if(plcp[pos_suffix] > k+1) plcp[pos_suffix] = k+1;
+                }
+            };
+
+            for(len_t maxlcp = plcp.max_lcp(); maxlcp >= threshold; --maxlcp) {
+                const len_t b = maxlcp-threshold;
+
+                for(len_t i = offset[b]; i < offset[b+1]; ++i) {
+                    process(cand[i], maxlcp);
+                }
+
+                // moved candidates, new ones may get chained in meanwhile
+                while(head[b]) {
+                    const len_t k = head[b];
+                    head[b] = node_next[k-1];
+                    node_next[k-1] = free_list;
+                    free_list = k;
+
+                    process(node_pos[k-1], maxlcp);
+                }
+            }
+
+            IF_STATS(StatPhase::log("moved candidates", moved));
+            StatPhase::log("list nodes", node_pos.size());
+        });
+    }
+};
+
+}}
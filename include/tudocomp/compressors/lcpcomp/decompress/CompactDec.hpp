@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <tudocomp/def.hpp>
+#include <tudocomp/util/LZCopy.hpp>
 #include <tudocomp/ds/IntVector.hpp>
 #include <tudocomp/Algorithm.hpp>
 
@@ -122,7 +123,7 @@ public:
     })
 
     inline void write_to(std::ostream& out) const {
-        for(auto c : m_buffer) out << c;
+        write_block(out, m_buffer.data(), m_buffer.size());
     }
 };
 
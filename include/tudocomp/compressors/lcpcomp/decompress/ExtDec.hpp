@@ -0,0 +1,483 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <queue>
+#include <vector>
+
+#include <tudocomp/def.hpp>
+#include <tudocomp/Algorithm.hpp>
+#include <tudocomp/io/TempFile.hpp>
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+namespace lcpcomp {
+
+/// \cond INTERNAL
+namespace ext {
+
+/// A factor whose source was not yet decoded.
+struct PendingFactor {
+    len_compact_t target, source, len;
+
+    inline len_t key() const { return source; }
+} __attribute__((__packed__));
+
+/// Decoded characters waiting to be written to their target position.
+struct PendingWrite {
+    static constexpr size_t CAPACITY = 32 - sizeof(len_compact_t) - 1;
+
+    len_compact_t target;
+    uint8_t len;
+    uliteral_t chars[CAPACITY];
+
+    inline len_t key() const { return target; }
+} __attribute__((__packed__));
+
+/// The maximum amount of runs merged at once, which bounds the amount of
+/// temporary files open at the same time.
+constexpr size_t MAX_FAN_IN = 64;
+
+/// Merges sorted runs of records.
+///
+/// Additional records can be pushed during the merge, as long as they do not
+/// have a smaller key than the last one returned.
+template<typename T>
+class RunMerger {
+    struct Reader {
+        const io::TempFile* file;
+        std::vector<T> buffer;
+        size_t file_pos = 0; // in records
+        size_t buf_pos = 0;
+
+        inline bool next(T& out) {
+            if(buf_pos == buffer.size()) {
+                const size_t total = file->size() / sizeof(T);
+                const size_t n = std::min(buffer.capacity(), total - file_pos);
+                if(n == 0) return false;
+
+                buffer.resize(n);
+                file->read(buffer.data(), n * sizeof(T), file_pos * sizeof(T));
+                file_pos += n;
+                buf_pos = 0;
+            }
+            out = buffer[buf_pos++];
+            return true;
+        }
+    };
+
+    static constexpr size_t NO_READER = size_t(-1);
+
+    using entry_t = std::pair<T, size_t>;
+    struct Greater {
+        inline bool operator()(const entry_t& a, const entry_t& b) const {
+            return a.first.key() > b.first.key();
+        }
+    };
+
+    std::vector<Reader> m_readers;
+    std::priority_queue<entry_t, std::vector<entry_t>, Greater> m_heap;
+
+public:
+    /// \param buffer_bytes the memory to use for buffering all runs.
+    inline RunMerger(const std::vector<io::TempFile>& runs, size_t buffer_bytes) {
+        DCHECK_LE(runs.size(), MAX_FAN_IN);
+        const size_t per_run = std::max(size_t(1),
+            buffer_bytes / std::max(size_t(1), runs.size()) / sizeof(T));
+
+        m_readers.resize(runs.size());
+        for(size_t i = 0; i < runs.size(); i++) {
+            m_readers[i].file = &runs[i];
+            m_readers[i].buffer.reserve(
+                std::min(per_run, runs[i].size() / sizeof(T)));
+
+            T x;
+            if(m_readers[i].next(x)) m_heap.emplace(x, i);
+        }
+    }
+
+    inline void push(const T& x) {
+        m_heap.emplace(x, size_t(NO_READER));
+    }
+
+    inline bool next(T& out) {
+        if(m_heap.empty()) return false;
+
+        auto top = m_heap.top();
+        m_heap.pop();
+        out = top.first;
+
+        if(top.second != NO_READER) {
+            T x;
+            if(m_readers[top.second].next(x)) m_heap.emplace(x, top.second);
+        }
+        return true;
+    }
+};
+
+/// Merges sorted runs into a single sorted run.
+///
+/// \param buffer_bytes the memory to use for buffering the runs
+///                     and the output.
+template<typename T>
+inline io::TempFile merge_runs(
+    const std::vector<io::TempFile>& runs,
+    const std::string& dir,
+    size_t buffer_bytes) {
+
+    RunMerger<T> merger(runs, buffer_bytes / 2);
+
+    std::vector<T> buffer;
+    buffer.reserve(std::max(size_t(1), buffer_bytes / 2 / sizeof(T)));
+
+    io::TempFile merged(dir);
+    T x;
+    while(merger.next(x)) {
+        buffer.push_back(x);
+        if(buffer.size() == buffer.capacity()) {
+            merged.append(buffer.data(), buffer.size() * sizeof(T));
+            buffer.clear();
+        }
+    }
+    if(!buffer.empty()) merged.append(buffer.data(), buffer.size() * sizeof(T));
+    return merged;
+}
+
+/// Collects records in memory and spills them to disk as sorted runs
+/// whenever the buffer is full.
+///
+/// Every run keeps a temporary file open. Whenever `MAX_FAN_IN` runs of the
+/// same merge level exist, they are merged into one run of the next level,
+/// so the amount of runs grows only logarithmically with the input.
+template<typename T>
+class RunBuffer {
+    std::string m_dir;
+    std::vector<T> m_buffer;
+    size_t m_capacity;
+    size_t m_size = 0;
+    std::vector<io::TempFile> m_runs;
+    std::vector<size_t> m_levels; // non-increasing
+
+    /// Merges all runs starting at `first` into a single one.
+    inline void merge_from(size_t first) {
+        // the buffer was just spilled, its memory is used for the merge
+        m_buffer = std::vector<T>();
+
+        std::vector<io::TempFile> runs(
+            std::make_move_iterator(m_runs.begin() + first),
+            std::make_move_iterator(m_runs.end()));
+        m_runs.erase(m_runs.begin() + first, m_runs.end());
+
+        const size_t level = m_levels[first] + 1;
+        m_levels.erase(m_levels.begin() + first, m_levels.end());
+
+        m_runs.push_back(merge_runs<T>(runs, m_dir, m_capacity * sizeof(T)));
+        m_levels.push_back(level);
+    }
+
+    inline void spill() {
+        if(m_buffer.empty()) return;
+
+        std::stable_sort(m_buffer.begin(), m_buffer.end(),
+            [](const T& a, const T& b) { return a.key() < b.key(); });
+
+        io::TempFile run(m_dir);
+        run.append(m_buffer.data(), m_buffer.size() * sizeof(T));
+        m_runs.push_back(std::move(run));
+        m_levels.push_back(0);
+        m_buffer.clear();
+
+        while(m_runs.size() >= MAX_FAN_IN &&
+              m_levels[m_runs.size() - MAX_FAN_IN] == m_levels.back()) {
+            merge_from(m_runs.size() - MAX_FAN_IN);
+        }
+    }
+
+public:
+    inline RunBuffer(const std::string& dir, size_t capacity)
+        : m_dir(dir), m_capacity(std::max(size_t(1), capacity)) {
+    }
+
+    inline void push_back(const T& x) {
+        if(m_buffer.size() == m_capacity) spill();
+        m_buffer.push_back(x);
+        ++m_size;
+    }
+
+    /// The total amount of records pushed.
+    inline size_t size() const {
+        return m_size;
+    }
+
+    /// Spills the remaining records and hands over all runs,
+    /// at most `MAX_FAN_IN` of them.
+    inline std::vector<io::TempFile> finish() {
+        spill();
+        m_buffer = std::vector<T>();
+
+        while(m_runs.size() > MAX_FAN_IN) {
+            // merge just enough of the smallest runs
+            const size_t excess = m_runs.size() - MAX_FAN_IN + 1;
+            merge_from(m_runs.size() - std::min(excess, MAX_FAN_IN));
+        }
+        m_levels.clear();
+        return std::move(m_runs);
+    }
+};
+
+}
+/// \endcond
+
+/**
+ * Decodes lcpcomp compressed data within a configurable memory budget.
+ *
+ * The text is written to a temporary file while the factors are read.
+ * Factors whose source is still in the in-memory tail of the text are
+ * decoded right away. All others are kept as pending factors in sorted
+ * runs on local disk.
+ *
+ * They are resolved in passes. Each pass scans the text file in order of
+ * the pending sources and collects all characters that are already known.
+ * These get sorted by target position and written back in a second
+ * sequential scan. Parts of factors that still refer to unknown characters
+ * are deferred to the next pass.
+ */
+class ExtDec : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("lcpcomp_dec", "ext",
+            "Decodes with bounded memory using temporary files.");
+        m.option("mem").dynamic(256); // memory budget in MiB
+        m.option("tmp").dynamic("/tmp"); // directory for temporary files
+        return m;
+    }
+
+private:
+    using PendingFactor = ext::PendingFactor;
+    using PendingWrite = ext::PendingWrite;
+
+    const std::string m_dir;
+    const size_t m_budget;
+    const len_t m_size;
+
+    io::TempFile m_text;
+
+    // the part [m_tail_begin, m_cursor) of the text is held in memory
+    std::vector<uliteral_t> m_tail;
+    len_t m_tail_begin;
+    len_t m_cursor;
+
+    ext::RunBuffer<PendingFactor> m_pending;
+
+    IF_STATS(len_t m_passes = 0);
+
+    /// The amount of bytes for the text window, the record buffers
+    /// and the run readers, respectively.
+    inline size_t quarter() const {
+        return std::max(size_t(4096), m_budget / 4);
+    }
+
+    /// The size of a text window.
+    inline size_t window_size() const {
+        return std::max(size_t(1), std::min(size_t(m_size), quarter()));
+    }
+
+    inline void put(uliteral_t c) {
+        m_tail[m_cursor - m_tail_begin] = c;
+        ++m_cursor;
+
+        if(m_cursor - m_tail_begin == m_tail.size()) {
+            // write out the first half, keep the second one as context
+            const size_t half = m_tail.size() / 2;
+            m_text.write(m_tail.data(), half, m_tail_begin);
+            std::memmove(m_tail.data(), m_tail.data() + half, m_tail.size() - half);
+            m_tail_begin += half;
+        }
+    }
+
+    inline void flush_tail() {
+        m_text.write(m_tail.data(), m_cursor - m_tail_begin, m_tail_begin);
+        m_tail_begin = m_cursor;
+        m_tail = std::vector<uliteral_t>();
+    }
+
+    /// Reads a window of the text starting at `begin`.
+    inline len_t read_window(std::vector<uliteral_t>& window, len_t begin) const {
+        const len_t end = std::min(len_t(m_size), len_t(begin + window.size()));
+        m_text.read(window.data(), end - begin, begin);
+        return end;
+    }
+
+    /// Collects the known characters of all pending factors,
+    /// deferring the unknown ones to `next`.
+    inline void collect(
+        const std::vector<io::TempFile>& pending,
+        ext::RunBuffer<PendingFactor>& next,
+        ext::RunBuffer<PendingWrite>& writes) const {
+
+        ext::RunMerger<PendingFactor> factors(pending, quarter());
+        std::vector<uliteral_t> window(window_size());
+        len_t w_begin = 0, w_end = 0;
+
+        PendingFactor f;
+        while(factors.next(f)) {
+            const len_t target = f.target;
+            const len_t source = f.source;
+            const len_t len = f.len;
+
+            if(source < w_begin || source >= w_end) {
+                w_begin = source;
+                w_end = read_window(window, w_begin);
+            }
+
+            const len_t k = std::min(len, w_end - source);
+            const uliteral_t* chars = window.data() + (source - w_begin);
+
+            for(len_t i = 0; i < k;) {
+                len_t j = i;
+                if(chars[i]) {
+                    while(j < k && chars[j]) ++j;
+
+                    for(len_t p = i; p < j; p += PendingWrite::CAPACITY) {
+                        PendingWrite w;
+                        w.target = target + p;
+                        w.len = std::min(size_t(j - p), size_t(PendingWrite::CAPACITY));
+                        std::memcpy(w.chars, chars + p, w.len);
+                        writes.push_back(w);
+                    }
+                } else {
+                    while(j < k && !chars[j]) ++j;
+                    next.push_back(PendingFactor { target + i, source + i, j - i });
+                }
+                i = j;
+            }
+
+            if(k < len) {
+                // the factor source exceeds the window
+                factors.push(PendingFactor { target + k, source + k, len - k });
+            }
+        }
+    }
+
+    /// Writes the collected characters to their target positions.
+    inline void apply(const std::vector<io::TempFile>& write_runs) {
+        ext::RunMerger<PendingWrite> writes(write_runs, quarter());
+        std::vector<uliteral_t> window(window_size());
+        len_t w_begin = 0, w_end = 0;
+
+        PendingWrite w;
+        while(writes.next(w)) {
+            const len_t target = w.target;
+
+            if(target < w_begin || target >= w_end) {
+                if(w_end > w_begin) m_text.write(window.data(), w_end - w_begin, w_begin);
+                w_begin = target;
+                w_end = read_window(window, w_begin);
+            }
+
+            const len_t k = std::min(len_t(w.len), w_end - target);
+            std::memcpy(window.data() + (target - w_begin), w.chars, k);
+
+            if(k < w.len) {
+                PendingWrite rest;
+                rest.target = target + k;
+                rest.len = w.len - k;
+                std::memcpy(rest.chars, w.chars + k, rest.len);
+                writes.push(rest);
+            }
+        }
+        if(w_end > w_begin) m_text.write(window.data(), w_end - w_begin, w_begin);
+    }
+
+public:
+    inline ExtDec(Env&& env, len_t size)
+        : Algorithm(std::move(env))
+        , m_dir(this->env().option("tmp").as_string())
+        , m_budget(this->env().option("mem").as_integer() << 20)
+        , m_size(size)
+        , m_text(m_dir)
+        , m_tail(std::max(size_t(2), window_size()))
+        , m_tail_begin(0)
+        , m_cursor(0)
+        , m_pending(m_dir, quarter() / sizeof(PendingFactor))
+    {
+    }
+
+    inline void decode_literal(uliteral_t c) {
+        put(c);
+        DCHECK(c != 0 || m_cursor == m_size); // we assume that the text to restore does not contain a NULL-byte but at its very end
+    }
+
+    inline void decode_factor(const len_t source_position, const len_t factor_length) {
+        // the current run of characters not available in the tail
+        len_t run_target = 0, run_source = 0, run_len = 0;
+
+        for(len_t i = 0; i < factor_length; ++i) {
+            const len_t src = source_position + i;
+
+            uliteral_t c = 0;
+            if(src >= m_tail_begin && src < m_cursor) {
+                c = m_tail[src - m_tail_begin];
+            }
+
+            if(c == 0) {
+                if(run_len > 0 && run_source + run_len == src && run_target + run_len == m_cursor) {
+                    ++run_len;
+                } else {
+                    if(run_len > 0) m_pending.push_back(PendingFactor { run_target, run_source, run_len });
+                    run_target = m_cursor;
+                    run_source = src;
+                    run_len = 1;
+                }
+            }
+            put(c);
+        }
+        if(run_len > 0) m_pending.push_back(PendingFactor { run_target, run_source, run_len });
+    }
+
+    inline void decode_lazy() {
+    }
+
+    inline void decode_eagerly() {
+        flush_tail();
+
+        StatPhase::log("pending factors", m_pending.size());
+        auto pending = m_pending.finish();
+
+        while(!pending.empty()) {
+            IF_STATS(++m_passes);
+
+            ext::RunBuffer<PendingFactor> next(m_dir, quarter() / sizeof(PendingFactor));
+            ext::RunBuffer<PendingWrite> writes(m_dir, quarter() / sizeof(PendingWrite));
+
+            collect(pending, next, writes);
+            pending.clear();
+
+            CHECK(writes.size() > 0)
+                << "no pending factor can be resolved, the input is invalid";
+
+            apply(writes.finish());
+            pending = next.finish();
+        }
+
+        IF_STATS(StatPhase::log("passes", m_passes));
+    }
+
+    IF_STATS(
+    /// The amount of passes needed, a lower bound of the longest chain.
+    inline len_t longest_chain() const {
+        return m_passes;
+    })
+
+    inline void write_to(std::ostream& out) const {
+        std::vector<uliteral_t> window(window_size());
+        for(len_t p = 0; p < m_size;) {
+            const len_t end = read_window(window, p);
+            out.write((const char*) window.data(), end - p);
+            p = end;
+        }
+    }
+};
+
+}} //ns
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <tudocomp/def.hpp>
+#include <tudocomp/util/LZCopy.hpp>
 #include <tudocomp/Algorithm.hpp>
 #include <tudocomp/ds/IntVector.hpp>
 
@@ -154,7 +155,7 @@ public:
     }
 
     inline void write_to(std::ostream& out) {
-        for(auto c : m_buffer) out << c;
+        write_block(out, m_buffer.data(), m_buffer.size());
     }
 };
 
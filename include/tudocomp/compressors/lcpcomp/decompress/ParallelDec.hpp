@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include <tudocomp/def.hpp>
+#include <tudocomp/util/LZCopy.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/Algorithm.hpp>
+#include <tudocomp/util/Parallel.hpp>
+#include <tudocomp/compressors/lcpcomp/decompress/ScanDec.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+namespace lcpcomp {
+
+/**
+ * Decodes the factors level by level.
+ *
+ * A factor part belongs to level k if its source characters get known
+ * after k-1 levels, ie., k is the dependency depth of its source.
+ * All factor parts of the same level are independent of each other and
+ * get copied in parallel.
+ *
+ * Each level is processed in two steps separated by a barrier:
+ * First, all pending factors are split into the parts that can be copied
+ * now and the parts that still refer to unknown characters.
+ * Then, the copyable parts are written.
+ *
+ * Once fewer than `tail` factor parts are pending, or a level copies only
+ * a small share of the pending parts (as on long chains of references, where
+ * every level would rescan almost all pending parts), the remaining deep
+ * chains are decoded sequentially with @class EagerScanDec.
+ */
+class ParallelDec : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("lcpcomp_dec", "parallel",
+            "Decodes the factors of each dependency level in parallel.");
+        m.option("threads").dynamic(0); // 0 = OpenMP default
+        m.option("tail").dynamic(1024);
+        return m;
+    }
+
+private:
+    /// Minimum amount of pending factors per thread.
+    static constexpr size_t MIN_PER_THREAD = 1ULL << 12;
+
+    /// A level has to copy at least 1/MIN_LEVEL_SHARE of the pending factor
+    /// parts, otherwise the levels are stopped.
+    static constexpr size_t MIN_LEVEL_SHARE = 16;
+
+    /// Factor parts stored in the layout expected by @class EagerScanDec.
+    struct Factors {
+        std::vector<len_compact_t> target;
+        std::vector<len_compact_t> source;
+        std::vector<len_compact_t> length;
+
+        inline void push_back(len_t t, len_t s, len_t l) {
+            target.push_back(t);
+            source.push_back(s);
+            length.push_back(l);
+        }
+
+        inline void append(const Factors& other) {
+            target.insert(target.end(), other.target.begin(), other.target.end());
+            source.insert(source.end(), other.source.begin(), other.source.end());
+            length.insert(length.end(), other.length.begin(), other.length.end());
+        }
+
+        inline void clear() {
+            target.clear();
+            source.clear();
+            length.clear();
+        }
+
+        inline size_t size() const {
+            return target.size();
+        }
+    };
+
+    const size_t m_threads;
+    const size_t m_tail;
+
+    len_t m_cursor;
+    IntVector<uliteral_t> m_buffer;
+
+    Factors m_pending;
+
+    IF_STATS(len_t m_longest_chain = 0);
+
+    /// Splits the factor part into the runs with known and unknown source.
+    inline void split(len_t target, len_t source, len_t len,
+                      Factors& ready, Factors& pending) const {
+        for(len_t i = 0; i < len;) {
+            len_t j = i;
+            if(m_buffer[source + i]) {
+                while(j < len && m_buffer[source + j]) ++j;
+                ready.push_back(target + i, source + i, j - i);
+            } else {
+                while(j < len && !m_buffer[source + j]) ++j;
+                pending.push_back(target + i, source + i, j - i);
+            }
+            i = j;
+        }
+    }
+
+    /// Decodes one level.
+    ///
+    /// \return the amount of factor parts copied.
+    inline size_t decode_level() {
+        const size_t n = m_pending.size();
+        const size_t threads = threads_for(n, MIN_PER_THREAD, m_threads);
+
+        std::vector<Factors> ready(threads);
+        std::vector<Factors> pending(threads);
+
+        #pragma omp parallel num_threads(threads)
+        {
+            // the team may be smaller than requested
+            const size_t team = num_threads();
+            const size_t chunk = (n + team - 1) / team;
+
+            const size_t t = thread_num();
+            const size_t begin = std::min(n, t * chunk);
+            const size_t end = std::min(n, begin + chunk);
+
+            for(size_t j = begin; j < end; ++j) {
+                split(m_pending.target[j], m_pending.source[j], m_pending.length[j],
+                      ready[t], pending[t]);
+            }
+
+            // the targets of this level must not be written
+            // before all threads are done reading
+            #pragma omp barrier
+
+            const Factors& r = ready[t];
+            for(size_t j = 0; j < r.size(); ++j) {
+                const len_t target = r.target[j];
+                const len_t source = r.source[j];
+                // the source is known and the target is not, so they
+                // do not overlap
+                std::memcpy(m_buffer.data() + target,
+                            m_buffer.data() + source, r.length[j]);
+            }
+        }
+
+        size_t copied = 0;
+        m_pending.clear();
+        for(size_t t = 0; t < threads; ++t) {
+            copied += ready[t].size();
+            m_pending.append(pending[t]);
+        }
+        return copied;
+    }
+
+public:
+    inline ParallelDec(Env&& env, len_t size)
+        : Algorithm(std::move(env))
+        , m_threads(this->env().option("threads").as_integer())
+        , m_tail(this->env().option("tail").as_integer())
+        , m_cursor(0)
+        , m_buffer(size, 0)
+    { }
+
+    inline void decode_literal(uliteral_t c) {
+        m_buffer[m_cursor++] = c;
+        DCHECK(c != 0 || m_cursor == m_buffer.size()); // we assume that the text to restore does not contain a NULL-byte but at its very end
+    }
+
+    inline void decode_factor(const len_t source_position, const len_t factor_length) {
+        // store the runs of characters that are not yet known
+        len_t run_target = 0, run_source = 0, run_len = 0;
+        for(len_t i = 0; i < factor_length; ++i) {
+            const len_t src_pos = source_position + i;
+            if(m_buffer[src_pos]) {
+                m_buffer[m_cursor] = m_buffer[src_pos];
+            } else if(run_len > 0 && run_target + run_len == m_cursor) {
+                ++run_len;
+            } else {
+                if(run_len > 0) m_pending.push_back(run_target, run_source, run_len);
+                run_target = m_cursor;
+                run_source = src_pos;
+                run_len = 1;
+            }
+            ++m_cursor;
+        }
+        if(run_len > 0) m_pending.push_back(run_target, run_source, run_len);
+    }
+
+    inline void decode_lazy() {
+    }
+
+    inline void decode_eagerly() {
+        len_t levels = 0;
+        {
+            StatPhase phase("Decoding Levels");
+            phase.log_stat("factors", m_pending.size());
+
+            while(m_pending.size() > m_tail) {
+                const size_t pending = m_pending.size();
+                const size_t copied = decode_level();
+                if(copied == 0) break; // left for the sequential decoder
+                ++levels;
+
+                // on deep chains, further levels would cost more than
+                // decoding the rest sequentially
+                if(copied * MIN_LEVEL_SHARE < pending) break;
+            }
+
+            phase.log_stat("levels", levels);
+            phase.log_stat("remaining factors", m_pending.size());
+        }
+
+        EagerScanDec* decoder = StatPhase::wrap("Initialize Bit Vector", [&]{
+            return new EagerScanDec(this->env(), m_buffer);
+        });
+
+        decoder->decode(m_pending.target, m_pending.source, m_pending.length);
+        IF_STATS(m_longest_chain = levels + decoder->longest_chain());
+
+        StatPhase::wrap("Destructor EagerScanDec", [&]{
+            delete decoder;
+        });
+    }
+
+    IF_STATS(
+    inline len_t longest_chain() const {
+        return m_longest_chain;
+    })
+
+    inline void write_to(std::ostream& out) const {
+        write_block(out, m_buffer.data(), m_buffer.size());
+    }
+};
+
+}} //ns
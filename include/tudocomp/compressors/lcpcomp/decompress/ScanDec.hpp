@@ -4,6 +4,7 @@
 #include <sdsl/int_vector.hpp>
 #include <sdsl/rank_support.hpp>
 #include <tudocomp/def.hpp>
+#include <tudocomp/util/LZCopy.hpp>
 #include <tudocomp/ds/IntVector.hpp>
 #include <tudocomp/Algorithm.hpp>
 #include <algorithm>
@@ -50,7 +51,7 @@ namespace lcpcomp {
 			, m_empty_entries { static_cast<len_t>(std::count_if(buffer.cbegin(), buffer.cend(), [] (const uliteral_t& i) { return i == 0; })) }
 			, m_fwd { new len_compact_t*[m_empty_entries+1] }
 		{
-        std::fill(m_fwd,m_fwd+m_empty_entries,nullptr);
+        std::fill(m_fwd,m_fwd+m_empty_entries+1,nullptr); // rank() is 1-based
 		}
 
 		len_t rank(len_t i) const {
@@ -128,7 +129,7 @@ namespace lcpcomp {
 
 	~EagerScanDec() {
 		DCHECK(m_fwd != nullptr);
-		for(size_t i = 0; i < m_empty_entries; ++i) {
+		for(size_t i = 0; i <= m_empty_entries; ++i) {
 			if(m_fwd[i] == nullptr) continue;
 			delete [] m_fwd[i];
 		}
@@ -180,10 +181,9 @@ private:
             const len_compact_t& target_position = m_target_pos[j];
             const len_compact_t& source_position = m_source_pos[j];
             const len_compact_t& factor_length = m_length[j];
-            for(len_t i = 0; i < factor_length; ++i) {
-				//DCHECK(m_buffer[source_position+i] == 0 && m_buffer[target_position+i] == 0);
-				m_buffer[target_position+i] = m_buffer[source_position+i];
-            }
+            // unknown characters are copied as zeros, to be resolved later
+            lz_copy(m_buffer.data() + target_position,
+                    m_buffer.data() + source_position, factor_length);
         }
     }
     const size_t m_scans; // number of scan rounds
@@ -242,7 +242,7 @@ public:
     })
 
     inline void write_to(std::ostream& out) const {
-        for(auto c : m_buffer) out << c;
+        write_block(out, m_buffer.data(), m_buffer.size());
     }
 };
 
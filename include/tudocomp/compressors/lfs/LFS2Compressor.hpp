@@ -9,11 +9,9 @@
 #include <tudocomp/util.hpp>
 #include <tudocomp/io.hpp>
 #include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/TextDS.hpp>
 #include <tudocomp_stat/StatPhase.hpp>
 
-//sdsl include stree:
-#include <sdsl/suffix_trees.hpp>
-
 
 //includes encoding:
 #include <tudocomp/io/BitIStream.hpp>
@@ -31,18 +29,26 @@
 namespace tdc {
 namespace lfs {
 
-template<typename literal_coder_t = HuffmanCoder, typename len_coder_t = EliasGammaCoder >
+template<typename literal_coder_t = HuffmanCoder, typename len_coder_t = EliasGammaCoder, typename text_t = TextDS<> >
 class LFS2Compressor : public Compressor {
 private:
 
+    //Internal node of the suffix tree, given by its LCP interval
+    struct Interval {
+        uint lb, rb; // SA range, inclusive
+        uint depth; // string depth, ie. the LCP value of the interval
+        uint parent; // index of the parent node
+    };
 
+    static constexpr uint NO_NODE = UINT_MAX;
 
+    //internal nodes in postorder
+    std::vector<Interval> nodes;
 
-    //Suffix Tree type + st
-    typedef sdsl::cst_sct3< sdsl::csa_bitcompressed<> > cst_t;
-    cst_t stree;
-
-    using node_type = typename cst_t::node_type;
+    //the SA, the range of a processed node is sorted by text position
+    std::vector<uint> positions;
+    //marks the processed nodes
+    BitVector sorted;
 
     //Stores nts_symbols of first layer
     IntVector<uint> first_layer_nts;
@@ -62,11 +68,86 @@ private:
     std::vector<std::vector<uint> > bins;
 
 
-    //stores beginning positions corresponding to node_ids
-    std::vector<std::vector<uint> > node_begins;
-
     bool exact;
-    uint size;
+
+    /// Computes the internal nodes of the suffix tree bottom-up
+    /// from the LCP array, using a stack of open LCP intervals.
+    template<typename lcp_t>
+    inline void compute_nodes(const lcp_t& lcp) {
+        struct Open {
+            uint lb;
+            uint depth;
+            uint first_child; // children are chained via their parent field
+        };
+
+        const uint n = lcp.size();
+        std::vector<Open> stack;
+        stack.push_back(Open { 0, 0, NO_NODE });
+
+        auto close = [&](uint rb) {
+            const Open top = stack.back();
+            stack.pop_back();
+
+            const uint id = nodes.size();
+            nodes.push_back(Interval { top.lb, rb, top.depth, NO_NODE });
+            for(uint c = top.first_child; c != NO_NODE;) {
+                const uint next = nodes[c].parent;
+                nodes[c].parent = id;
+                c = next;
+            }
+            return id;
+        };
+
+        for(uint i = 1; i <= n; i++) {
+            const uint cur = (i < n) ? uint(lcp[i]) : 0;
+            uint lb = i - 1;
+            uint last = NO_NODE;
+
+            while(cur < stack.back().depth) {
+                lb = stack.back().lb;
+                const uint id = close(i - 1);
+                if(cur <= stack.back().depth) {
+                    //the node below on the stack is the parent
+                    nodes[id].parent = stack.back().first_child;
+                    stack.back().first_child = id;
+                } else {
+                    //the interval opened next is the parent
+                    last = id;
+                }
+            }
+            if(cur > stack.back().depth) {
+                stack.push_back(Open { lb, cur, last });
+            }
+        }
+        close(n - 1); // root
+    }
+
+    /// Sorts the range of a node by text position.
+    ///
+    /// The ranges of its children were sorted before, so this merges
+    /// the ascending runs of the range.
+    inline void sort_node(const Interval& node) {
+        auto begin = positions.begin() + node.lb;
+        auto end = positions.begin() + node.rb + 1;
+
+        std::vector<decltype(begin)> runs;
+        runs.push_back(begin);
+        for(auto it = begin + 1; it != end; ++it) {
+            if(*it < *(it - 1)) runs.push_back(it);
+        }
+        runs.push_back(end);
+
+        while(runs.size() > 2) {
+            size_t k = 0;
+            for(size_t j = 0; j + 2 < runs.size(); j += 2) {
+                std::inplace_merge(runs[j], runs[j + 1], runs[j + 2]);
+                runs[k++] = runs[j];
+            }
+            if(runs.size() % 2 == 0) runs[k++] = runs[runs.size() - 2];
+            runs[k++] = runs.back();
+            runs.resize(k);
+        }
+    }
 
 
 
@@ -81,6 +162,8 @@ public:
         m.option("exact").dynamic(0);
         m.option("lfs2_lit_coder").templated<literal_coder_t, HuffmanCoder>("lfs2_lit_coder");
         m.option("lfs2_len_coder").templated<len_coder_t, EliasGammaCoder>("lfs2_len_coder");
+        m.option("textds").templated<text_t, TextDS<>>("textds");
+        m.uses_textds<text_t>(text_t::SA | text_t::LCP);
 
         return m;
     }
@@ -115,50 +198,53 @@ public:
 
 
 
-        StatPhase::wrap("Constructing ST", [&]{
-            size =  in.size();
-            //remove sentinel because sdsl cant handle that
-            while(in[size-1] == 0){
-                size--;
-            }
+        StatPhase::wrap("Computing LCP Intervals", [&]{
+            text_t t(env().env_for_option("textds"), in, text_t::SA | text_t::LCP);
 
+            {
+                auto lcp = t.release_lcp();
+                compute_nodes(lcp);
+            }
 
+            auto& sa = t.require_sa();
+            positions.resize(sa.size());
+            for(uint k = 0; k < sa.size(); k++) {
+                positions[k] = sa[k];
+            }
+            sorted = BitVector(nodes.size(), 0);
 
-            std::string in_string ((const char*) in.data(), size);
-            sdsl::construct_im(stree, in_string , 1);
+            StatPhase::log("Internal Nodes", nodes.size());
         });
 
 
 
         StatPhase::wrap("Computing LRF", [&]{
-            bins.resize(200);
-            uint node_counter = 0;
-
-            typedef sdsl::cst_bfs_iterator<cst_t> iterator;
-            iterator begin = iterator(&stree, stree.root());
-            iterator end   = iterator(&stree, stree.root(), true, true);
-
-            StatPhase::wrap("Iterate over ST", [&]{
-                DLOG(INFO)<<"iterate st";
-
-                for (iterator it = begin; it != end; ++it) {
-
-                    if(!stree.is_leaf(*it)){
-
-                        if(bins.size() <= stree.depth(*it)) {
-
-                            uint resize = bins.size()*2;
-                            while (resize<= stree.depth(*it)) {
-                                resize*=2;
-                            }
-                            bins.resize(resize);
-                        }
-                        bins[stree.depth(*it)].push_back(stree.id(*it));
-                        node_counter++;
+            StatPhase::wrap("Fill Node Bins", [&]{
+                DLOG(INFO)<<"fill node bins";
+
+                //the number of ancestors of each node
+                std::vector<uint> level(nodes.size(), 0);
+                uint max_depth = 0;
+                for(uint id = nodes.size(); id-- > 0;) {
+                    if(nodes[id].parent != NO_NODE) {
+                        level[id] = level[nodes[id].parent] + 1;
                     }
+                    max_depth = std::max(max_depth, nodes[id].depth);
+                }
+
+                //each bin lists its nodes in breadth first order
+                std::vector<uint> order(nodes.size());
+                for(uint id = 0; id < nodes.size(); id++) order[id] = id;
+                std::sort(order.begin(), order.end(), [&](uint a, uint b) {
+                    return std::make_pair(level[a], nodes[a].lb)
+                         < std::make_pair(level[b], nodes[b].lb);
+                });
+
+                bins.resize(max_depth + 1);
+                for(uint id : order) {
+                    bins[nodes[id].depth].push_back(id);
                 }
             });
-            node_begins.resize(node_counter);
 
             uint nts_number = 1 ;
             StatPhase::wrap("Iterate over Node Bins", [&]{
@@ -170,67 +256,27 @@ public:
                     while(!bins[i].empty()){
                         uint id = bins[i].back();
                         bins[i].pop_back();
-                        node_type node = stree.inv_id(id);
-                        uint no_leaf_id = id - stree.size();
-
-                        //get bps of node
-
-                        if(node_begins[no_leaf_id].empty()){
-                            //get leaves or merge child vectors
-                            std::vector<uint> offsets;
-                            std::vector<uint> leaf_bps;
-
-                            for (auto & child : stree.children(node)) {
-                                if(stree.is_leaf(child)){
-
-
-                                        leaf_bps.push_back(stree.csa[stree.lb(child)]);
-
-
-                                } else {
-                                    int child_id = stree.id(child) - stree.size();
-                                    if(!node_begins[child_id ].empty()){
-                                        //append child list, remember offset
-                                        offsets.push_back(node_begins[no_leaf_id].size());
-
-
-                                        node_begins[no_leaf_id].insert(node_begins[no_leaf_id].end(),node_begins[child_id ].begin(), node_begins[child_id].end());
+                        const Interval& node = nodes[id];
 
-                                        node_begins[child_id] = std::vector<uint>();
-
-                                    }
-                                }
-                            }
-                            std::sort(leaf_bps.begin(), leaf_bps.end());
-
-                            offsets.push_back(node_begins[no_leaf_id].size());
-                            node_begins[no_leaf_id].insert(node_begins[no_leaf_id].end(),leaf_bps.begin(), leaf_bps.end());
-
-                            //inplace merge with offset
-                            for(uint k = 0; k < offsets.size()-1; k++){
-                                std::inplace_merge(node_begins[no_leaf_id].begin(), node_begins[no_leaf_id].begin()+ offsets[k], node_begins[no_leaf_id].begin()+ offsets[k+1]);
-
-                            }
-                            //now inplace merge to end
-                            std::inplace_merge(node_begins[no_leaf_id].begin(), node_begins[no_leaf_id].begin()+ offsets.back(), node_begins[no_leaf_id].end());
-
-
-
-                        }
-                        //if still empty, because everything is substituted...
-                        if(node_begins[no_leaf_id].empty()){
-                            continue;
+                        //get bps of node, the children are already sorted
+                        if(!sorted[id]){
+                            sort_node(node);
+                            sorted[id] = 1;
                         }
+                        auto node_begin = positions.begin() + node.lb;
+                        auto node_end = positions.begin() + node.rb + 1;
+
                         //check if viable lrf, else sort higher!
-                        if((node_begins[no_leaf_id].size()>=2)){
+                        if((node_end - node_begin >= 2)){
 
-                            if (( (uint)( node_begins[no_leaf_id].back() - node_begins[no_leaf_id].front() )) >= i ){
+                            if (( (uint)( *(node_end - 1) - *node_begin )) >= i ){
 
                                 //greedily iterate over occurences
                                 signed long last =  0 - (long) i;
                                 std::vector<uint> first_layer_viable;
                                 std::vector<uint> second_layer_viable;
-                                for(uint occurence : node_begins[no_leaf_id]){
+                                for(auto it = node_begin; it != node_end; ++it){
+                                    const uint occurence = *it;
                                     //check for viability
                                     if( (last+i <= (long) occurence)){
                                         if(fl_offsets[occurence] == 0){
@@ -299,13 +345,12 @@ public:
                             } else {
                                 if(exact){
                                     //readd node if lrf shorter
-                                    uint min_shorter = node_begins[no_leaf_id].back()   - node_begins[no_leaf_id].front();
+                                    uint min_shorter = *(node_end - 1) - *node_begin;
                                     //check if parent subs this lrf
-                                    node_type parent = stree.parent(node);
-                                    uint depth = stree.depth(parent);
+                                    uint depth = nodes[node.parent].depth;
                                     if(depth < (min_shorter)){
                                         //just re-add node, if the possible replaceable lrf is longer than dpeth of parent node
-                                        bins[min_shorter].push_back(stree.id(node));
+                                        bins[min_shorter].push_back(id);
                                     }
 
 
@@ -320,6 +365,8 @@ public:
 
             });
 
+            nodes = std::vector<Interval>();
+            positions = std::vector<uint>();
         });
 
         DLOG(INFO)<<"Computing symbol depth";
@@ -3,9 +3,6 @@
 #include <vector>
 #include <tuple>
 
-#include <unordered_map>
-
-
 #include <tudocomp/util.hpp>
 #include <tudocomp/io.hpp>
 #include <tudocomp/ds/IntVector.hpp>
@@ -26,14 +23,20 @@ private:
     typedef std::vector<std::pair<uint,uint>> rules;
 
 
-    SuffixTree stree;
+    typedef SuffixTree::node_type node_type;
+
+    std::unique_ptr<SuffixTree> stree;
     uint min_lrf;
 
     BitVector dead_positions;
 
-    std::vector<std::vector<SuffixTree::STNode*> > bins;
+    std::vector<std::vector<node_type> > bins;
 
-        std::unordered_map<SuffixTree::STNode *, std::vector<uint> > beginning_positions;
+    //string depth, parent and starting positions of the inner nodes,
+    //indexed by node (the positions are empty until they are computed)
+    std::vector<std::vector<uint> > beginning_positions;
+    std::vector<uint> string_depth;
+    std::vector<node_type> parent;
 
     //stats
     uint node_count;
@@ -42,17 +45,16 @@ private:
 
 
 
-    inline virtual void compute_string_depth(SuffixTree::STNode* node, uint str_depth){
+    inline virtual void compute_string_depth(node_type node, uint str_depth){
         //resize if str depth grater than bins size
 
 
 
 
 
-        SuffixTree::STInnerNode * inner = dynamic_cast<SuffixTree::STInnerNode *>(node);
-        if(inner){
+        if(!stree->is_leaf(node)){
 
-            inner->string_depth = str_depth;
+            string_depth[node] = str_depth;
 
             if(str_depth>= bins.size()){
                 bins.resize(bins.size()*2);
@@ -70,18 +72,16 @@ private:
             }
 
 
-            auto it = inner->child_nodes.begin();
-            while (it != inner->child_nodes.end()){
-                auto child = *it;
+            node_type child = stree->get_first_child(node);
+            while (child != stree->get_root()){
 
-                SuffixTree::STInnerNode * child_inner = dynamic_cast<SuffixTree::STInnerNode *>(child.second);
-                if(child_inner){
-                    child_inner->parent = inner;
+                if(!stree->is_leaf(child)){
+                    parent[child] = node;
 
-                    uint child_depth = (str_depth+stree.edge_length(child.second));
-                    compute_string_depth( child.second, child_depth);
+                    uint child_depth = (str_depth+stree->get_edge_length(child));
+                    compute_string_depth(child, child_depth);
                 }
-                it++;
+                child = stree->get_next_sibling(child);
             }
 
         }
@@ -91,10 +91,10 @@ private:
 
 
 
-    inline virtual std::vector<uint> select_starting_positions(SuffixTree::STNode * node, uint length){
+    inline virtual std::vector<uint> select_starting_positions(node_type node, uint length){
 
 
-        std::vector<uint> starting_positions = beginning_positions[node];
+        const std::vector<uint>& starting_positions = beginning_positions[node];
         std::vector<uint> selected_starting_positions;
 
         long min_shorter = 1;
@@ -129,10 +129,7 @@ private:
 
             if(min_shorter >= (int) min_lrf){
                 //check if parent node is shorter
-                SuffixTree::STInnerNode * inner = dynamic_cast<SuffixTree::STInnerNode *>(node);
-
-                SuffixTree::STInnerNode * parent = inner->parent;
-                uint depth = parent->string_depth;
+                uint depth = string_depth[parent[node]];
                 if(depth < (uint)(min_shorter)){
 
                     //just re-add node, if the possible replaceable lrf is longer than dpeth of parent node
@@ -160,7 +157,7 @@ public:
         min_lrf = env().option("min_lrf").as_integer();
 
         StatPhase::wrap("Constructing ST", [&]{
-            stree = SuffixTree(input);
+            stree = std::make_unique<SuffixTree>(input);
         });
 
 
@@ -168,7 +165,9 @@ public:
             bins.resize(200);
             node_count=0;
             max_depth=0;
-            compute_string_depth(stree.get_root(),0);
+            string_depth.resize(stree->get_tree_size());
+            parent.resize(stree->get_tree_size());
+            compute_string_depth(stree->get_root(),0);
         });
 
         StatPhase::log("Number of inner Nodes", node_count);
@@ -178,10 +177,10 @@ public:
 
 
         StatPhase::wrap("Computing LRF Substitution", [&]{
-            dead_positions = BitVector(stree.get_size(), 0);
+            dead_positions = BitVector(stree->get_size(), 0);
             uint nts_number =0;
 
-            beginning_positions.reserve(node_count);
+            beginning_positions.resize(stree->get_tree_size());
 
             uint rd_counter =0;
 
@@ -191,45 +190,39 @@ public:
                 auto bin_it = bins[i].begin();
                 while (bin_it!= bins[i].end()){
 
-                    SuffixTree::STNode * node = *bin_it;
-
-                    auto bp = beginning_positions.find(node);
+                    node_type node = *bin_it;
 
                     //no begin poss found, get from children
 
-                    if(bp == beginning_positions.end()){
+                    if(beginning_positions[node].empty()){
 
                         std::vector<uint> positions;
 
-                        SuffixTree::STInnerNode * inner = dynamic_cast<SuffixTree::STInnerNode *>(node);
-                        auto it = inner->child_nodes.begin();
-                        while (it != inner->child_nodes.end()){
-                            auto child = *it;
-
-                            SuffixTree::STNode * child_node = child.second;
+                        node_type child_node = stree->get_first_child(node);
+                        while (child_node != stree->get_root()){
 
-                            if(SuffixTree::STInnerNode * inner_child = dynamic_cast<SuffixTree::STInnerNode *>(child_node)){
-                                auto child_bp = beginning_positions.find(inner_child);
-                                if(child_bp != beginning_positions.end()){
+                            if(!stree->is_leaf(child_node)){
+                                auto& child_bp = beginning_positions[child_node];
+                                if(!child_bp.empty()){
 
-                                    positions.insert(positions.end(), (*child_bp).second.begin(), (*child_bp).second.end());
+                                    positions.insert(positions.end(), child_bp.begin(), child_bp.end());
 
-                                    beginning_positions.erase((*child_bp).first);
+                                    child_bp = std::vector<uint>();
 
 
                                 }
 
 
                             }
-                            if(SuffixTree::STLeaf * leaf_child = dynamic_cast<SuffixTree::STLeaf *>(child_node)){
-                                positions.push_back(leaf_child->suffix);
+                            if(stree->is_leaf(child_node)){
+                                positions.push_back(stree->get_suffix(child_node));
 
                             }
 
 
 
 
-                            it++;
+                            child_node = stree->get_next_sibling(child_node);
                         }
                         std::sort(positions.begin(), positions.end());
 
@@ -239,7 +232,7 @@ public:
                             rd_counter++;
                         }
 
-                        beginning_positions[node]=positions;
+                        beginning_positions[node] = std::move(positions);
 
 
 
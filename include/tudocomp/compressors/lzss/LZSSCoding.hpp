@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 
+#include <tudocomp/Coder.hpp>
 #include <tudocomp/Range.hpp>
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
 #include <tudocomp/compressors/lzss/LZSSDecodeBackBuffer.hpp>
@@ -15,6 +17,10 @@
 namespace tdc {
 namespace lzss {
 
+/// Encodes the text given by its factors.
+///
+/// The literals between the factors are encoded in batches, hence the
+/// text has to provide a pointer to its characters via `text()`.
 template<typename coder_t, typename text_t, typename factor_t = FactorBuffer>
 inline void encode_text(coder_t& coder, const text_t& text, const factor_t& factors) {
     assert(factors.is_sorted());
@@ -29,10 +35,10 @@ inline void encode_text(coder_t& coder, const text_t& text, const factor_t& fact
     size_t fdist_max = 0;
     {
         size_t p = 0;
-        for(auto it = factors.begin(); it != factors.end(); ++it) {
-            const Factor& factor = *it;
-            fdist_max = std::max(fdist_max, factor.pos - p);
-            p = factor.pos + factor.len;
+        for(size_t i = 0; i < factors.size(); i++) {
+            const size_t fpos = factors.pos(i);
+            fdist_max = std::max(fdist_max, fpos - p);
+            p = fpos + factors.len(i);
         }
 
         fdist_max = std::max(fdist_max, n - p);
@@ -51,10 +57,12 @@ inline void encode_text(coder_t& coder, const text_t& text, const factor_t& fact
 
     // walk over factors
     size_t p = 0; //! current text position
-    for(auto it = factors.begin(); it != factors.end(); ++it) {
-        const Factor& factor = *it;
+    for(size_t i = 0; i < factors.size(); i++) {
+        const size_t fpos = factors.pos(i);
+        const size_t fsrc = factors.src(i);
+        const size_t flen = factors.len(i);
 
-        if(factor.pos == p) {
+        if(fpos == p) {
             // cursor reached factor i, encode 0-bit
             coder.encode(false, bit_r);
         } else {
@@ -62,22 +70,21 @@ inline void encode_text(coder_t& coder, const text_t& text, const factor_t& fact
             coder.encode(true, bit_r);
 
             // also encode amount of literals until factor i
-            DCHECK_LE(p, factor.pos);
-            DCHECK_LE(factor.pos - p, fdist_max); //distance cannot be larger than maximum distance
-            coder.encode(factor.pos - p, fdist_r);
+            DCHECK_LE(p, fpos);
+            DCHECK_LE(fpos - p, fdist_max); //distance cannot be larger than maximum distance
+            coder.encode(fpos - p, fdist_r);
         }
 
         // encode literals until cursor reaches factor i
-        while(p < factor.pos) {
-            coder.encode(text[p++], literal_r);
-        }
+        encode_batch(coder, text.text() + p, fpos - p, literal_r);
+        p = fpos;
 
         // encode factor
-        DCHECK_LT(factor.src + factor.len, n);
-        coder.encode(factor.src, text_r);
-        coder.encode(factor.len, flen_r);
+        DCHECK_LT(fsrc + flen, n);
+        coder.encode(fsrc, text_r);
+        coder.encode(flen, flen_r);
 
-        p += size_t(factor.len);
+        p += flen;
     }
 
     if(p < n) {
@@ -85,9 +92,19 @@ inline void encode_text(coder_t& coder, const text_t& text, const factor_t& fact
         coder.encode(n - p, fdist_r);
     }
 
-    while(p < n)  {
-        // encode symbol
-        coder.encode(text[p++], literal_r);
+    // encode remaining literals
+    encode_batch(coder, text.text() + p, n - p, literal_r);
+}
+
+/// Decodes `num` literals into the given decode buffer.
+template<typename coder_t, typename decode_buffer_t>
+inline void decode_literals(coder_t& decoder, decode_buffer_t& buffer, len_t num) {
+    uliteral_t chunk[1024];
+    while(num) {
+        const len_t k = std::min(num, len_t(sizeof(chunk)));
+        decode_batch(decoder, chunk, k, literal_r);
+        for(len_t i = 0; i < k; ++i) buffer.decode_literal(chunk[i]);
+        num -= k;
     }
 }
 
@@ -106,8 +123,8 @@ inline void decode_text(coder_t& decoder, std::ostream& outs) {
     auto fdist_max = decoder.template decode<len_t>(text_r);
     Range fdist_r(fdist_max);
 
-    // init decode buffer
-    decode_buffer_t buffer(text_len);
+    // init decode buffer, which writes the decoded prefix to the output
+    decode_buffer_t buffer(text_len, outs);
 
     // decode
     while(!decoder.eof()) {
@@ -118,10 +135,7 @@ inline void decode_text(coder_t& decoder, std::ostream& outs) {
         else  num = 0;
 
         // decode characters
-        while(num--) {
-            auto c = decoder.template decode<uliteral_t>(literal_r);
-            buffer.decode_literal(c);
-        }
+        decode_literals(decoder, buffer, num);
 
         if(!decoder.eof()) {
             //decode factor
@@ -135,7 +149,7 @@ inline void decode_text(coder_t& decoder, std::ostream& outs) {
     // log stats
     StatPhase::log("longest_chain", buffer.longest_chain());
 
-    // write decoded text
+    // write the rest of the decoded text
     buffer.write_to(outs);
 }
 
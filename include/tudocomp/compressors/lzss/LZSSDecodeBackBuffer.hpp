@@ -3,38 +3,80 @@
 #include <ostream>
 #include <vector>
 #include <tudocomp/def.hpp>
+#include <tudocomp/util/LZCopy.hpp>
 
 namespace tdc {
 namespace lzss {
 
+/// Decodes a text whose factors only refer to preceding positions.
+///
+/// If constructed with an output stream, the decoded prefix is written to it
+/// in blocks of \ref flush_block_size characters while decoding continues.
+/// Since later factors may refer to any preceding position, the buffer still
+/// keeps the whole text.
 class DecodeBackBuffer{
 
+public:
+    /// The amount of decoded characters written to the output at once.
+    static constexpr size_t flush_block_size = 1ULL << 20;
+
 private:
     std::vector<uliteral_t> m_buffer;
     len_t m_cursor;
 
+    std::ostream* m_out;
+    len_t m_flushed;
+
+    inline void flush(len_t end) {
+        write_block(*m_out, m_buffer.data() + m_flushed, end - m_flushed);
+        m_flushed = end;
+    }
+
+    inline void advance(len_t num) {
+        m_cursor += num;
+        if(m_out && m_cursor - m_flushed >= flush_block_size) {
+            flush(m_cursor);
+        }
+    }
+
 public:
 
     inline DecodeBackBuffer(len_t size)
-		: m_cursor(0)
+		: m_cursor(0), m_out(nullptr), m_flushed(0)
     {
         m_buffer.resize(size, 0);
     }
 
+    /// Constructs a buffer that writes the decoded prefix to `out`.
+    ///
+    /// \ref write_to has to be called with the same stream after decoding.
+    inline DecodeBackBuffer(len_t size, std::ostream& out)
+        : DecodeBackBuffer(size)
+    {
+        m_out = &out;
+    }
+
     inline void decode_literal(uliteral_t c) {
-        m_buffer[m_cursor++] = c;
+        m_buffer[m_cursor] = c;
+        advance(1);
     }
 
     inline void decode_factor(len_t pos, len_t num) {
-        while(num--) m_buffer[m_cursor++] = m_buffer[pos++];
+        DCHECK_LT(pos, m_cursor);
+        DCHECK_LE(m_cursor + num, m_buffer.size());
+        lz_copy(m_buffer.data() + m_cursor, m_buffer.data() + pos, num);
+        advance(num);
     }
 
     inline len_t longest_chain() const {
         return 0;
     }
 
+    /// Writes the part of the text not yet written to the output.
     inline void write_to(std::ostream& out) {
-        for(auto c : m_buffer) out << c;
+        DCHECK(m_out == nullptr || m_out == &out);
+        m_out = &out;
+        flush(m_buffer.size());
     }
 };
 
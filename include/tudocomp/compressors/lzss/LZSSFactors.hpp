@@ -1,10 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <vector>
 #include <tudocomp/def.hpp>
 
 #include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/util/Parallel.hpp>
 #include <tudocomp_stat/StatPhase.hpp>
 
 namespace tdc {
@@ -20,16 +22,71 @@ public:
 }  __attribute__((__packed__));
 
 
+/// Stores factors in a structure-of-arrays layout, ie., the target
+/// positions, source positions and lengths are kept in three separate
+/// arrays.
+///
+/// This allows sorting factors by target position with a radix sort
+/// and lets encoders read each array sequentially.
 class FactorBuffer {
 private:
-    std::vector<Factor> m_factors;
+    /// Amount of bits sorted per radix sort pass.
+    static constexpr size_t RADIX_BITS = 11;
+    static constexpr size_t RADIX = size_t(1) << RADIX_BITS;
+
+    /// Minimum amount of factors per thread for parallel processing.
+    static constexpr size_t MIN_PER_THREAD = 1ULL << 16;
+
+    std::vector<len_compact_t> m_pos;
+    std::vector<len_compact_t> m_src;
+    std::vector<len_compact_t> m_len;
     bool m_sorted; //! factors need to be sorted before they are output
 
     len_t m_shortest_factor;
     len_t m_longest_factor;
 
 public:
-    using const_iterator = std::vector<Factor>::const_iterator;
+    /// Random access iterator yielding \ref Factor values.
+    class const_iterator {
+        const FactorBuffer* m_buf;
+        size_t m_i;
+
+        struct Pointer {
+            Factor f;
+            inline const Factor* operator->() const { return &f; }
+        };
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Factor;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Pointer;
+        using reference = Factor;
+
+        inline const_iterator(const FactorBuffer* buf, size_t i)
+            : m_buf(buf), m_i(i) {
+        }
+
+        inline Factor operator*() const { return (*m_buf)[m_i]; }
+        inline Pointer operator->() const { return Pointer { **this }; }
+        inline Factor operator[](difference_type d) const { return (*m_buf)[m_i + d]; }
+
+        inline const_iterator& operator++() { ++m_i; return *this; }
+        inline const_iterator& operator--() { --m_i; return *this; }
+        inline const_iterator operator++(int) { auto r = *this; ++m_i; return r; }
+        inline const_iterator operator--(int) { auto r = *this; --m_i; return r; }
+        inline const_iterator& operator+=(difference_type d) { m_i += d; return *this; }
+        inline const_iterator& operator-=(difference_type d) { m_i -= d; return *this; }
+        inline const_iterator operator+(difference_type d) const { return const_iterator(m_buf, m_i + d); }
+        inline const_iterator operator-(difference_type d) const { return const_iterator(m_buf, m_i - d); }
+        inline difference_type operator-(const const_iterator& o) const { return difference_type(m_i) - difference_type(o.m_i); }
+
+        inline bool operator==(const const_iterator& o) const { return m_i == o.m_i; }
+        inline bool operator!=(const const_iterator& o) const { return m_i != o.m_i; }
+        inline bool operator<(const const_iterator& o) const { return m_i < o.m_i; }
+        inline bool operator>(const const_iterator& o) const { return m_i > o.m_i; }
+        inline bool operator<=(const const_iterator& o) const { return m_i <= o.m_i; }
+        inline bool operator>=(const const_iterator& o) const { return m_i >= o.m_i; }
+    };
 
     inline FactorBuffer()
         : m_sorted(true)
@@ -39,76 +96,170 @@ public:
     }
 
     inline void emplace_back(len_t fpos, len_t fsrc, len_t flen) {
-        m_sorted = m_sorted && (m_factors.empty() || fpos >= m_factors.back().pos);
-        m_factors.emplace_back(fpos, fsrc, flen);
+        m_sorted = m_sorted && (m_pos.empty() || fpos >= m_pos.back());
+        m_pos.push_back(fpos);
+        m_src.push_back(fsrc);
+        m_len.push_back(flen);
 
         m_shortest_factor = std::min(m_shortest_factor, flen);
         m_longest_factor = std::max(m_longest_factor, flen);
     }
 
     inline const_iterator begin() const {
-        return m_factors.cbegin();
+        return const_iterator(this, 0);
     }
 
     inline const_iterator end() const {
-        return m_factors.cend();
+        return const_iterator(this, size());
     }
 
+    inline Factor operator[](size_t i) const {
+        return Factor(m_pos[i], m_src[i], m_len[i]);
+    }
+
+    /// The target position of the i-th factor.
+    inline len_t pos(size_t i) const { return m_pos[i]; }
+
+    /// The source position of the i-th factor.
+    inline len_t src(size_t i) const { return m_src[i]; }
+
+    /// The length of the i-th factor.
+    inline len_t len(size_t i) const { return m_len[i]; }
+
     inline bool empty() const {
-        return m_factors.empty();
+        return m_pos.empty();
     }
 
     inline size_t size() const {
-        return m_factors.size();
+        return m_pos.size();
     }
 
     inline bool is_sorted() const {
         return m_sorted;
     }
 
-    inline void sort() { //TODO: use radix sort
+private:
+    /// One stable LSD radix sort pass over the target positions,
+    /// moving all three arrays into the given buffers.
+    ///
+    /// Every thread counts the digits of one chunk of factors and then
+    /// scatters that chunk to its precomputed output offsets.
+    inline void radix_pass(
+        size_t shift,
+        size_t threads,
+        std::vector<len_compact_t>& pos_out,
+        std::vector<len_compact_t>& src_out,
+        std::vector<len_compact_t>& len_out) const {
+
+        const size_t n = size();
+        std::vector<size_t> offsets(threads * RADIX, 0);
+
+        #pragma omp parallel num_threads(threads)
+        {
+            // the team may be smaller than requested
+            const size_t team = num_threads();
+            const size_t chunk = (n + team - 1) / team;
+
+            const size_t t = thread_num();
+            const size_t begin = std::min(n, t * chunk);
+            const size_t end = std::min(n, begin + chunk);
+            size_t* const local = offsets.data() + t * RADIX;
+
+            for(size_t i = begin; i < end; i++) {
+                ++local[(size_t(m_pos[i]) >> shift) & (RADIX - 1)];
+            }
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                // exclusive prefix sum in (digit, thread) order
+                size_t sum = 0;
+                for(size_t d = 0; d < RADIX; d++) {
+                    for(size_t u = 0; u < team; u++) {
+                        const size_t c = offsets[u * RADIX + d];
+                        offsets[u * RADIX + d] = sum;
+                        sum += c;
+                    }
+                }
+            }
+
+            for(size_t i = begin; i < end; i++) {
+                const size_t j = local[(size_t(m_pos[i]) >> shift) & (RADIX - 1)]++;
+                pos_out[j] = m_pos[i];
+                src_out[j] = m_src[i];
+                len_out[j] = m_len[i];
+            }
+        }
+    }
+
+public:
+    /// Sorts the factors by their target position using an LSD radix sort.
+    ///
+    /// Large buffers are sorted in parallel if OpenMP is available.
+    inline void sort() {
         if(!m_sorted) {
-            std::sort(m_factors.begin(), m_factors.end(),
-                [](const Factor& a, const Factor& b) -> bool { return a.pos < b.pos; });
+            const size_t n = size();
+            const size_t threads = threads_for(n, MIN_PER_THREAD);
+
+            const size_t max_pos = *std::max_element(m_pos.begin(), m_pos.end());
+            const size_t bits = bits_for(max_pos);
+
+            std::vector<len_compact_t> pos_out(n);
+            std::vector<len_compact_t> src_out(n);
+            std::vector<len_compact_t> len_out(n);
+
+            for(size_t shift = 0; shift < bits; shift += RADIX_BITS) {
+                radix_pass(shift, threads, pos_out, src_out, len_out);
+                std::swap(m_pos, pos_out);
+                std::swap(m_src, src_out);
+                std::swap(m_len, len_out);
+            }
 
             m_sorted = true;
         }
     }
 
-public:
+    /// Redirects factor sources that point into another factor to the
+    /// source of that factor, as long as the referred factor covers the
+    /// complete range.
+    ///
+    /// Each factor is resolved against the unflattened sources of the
+    /// others, so the result does not depend on the amount of threads.
     inline void flatten() {
-        if(m_factors.empty()) return; //nothing to do
+        if(m_pos.empty()) return; //nothing to do
 
         CHECK(m_sorted)
             << "factors need to be sorted before they can be flattened";
 
-        // create pos -> factor map
-        auto& last = m_factors.back();
-        DynamicIntVector fmap(
-            last.pos + last.len,
-            0,
-            bits_for(m_factors.size() + 1));
-
-        for(size_t i = 0; i < m_factors.size(); i++) {
-            auto& f = m_factors[i];
-            for(size_t j = 0; j < f.len; j++) {
-                fmap[f.pos + j] = i + 1;
-            }
-        }
+        const size_t n = size();
+        const size_t threads = threads_for(n, MIN_PER_THREAD);
+
+        std::vector<len_compact_t> flat_src(n);
 
-        // process factors
         size_t num_flattened = 0;
         size_t max_depth = 0;
-        for(auto& f : m_factors) {
+
+        #pragma omp parallel for num_threads(threads) schedule(dynamic, 4096) \
+            reduction(+:num_flattened) reduction(max:max_depth)
+        for(size_t i = 0; i < n; i++) {
+            const size_t fpos = m_pos[i];
+            const size_t flen = m_len[i];
+
             size_t depth = 0;
+            size_t src = m_src[i];
+            while(true) {
+                // find the factor covering src, if any
+                auto it = std::upper_bound(m_pos.begin(), m_pos.end(), src);
+                if(it == m_pos.begin()) break;
 
-            size_t src = f.src;
-            while(src < fmap.size() && fmap[src]) {
-                auto& s = m_factors[fmap[src] - 1];
+                const size_t k = (it - m_pos.begin()) - 1;
+                const size_t d = src - m_pos[k];
+                const size_t next = m_src[k] + d;
+                if(d + flen <= m_len[k] &&
+                    // a factor must not end up referring to itself
+                    (next + flen <= fpos || next >= fpos + flen)) {
 
-                size_t d = src - s.pos;
-                if((s.src + d + f.len) <= (s.src + s.len)) {
-                    src = s.src + d;
+                    src = next;
 
                     //FIXME: actually, one would have to add the flatten
                     //       depth of the referred factors recursively,
@@ -118,15 +269,16 @@ public:
                     break;
                 }
             }
-            
-            if(depth) {
-                f.src = src;
 
+            flat_src[i] = src;
+            if(depth) {
                 ++num_flattened;
                 max_depth = std::max(max_depth, depth);
             }
         }
 
+        m_src = std::move(flat_src);
+
         StatPhase::log("num_flattened", num_flattened);
         StatPhase::log("max_depth_lb", max_depth);
     }
@@ -142,4 +294,3 @@ public:
 };
 
 }} //ns
-
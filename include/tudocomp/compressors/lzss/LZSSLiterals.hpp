@@ -13,14 +13,14 @@ private:
     const text_t* m_text;
     const FactorBuffer* m_factors;
     len_t m_pos;
-    FactorBuffer::const_iterator m_next_factor;
+    size_t m_next_factor;
 
     inline void skip_factors() {
         while(
-            m_next_factor != m_factors->end() &&
-            m_pos == m_next_factor->pos) {
+            m_next_factor < m_factors->size() &&
+            m_pos == m_factors->pos(m_next_factor)) {
 
-            m_pos += len_t(m_next_factor->len);
+            m_pos += m_factors->len(m_next_factor);
             ++m_next_factor;
         }
     }
@@ -30,7 +30,7 @@ public:
         : m_text(&text),
           m_factors(&factors),
           m_pos(0),
-          m_next_factor(m_factors->begin()) {
+          m_next_factor(0) {
 
         skip_factors();
     }
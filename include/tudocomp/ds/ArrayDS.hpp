@@ -11,6 +11,11 @@ public:
     /// \brief The type of integer array to use as storage.
     using iv_t = DynamicIntVector;
 
+    /// \brief The amount of elements to process at once when reading or
+    ///        writing the storage sequentially through \ref unpack and
+    ///        \ref pack.
+    static constexpr size_t ARRAY_CHUNK = 1024;
+
 protected:
     IF_DEBUG(
         /// Debug check to ensure the vector has not been moved out.
@@ -23,6 +28,19 @@ protected:
         )
     }
 
+    /// \brief Creates a storage of `n` zeros of width `w`.
+    ///
+    /// If `disk` is set, the storage is backed by a temporary file in the
+    /// directory `dir`, see \ref IntVector::disk_backed.
+    inline static iv_t new_array(size_t n, uint8_t w, bool disk,
+                                 const std::string& dir = "") {
+        iv_t iv;
+        iv.disk_backed(disk, dir);
+        iv.reserve(n, w);
+        iv.resize(n, 0, w);
+        return iv;
+    }
+
     inline void set_array(iv_t&& iv) {
         (iv_t&)(*this) = std::move(iv);
         IF_DEBUG(m_is_initialized = true;)
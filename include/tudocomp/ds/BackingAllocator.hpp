@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include <sys/mman.h>
+
+#include <tudocomp/io/TempFile.hpp>
+#include <tudocomp/util/HugePages.hpp>
+
+#include <glog/logging.h>
+
+namespace tdc {
+namespace int_vector {
+
+/// Allocates the storage of bit-packed integer vectors either on the heap
+/// or in a memory-mapped temporary file.
+///
+/// A file-backed storage is a shared mapping of an unlinked
+/// \ref io::TempFile in a given directory. The kernel may write its pages back to the file and
+/// evict them under memory pressure, so the storage is not bounded by RAM.
+/// The file is released as soon as the storage is deallocated.
+///
+/// Large heap storages are backed by huge pages according to the
+/// \ref huge_pages::global_policy at the time the allocator is created.
+///
+/// The allocator is propagated on copies, moves and swaps, hence a copy of
+/// a file-backed vector is file-backed as well.
+template<typename T>
+class BackingAllocator {
+    bool m_disk;
+    std::string m_dir;
+    huge_pages::Policy m_huge;
+
+    inline static size_t bytes(size_t n) {
+        return std::max(n * sizeof(T), size_t(1));
+    }
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /// Creates an allocator that allocates in a temporary file in the
+    /// directory `dir` if `disk` is set, and on the heap otherwise.
+    ///
+    /// If `dir` is empty, `$TMPDIR` or `/tmp` is used.
+    inline BackingAllocator(bool disk = false, const std::string& dir = ""):
+        m_disk(disk), m_dir(dir), m_huge(huge_pages::global_policy()) {}
+
+    template<typename U>
+    inline BackingAllocator(const BackingAllocator<U>& other):
+        m_disk(other.disk()), m_dir(other.dir()), m_huge(other.huge_policy()) {}
+
+    /// Whether the storage is allocated in a temporary file.
+    inline bool disk() const {
+        return m_disk;
+    }
+
+    /// The directory of the temporary files.
+    inline const std::string& dir() const {
+        return m_dir;
+    }
+
+    /// The huge page policy for heap storages.
+    inline huge_pages::Policy huge_policy() const {
+        return m_huge;
+    }
+
+    inline T* allocate(size_t n) {
+        if(!m_disk) {
+            return static_cast<T*>(huge_pages::allocate(n * sizeof(T), m_huge));
+        }
+
+        // the mapping keeps the (unlinked) file alive after it is closed
+        io::TempFile file(m_dir);
+        file.resize(bytes(n));
+
+        void* ptr = mmap(nullptr, bytes(n), PROT_READ | PROT_WRITE,
+                         MAP_SHARED, file.fd(), 0);
+        if(ptr == MAP_FAILED) {
+            perror("BackingAllocator error");
+        }
+        CHECK(ptr != MAP_FAILED) << "Error at mapping temporary file";
+        return static_cast<T*>(ptr);
+    }
+
+    inline void deallocate(T* ptr, size_t n) {
+        if(!m_disk) {
+            huge_pages::deallocate(ptr, n * sizeof(T), m_huge);
+        } else {
+            munmap(ptr, bytes(n));
+        }
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const BackingAllocator<T>& a, const BackingAllocator<U>& b) {
+    return a.disk() == b.disk() && a.dir() == b.dir()
+        && a.huge_policy() == b.huge_policy();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const BackingAllocator<T>& a, const BackingAllocator<U>& b) {
+    return !(a == b);
+}
+
+}}
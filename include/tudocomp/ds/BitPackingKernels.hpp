@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__BMI2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <glog/logging.h>
+
+/// \cond INTERNAL
+
+namespace tdc {
+namespace int_vector {
+
+/// Bulk conversion between bit-packed integer arrays and native arrays.
+///
+/// The packed layout is the one of \ref BitPackingVector: elements are
+/// stored back to back starting at the least significant bit of each
+/// 64-bit word, and may span two words.
+///
+/// Each operation has a portable scalar variant. If the compiler targets
+/// BMI2 or AVX2 (e.g., with `-march=native`), \ref unpack and \ref pack
+/// dispatch to vectorized variants for the widths they support, and so
+/// does \ref change_width, which is built on top of them.
+/// All variants are exposed such that they can be benchmarked
+/// against each other.
+namespace kernels {
+
+    inline uint64_t low_bits(uint8_t w) {
+        return (w >= 64) ? ~uint64_t(0) : ((uint64_t(1) << w) - 1);
+    }
+
+    /// Reads consecutive bit strings of up to 64 bits.
+    class BitReader {
+        const uint64_t* m_ptr;
+        uint8_t m_offset;
+    public:
+        inline BitReader(const uint64_t* data, uint64_t bit_pos):
+            m_ptr(data + (bit_pos >> 6)), m_offset(bit_pos & 63) {}
+
+        /// Reads the next `len` bits, \f$0 < len \leq 64\f$.
+        /// The returned value is not masked if `len < 64`.
+        inline uint64_t read_unmasked(uint8_t len) {
+            uint64_t v = m_ptr[0] >> m_offset;
+            const size_t end = size_t(m_offset) + len;
+            if(end > 64) v |= m_ptr[1] << (64 - m_offset);
+            m_ptr += end >> 6;
+            m_offset = end & 63;
+            return v;
+        }
+
+        inline uint64_t read(uint8_t len) {
+            return read_unmasked(len) & low_bits(len);
+        }
+    };
+
+    /// Writes consecutive bit strings of up to 64 bits.
+    ///
+    /// Whole words are written only once they are complete. The bits in front
+    /// of the start position and behind the end position are kept.
+    /// \ref flush must be called before the written range is read.
+    class BitWriter {
+        uint64_t* m_ptr;
+        uint8_t m_offset;
+        uint64_t m_acc;
+    public:
+        inline BitWriter(uint64_t* data, uint64_t bit_pos):
+            m_ptr(data + (bit_pos >> 6)), m_offset(bit_pos & 63),
+            m_acc(m_offset ? (m_ptr[0] & low_bits(m_offset)) : 0) {}
+
+        /// Appends the `len` lowest bits of `v`, \f$0 < len \leq 64\f$.
+        /// The other bits of `v` must be zero.
+        inline void write(uint64_t v, uint8_t len) {
+            DCHECK_EQ(v & ~low_bits(len), 0u);
+            m_acc |= v << m_offset;
+            const size_t end = size_t(m_offset) + len;
+            if(end >= 64) {
+                *m_ptr++ = m_acc;
+                m_acc = m_offset ? (v >> (64 - m_offset)) : 0;
+            }
+            m_offset = end & 63;
+        }
+
+        inline void flush() {
+            if(m_offset) {
+                *m_ptr = (*m_ptr & ~low_bits(m_offset)) | m_acc;
+            }
+        }
+    };
+
+    /// Scalar variant of \ref unpack.
+    template<typename U>
+    inline void unpack_scalar(const uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, U* out) {
+        if(w == 0) {
+            std::fill(out, out + n, U(0));
+            return;
+        }
+        if(w == 64 && (bit_pos & 63) == 0) {
+            std::copy(data + (bit_pos >> 6), data + (bit_pos >> 6) + n, out);
+            return;
+        }
+        BitReader r(data, bit_pos);
+        for(size_t i = 0; i < n; ++i) {
+            out[i] = U(r.read(w));
+        }
+    }
+
+    /// Scalar variant of \ref pack.
+    template<typename U>
+    inline void pack_scalar(uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, const U* in) {
+        if(w == 0) return;
+        if(w == 64 && (bit_pos & 63) == 0) {
+            std::copy(in, in + n, data + (bit_pos >> 6));
+            return;
+        }
+        const uint64_t mask = low_bits(w);
+        BitWriter wr(data, bit_pos);
+        for(size_t i = 0; i < n; ++i) {
+            wr.write(uint64_t(in[i]) & mask, w);
+        }
+        wr.flush();
+    }
+
+#ifdef __BMI2__
+    /// Amount of elements of width `w` processed by one `pdep` or `pext`
+    /// in the BMI2 variants: 8 lanes of 8 bits or 4 lanes of 16 bits.
+    inline size_t bmi2_lanes(uint8_t w) {
+        return (w <= 8) ? 8 : 4;
+    }
+
+    inline uint64_t bmi2_lane_mask(uint8_t w) {
+        return (w <= 8)
+            ? low_bits(w) * 0x0101010101010101ULL
+            : low_bits(w) * 0x0001000100010001ULL;
+    }
+
+    /// BMI2 variant of \ref unpack for widths up to 16.
+    ///
+    /// Distributes the bits of 8 (resp. 4) elements to byte (resp. 16-bit)
+    /// lanes of a word with a single `pdep`.
+    template<typename U>
+    inline void unpack_bmi2(const uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, U* out) {
+        if(w == 0 || w > 16) {
+            unpack_scalar(data, bit_pos, w, n, out);
+            return;
+        }
+
+        const size_t lanes = bmi2_lanes(w);
+        const uint8_t lane_bits = 64 / lanes;
+        const uint64_t lane_mask = bmi2_lane_mask(w);
+        const uint64_t lane_low = low_bits(lane_bits);
+
+        BitReader r(data, bit_pos);
+        size_t i = 0;
+        for(; i + lanes <= n; i += lanes) {
+            const uint64_t x = _pdep_u64(r.read_unmasked(w * lanes), lane_mask);
+            for(size_t j = 0; j < lanes; ++j) {
+                out[i + j] = U((x >> (j * lane_bits)) & lane_low);
+            }
+        }
+        for(; i < n; ++i) {
+            out[i] = U(r.read(w));
+        }
+    }
+
+    /// BMI2 variant of \ref pack for widths up to 16.
+    ///
+    /// Compacts 8 (resp. 4) elements stored in byte (resp. 16-bit) lanes
+    /// of a word with a single `pext`.
+    template<typename U>
+    inline void pack_bmi2(uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, const U* in) {
+        if(w == 0 || w > 16) {
+            pack_scalar(data, bit_pos, w, n, in);
+            return;
+        }
+
+        const size_t lanes = bmi2_lanes(w);
+        const uint8_t lane_bits = 64 / lanes;
+        const uint64_t lane_mask = bmi2_lane_mask(w);
+        const uint64_t lane_low = low_bits(lane_bits);
+        const uint64_t mask = low_bits(w);
+
+        BitWriter wr(data, bit_pos);
+        size_t i = 0;
+        for(; i + lanes <= n; i += lanes) {
+            uint64_t x = 0;
+            for(size_t j = 0; j < lanes; ++j) {
+                x |= (uint64_t(in[i + j]) & lane_low) << (j * lane_bits);
+            }
+            wr.write(_pext_u64(x, lane_mask), w * lanes);
+        }
+        for(; i < n; ++i) {
+            wr.write(uint64_t(in[i]) & mask, w);
+        }
+        wr.flush();
+    }
+#endif
+
+#ifdef __AVX2__
+    /// AVX2 variant of \ref unpack into 64-bit integers for widths up to 56.
+    ///
+    /// Each of the four lanes gathers the eight bytes the element starts in
+    /// and shifts the element to the lowest bits.
+    inline void unpack_avx2(const uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, uint64_t* out) {
+        if(w == 0 || w > 56 || n == 0) {
+            unpack_scalar(data, bit_pos, w, n, out);
+            return;
+        }
+
+        // gathers must not read behind the word holding the last element
+        const uint64_t end_bits = (((bit_pos + uint64_t(n) * w - 1) >> 6) + 1) * 64;
+        size_t safe = 0;
+        if(end_bits >= bit_pos + 64) {
+            safe = std::min<size_t>(n, (end_bits - 64 - bit_pos) / w + 1);
+        }
+
+        const long long* bytes = reinterpret_cast<const long long*>(data);
+        const __m256i mask = _mm256_set1_epi64x(low_bits(w));
+        const __m256i seven = _mm256_set1_epi64x(7);
+        const __m256i lane = _mm256_set_epi64x(3 * w, 2 * w, w, 0);
+
+        size_t i = 0;
+        for(; i + 4 <= safe; i += 4) {
+            const __m256i pos = _mm256_add_epi64(_mm256_set1_epi64x(bit_pos + uint64_t(i) * w), lane);
+            const __m256i x = _mm256_i64gather_epi64(bytes, _mm256_srli_epi64(pos, 3), 1);
+            const __m256i v = _mm256_and_si256(_mm256_srlv_epi64(x, _mm256_and_si256(pos, seven)), mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+        }
+        unpack_scalar(data, bit_pos + uint64_t(i) * w, w, n - i, out + i);
+    }
+
+    /// AVX2 variant of \ref pack from 64-bit integers for widths up to 32.
+    ///
+    /// Each pair of lanes shifts its second element next to the first one,
+    /// so two elements are written to the output at once.
+    inline void pack_avx2(uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, const uint64_t* in) {
+        if(w == 0 || w > 32) {
+            pack_scalar(data, bit_pos, w, n, in);
+            return;
+        }
+
+        const __m256i mask = _mm256_set1_epi64x(low_bits(w));
+        const __m256i shift = _mm256_set_epi64x(w, 0, w, 0);
+        const uint8_t pair = 2 * w;
+
+        BitWriter wr(data, bit_pos);
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4) {
+            const __m256i x = _mm256_and_si256(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), mask);
+            const __m256i y = _mm256_sllv_epi64(x, shift);
+            // swap the 64-bit halves of each 128-bit lane and combine
+            const __m256i z = _mm256_or_si256(y, _mm256_shuffle_epi32(y, 0x4E));
+            wr.write(uint64_t(_mm256_extract_epi64(z, 0)), pair);
+            wr.write(uint64_t(_mm256_extract_epi64(z, 2)), pair);
+        }
+        const uint64_t m = low_bits(w);
+        for(; i < n; ++i) {
+            wr.write(in[i] & m, w);
+        }
+        wr.flush();
+    }
+#endif
+
+    /// Unpacks `n` elements of width `w` starting at bit `bit_pos` of `data`
+    /// into the native array `out`.
+    template<typename U>
+    inline void unpack(const uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, U* out) {
+#ifdef __BMI2__
+        if(w <= 16) {
+            unpack_bmi2(data, bit_pos, w, n, out);
+            return;
+        }
+#endif
+        unpack_scalar(data, bit_pos, w, n, out);
+    }
+
+#ifdef __AVX2__
+    inline void unpack(const uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, uint64_t* out) {
+#ifdef __BMI2__
+        // for wider elements, the gather is faster than 4 lanes of pdep
+        if(w <= 8) {
+            unpack_bmi2(data, bit_pos, w, n, out);
+            return;
+        }
+#endif
+        unpack_avx2(data, bit_pos, w, n, out);
+    }
+#endif
+
+    /// Packs the `n` values of the native array `in` as elements of width `w`
+    /// starting at bit `bit_pos` of `data`.
+    ///
+    /// The values are truncated to `w` bits. Bits outside of the written
+    /// range are kept.
+    template<typename U>
+    inline void pack(uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, const U* in) {
+#ifdef __BMI2__
+        pack_bmi2(data, bit_pos, w, n, in);
+#else
+        pack_scalar(data, bit_pos, w, n, in);
+#endif
+    }
+
+#ifdef __AVX2__
+    inline void pack(uint64_t* data, uint64_t bit_pos, uint8_t w, size_t n, const uint64_t* in) {
+#ifdef __BMI2__
+        // for wider elements, pairs of lanes are faster than 4 lanes of pext
+        if(w <= 8) {
+            pack_bmi2(data, bit_pos, w, n, in);
+            return;
+        }
+#endif
+        pack_avx2(data, bit_pos, w, n, in);
+    }
+#endif
+
+    /// Amount of elements moved at once by \ref change_width.
+    constexpr size_t WIDTH_CHUNK = 256;
+
+    /// Changes the width of the `n` elements stored at the beginning of
+    /// `data` from `old_w` to `new_w` in place.
+    ///
+    /// The elements are moved in chunks through \ref unpack and \ref pack.
+    /// When shrinking, the chunks are moved front to back, and when growing,
+    /// back to front, such that no chunk overwrites elements not moved yet.
+    /// Values are truncated to `new_w` bits. If the width grows, `data` must
+    /// hold `n * new_w` bits.
+    inline void change_width(uint64_t* data, uint8_t old_w, uint8_t new_w, size_t n) {
+        if(old_w == new_w || n == 0) return;
+
+        uint64_t buf[WIDTH_CHUNK];
+        if(new_w < old_w) {
+            for(size_t b = 0; b < n; b += WIDTH_CHUNK) {
+                const size_t len = std::min(WIDTH_CHUNK, n - b);
+                unpack(data, uint64_t(b) * old_w, old_w, len, buf);
+                pack(data, uint64_t(b) * new_w, new_w, len, buf);
+            }
+        } else {
+            for(size_t e = n; e > 0;) {
+                const size_t len = std::min(WIDTH_CHUNK, e);
+                const size_t b = e - len;
+                unpack(data, uint64_t(b) * old_w, old_w, len, buf);
+                pack(data, uint64_t(b) * new_w, new_w, len, buf);
+                e = b;
+            }
+        }
+    }
+
+}}} //ns
+
+/// \endcond
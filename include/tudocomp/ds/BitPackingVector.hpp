@@ -17,6 +17,7 @@
 
 #include <tudocomp/ds/IntRepr.hpp>
 #include <tudocomp/ds/IntPtr.hpp>
+#include <tudocomp/ds/BitPackingKernels.hpp>
 #include <tudocomp/ds/uint_t.hpp>
 #include <tudocomp/ds/dynamic_t.hpp>
 #include <tudocomp/util/IntegerBase.hpp>
@@ -101,7 +102,8 @@ namespace int_vector {
         inline explicit BitPackingVector(size_type n): BitPackingVector() {
             this->m_real_size = n;
             size_t converted_size = bits2backing(elem2bits(this->m_real_size));
-            this->m_vec = std::vector<internal_data_type>(converted_size);
+            this->m_vec = typename IntRepr<T>::BitPackingVectorRepr::backing_type(
+                converted_size, this->m_vec.get_allocator());
             DCHECK_EQ(converted_size, this->m_vec.capacity());
         }
         inline BitPackingVector(size_type n, const value_type& val): BitPackingVector(n) {
@@ -485,45 +487,18 @@ namespace int_vector {
             auto common_size = std::min(old_size, new_size);
 
             if (old_width < new_width) {
-                // grow
-
-                // Read from position of last element in the old width grid,
-                // and write to position of last element in the new width grid
-                auto old_p = bitpos2backingpos_w(elem2bits_w(common_size, old_width));
-                auto new_p = bitpos2backingpos_w(elem2bits_w(common_size, new_width));
-
-                // make room for new bits, reallocating as needed
+                // grow: make room for new bits, reallocating as needed,
+                // then move the elements into the new width grid
                 this->m_vec.resize(bits2backing_w(new_bit_size));
                 this->set_width_raw(w);
                 this->m_real_size = new_size;
 
-                uint64_t* old_ptr = this->m_vec.data() + old_p.pos;
-                uint64_t* new_ptr = this->m_vec.data() + new_p.pos;
-
-                // move elements into new width grid
-                for (uint64_t i = 0; i < common_size; i++) {
-                    sdsl::bits::move_left((const uint64_t*&) old_ptr, old_p.offset, old_width);
-                    auto v = sdsl::bits::read_int(           old_ptr, old_p.offset, old_width);
-
-                    sdsl::bits::move_left((const uint64_t*&) new_ptr,    new_p.offset, new_width);
-                    sdsl::bits::write_int(                   new_ptr, v, new_p.offset, new_width);
-                }
+                kernels::change_width(this->m_vec.data(), old_width, new_width, common_size);
             } else if (old_width > new_width) {
-                // shrink
-
-                uint64_t* old_ptr = this->m_vec.data();
-                uint64_t* new_ptr = this->m_vec.data();
-
-                uint8_t old_offset = 0;
-                uint8_t new_offset = 0;
-
-                // move elements into new width grid
-                for (uint64_t i = 0; i < common_size; i++) {
-                    auto v = sdsl::bits::read_int_and_move((const uint64_t*&) old_ptr, old_offset, old_width);
-                    sdsl::bits::write_int_and_move(new_ptr, v, new_offset, new_width);
-                }
+                // shrink: move the elements into new width grid,
+                // then remove extra bits, dropping as needed
+                kernels::change_width(this->m_vec.data(), old_width, new_width, common_size);
 
-                // remove extra bits, dropping as needed
                 this->m_vec.resize(bits2backing_w(new_bit_size));
                 this->set_width_raw(w);
                 this->m_real_size = new_size;
@@ -543,6 +518,38 @@ namespace int_vector {
             this->m_vec.reserve(bits2backing(n));
         }
 
+        /// Whether the elements are stored in a memory-mapped temporary file.
+        inline bool disk_backed() const {
+            return this->m_vec.get_allocator().disk();
+        }
+
+        /// Moves the elements to a memory-mapped temporary file in the
+        /// directory `dir`, or back to the heap if `disk` is false.
+        inline void disk_backed(bool disk, const std::string& dir = "") {
+            const auto& current = this->m_vec.get_allocator();
+            if(disk == current.disk() && (!disk || dir == current.dir())) return;
+
+            using backing_type = typename IntRepr<T>::BitPackingVectorRepr::backing_type;
+            backing_type vec(this->m_vec.begin(), this->m_vec.end(),
+                             BackingAllocator<internal_data_type>(disk, dir));
+            this->m_vec = std::move(vec);
+        }
+
+        /// Copies the elements `[pos, pos + n)` into the native array `out`.
+        template<typename U>
+        inline void unpack(size_type pos, size_type n, U* out) const {
+            DCHECK_LE(pos + n, size());
+            kernels::unpack(this->m_vec.data(), elem2bits(pos), this->width(), n, out);
+        }
+
+        /// Overwrites the elements `[pos, pos + n)` with the values of the
+        /// native array `in`, truncated to the width of the vector.
+        template<typename U>
+        inline void pack(size_type pos, size_type n, const U* in) {
+            DCHECK_LE(pos + n, size());
+            kernels::pack(this->m_vec.data(), elem2bits(pos), this->width(), n, in);
+        }
+
         inline void reserve(uint64_t n, uint8_t w) {
             this->bit_reserve(n * w);
         }
@@ -31,11 +31,18 @@ public:
             // Allocate
             const size_t n = t.size();
             const size_t w = bits_for(n);
-            set_array(iv_t(n, 0, (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS));
+            set_array(new_array(n,
+                (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS,
+                t.disk_backed(ds::ISA), t.tmp_dir()));
 
             // Construct
-            for(len_t i = 0; i < n; i++) {
-                (*this)[sa[i]] = i;
+            uint64_t buf[ARRAY_CHUNK];
+            for(len_t begin = 0; begin < n; begin += ARRAY_CHUNK) {
+                const len_t len = std::min<len_t>(ARRAY_CHUNK, n - begin);
+                sa.unpack(begin, len, buf);
+                for(len_t j = 0; j < len; j++) {
+                    (*this)[buf[j]] = begin + j;
+                }
             }
 
             StatPhase::log("bit_width", size_t(width()));
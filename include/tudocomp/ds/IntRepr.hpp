@@ -6,6 +6,7 @@
 
 #include <tudocomp/ds/uint_t.hpp>
 #include <tudocomp/ds/dynamic_t.hpp>
+#include <tudocomp/ds/BackingAllocator.hpp>
 
 namespace tdc {namespace int_vector {
     enum class ElementStorageMode {
@@ -98,8 +99,10 @@ namespace tdc {namespace int_vector {
     template<size_t N>
     struct FixedBitPackingVectorRepr {
         using internal_data_type = DynamicIntValueType;
+        using backing_type = std::vector<internal_data_type,
+                                         BackingAllocator<internal_data_type>>;
 
-        std::vector<internal_data_type> m_vec;
+        backing_type m_vec;
         uint64_t m_real_size;
 
         inline FixedBitPackingVectorRepr():
@@ -114,8 +117,10 @@ namespace tdc {namespace int_vector {
     };
     struct DynamicBitPackingVectorRepr {
         using internal_data_type = DynamicIntValueType;
+        using backing_type = std::vector<internal_data_type,
+                                         BackingAllocator<internal_data_type>>;
 
-        std::vector<internal_data_type> m_vec;
+        backing_type m_vec;
         uint64_t m_real_size;
         uint8_t m_width;
 
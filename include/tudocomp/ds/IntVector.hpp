@@ -80,6 +80,26 @@ namespace int_vector {
         inline static void bit_reserve(backing_data& self, uint64_t n) {
             // TODO: Should this round up to the size of element, and then reserve normally?
         }
+
+        template<typename U>
+        inline static void unpack(const backing_data& self, size_type pos, size_type n, U* out) {
+            std::copy(self.begin() + pos, self.begin() + pos + n, out);
+        }
+
+        template<typename U>
+        inline static void pack(backing_data& self, size_type pos, size_type n, const U* in) {
+            for(size_type i = 0; i < n; i++) {
+                self[pos + i] = in[i];
+            }
+        }
+
+        inline static bool disk_backed(const backing_data&) {
+            return false;
+        }
+
+        inline static void disk_backed(backing_data&, bool disk, const std::string&) {
+            CHECK(!disk) << "only bit-packed vectors can be backed by a file";
+        }
     };
 
     template<typename T>
@@ -135,6 +155,24 @@ namespace int_vector {
         inline static void bit_reserve(backing_data& self, uint64_t n) {
             self.bit_reserve(n);
         }
+
+        template<typename U>
+        inline static void unpack(const backing_data& self, size_type pos, size_type n, U* out) {
+            self.unpack(pos, n, out);
+        }
+
+        template<typename U>
+        inline static void pack(backing_data& self, size_type pos, size_type n, const U* in) {
+            self.pack(pos, n, in);
+        }
+
+        inline static bool disk_backed(const backing_data& self) {
+            return self.disk_backed();
+        }
+
+        inline static void disk_backed(backing_data& self, bool disk, const std::string& dir) {
+            self.disk_backed(disk, dir);
+        }
     };
 
     template<class T, class X = void>
@@ -410,6 +448,42 @@ namespace int_vector {
             return m_data.data();
         }
 
+        /// Copies the elements `[pos, pos + n)` into the native array `out`.
+        ///
+        /// For bit-packed vectors, this is considerably faster than
+        /// accessing the elements one by one.
+        template<typename U>
+        inline void unpack(size_type pos, size_type n, U* out) const {
+            IntVectorTrait<T>::unpack(m_data, pos, n, out);
+        }
+
+        /// Overwrites the elements `[pos, pos + n)` with the values of the
+        /// native array `in`.
+        ///
+        /// For bit-packed vectors, the values are truncated to the width
+        /// of the vector.
+        template<typename U>
+        inline void pack(size_type pos, size_type n, const U* in) {
+            IntVectorTrait<T>::pack(m_data, pos, n, in);
+        }
+
+        /// Whether the elements are stored in a memory-mapped temporary file
+        /// instead of on the heap.
+        inline bool disk_backed() const {
+            return IntVectorTrait<T>::disk_backed(m_data);
+        }
+
+        /// Moves the elements to a memory-mapped temporary file in the
+        /// directory `dir`, or back to the heap if `disk` is false. If `dir`
+        /// is empty, `$TMPDIR` or `/tmp` is used.
+        ///
+        /// All later reallocations keep the storage location. The file gets
+        /// deleted as soon as the vector is destroyed.
+        /// Only bit-packed vectors support file-backed storage.
+        inline void disk_backed(bool disk, const std::string& dir = "") {
+            IntVectorTrait<T>::disk_backed(m_data, disk, dir);
+        }
+
         template <class InputIterator>
         inline void assign(InputIterator first, InputIterator last) {
             m_data.assign(first, last);
@@ -38,13 +38,20 @@ public:
             m_max = plcp.max_lcp();
             const size_t w = bits_for(m_max);
 
-            set_array(iv_t(n, 0, (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS));
-
-            (*this)[0] = 0;
-            for(len_t i = 1; i < n; i++) {
-                const len_t x = plcp[sa[i]];
-                (*this)[i] = x;
+            set_array(new_array(n,
+                (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS,
+                t.disk_backed(ds::LCP), t.tmp_dir()));
+
+            uint64_t buf[ARRAY_CHUNK];
+            for(len_t begin = 0; begin < n; begin += ARRAY_CHUNK) {
+                const len_t len = std::min<len_t>(ARRAY_CHUNK, n - begin);
+                sa.unpack(begin, len, buf);
+                for(len_t j = 0; j < len; j++) {
+                    buf[j] = plcp[buf[j]];
+                }
+                pack(begin, len, buf);
             }
+            (*this)[0] = 0;
 
             StatPhase::log("bit_width", size_t(width()));
             StatPhase::log("size", bit_size() / 8);
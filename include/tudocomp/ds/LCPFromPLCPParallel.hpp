@@ -0,0 +1,95 @@
+#pragma once
+
+#include <tudocomp/ds/TextDSFlags.hpp>
+#include <tudocomp/ds/CompressMode.hpp>
+#include <tudocomp/ds/ArrayDS.hpp>
+#include <tudocomp/util/Parallel.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+
+/// Constructs the LCP array from the PLCP array in parallel.
+///
+/// Every thread computes a contiguous range of the LCP array.
+class LCPFromPLCPParallel: public Algorithm, public ArrayDS {
+private:
+    /// Minimum amount of entries per thread.
+    static constexpr size_t MIN_PER_THREAD = 1ULL << 14;
+
+    len_t m_max;
+
+public:
+    inline static Meta meta() {
+        Meta m("lcp", "parallel",
+            "Constructs the LCP array in parallel, using the TextDS threads.");
+        return m;
+    }
+
+    inline static ds::InputRestrictions restrictions() {
+        return ds::InputRestrictions {};
+    }
+
+    template<typename textds_t>
+    inline LCPFromPLCPParallel(Env&& env, textds_t& t, CompressMode cm)
+            : Algorithm(std::move(env)) {
+
+        // Construct Suffix Array and PLCP Array
+        auto& sa = t.require_sa(cm);
+        auto& plcp = t.require_plcp(cm);
+
+        const size_t n = t.size();
+        const size_t threads = threads_for(n, MIN_PER_THREAD, t.threads());
+
+        StatPhase::wrap("Construct LCP Array", [&]{
+            m_max = plcp.max_lcp();
+            const size_t w = bits_for(m_max);
+
+            set_array(new_array(n,
+                (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS,
+                t.disk_backed(ds::LCP), t.tmp_dir()));
+
+            #pragma omp parallel num_threads(threads)
+            {
+                const size_t team = num_threads();
+                const size_t b = range_begin(n, thread_num(), team, ARRAY_CHUNK);
+                const size_t e = range_begin(n, thread_num() + 1, team, ARRAY_CHUNK);
+
+                uint64_t buf[ARRAY_CHUNK];
+                for(len_t begin = b; begin < e; begin += ARRAY_CHUNK) {
+                    const len_t len = std::min<len_t>(ARRAY_CHUNK, e - begin);
+                    sa.unpack(begin, len, buf);
+                    for(len_t j = 0; j < len; j++) {
+                        buf[j] = plcp[buf[j]];
+                    }
+                    pack(begin, len, buf);
+                }
+            }
+            if(n > 0) (*this)[0] = 0;
+
+            StatPhase::log("threads", threads);
+            StatPhase::log("bit_width", size_t(width()));
+            StatPhase::log("size", bit_size() / 8);
+        });
+
+        if(cm == CompressMode::delayed) compress();
+    }
+
+	inline len_t max_lcp() const {
+		return m_max;
+	}
+
+    void compress() {
+        debug_check_array_is_initialized();
+
+        StatPhase::wrap("Compress LCP Array", [this]{
+            width(bits_for(m_max));
+            shrink_to_fit();
+
+            StatPhase::log("bit_width", size_t(width()));
+            StatPhase::log("size", bit_size() / 8);
+        });
+    }
+};
+
+} //ns
@@ -34,13 +34,21 @@ public:
 
         StatPhase::wrap("Construct PLCP Array", [&]{
             // Use Phi algorithm to compute PLCP array
+            // Phi is replaced by PLCP chunk by chunk
             m_max = 0;
-            for(len_t i = 0, l = 0; i < n - 1; ++i) {
-                const len_t phii = (*this)[i];
-                while(t[i+l] == t[phii+l]) ++l;
-                m_max = std::max(m_max, l);
-                (*this)[i] = l;
-                if(l) --l;
+            uint64_t buf[ARRAY_CHUNK];
+            for(len_t begin = 0, l = 0; begin + 1 < n; begin += ARRAY_CHUNK) {
+                const len_t len = std::min<len_t>(ARRAY_CHUNK, n - 1 - begin);
+                unpack(begin, len, buf);
+                for(len_t j = 0; j < len; ++j) {
+                    const len_t i = begin + j;
+                    const len_t phii = buf[j];
+                    while(t[i+l] == t[phii+l]) ++l;
+                    m_max = std::max(m_max, l);
+                    buf[j] = l;
+                    if(l) --l;
+                }
+                pack(begin, len, buf);
             }
 
             StatPhase::log("bit_width", size_t(width()));
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+
+#include <tudocomp/ds/TextDSFlags.hpp>
+#include <tudocomp/ds/CompressMode.hpp>
+#include <tudocomp/ds/ArrayDS.hpp>
+#include <tudocomp/util/Parallel.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+
+/// Constructs the PLCP array using the phi array in parallel.
+///
+/// The text positions are split into one contiguous range per thread,
+/// and each thread runs the Phi algorithm on its range. The first PLCP
+/// value of a range is computed by a plain character comparison, since
+/// the value of the preceding position is not known.
+class PLCPFromPhiParallel: public Algorithm, public ArrayDS {
+private:
+    /// Minimum amount of text positions per thread.
+    static constexpr size_t MIN_PER_THREAD = 1ULL << 14;
+
+    len_t m_max;
+
+public:
+    inline static Meta meta() {
+        Meta m("plcp", "parallel",
+            "Constructs the PLCP array in parallel, using the TextDS threads.");
+        return m;
+    }
+
+    inline static ds::InputRestrictions restrictions() {
+        return ds::InputRestrictions {};
+    }
+
+    template<typename textds_t>
+    inline PLCPFromPhiParallel(Env&& env, textds_t& t, CompressMode cm)
+            : Algorithm(std::move(env)) {
+
+        const size_t n = t.size();
+        const size_t threads = threads_for(n, MIN_PER_THREAD, t.threads());
+
+        // Construct Phi and attempt to work in-place
+        set_array(t.inplace_phi(cm));
+
+        StatPhase::wrap("Construct PLCP Array", [&]{
+            // the last position (the sentinel) keeps its value,
+            // as in PLCPFromPhi
+            const size_t m = (n > 0) ? n - 1 : 0;
+            std::vector<len_t> max(threads, 0);
+
+            #pragma omp parallel num_threads(threads)
+            {
+                const size_t team = num_threads();
+                const size_t b = range_begin(m, thread_num(), team, ARRAY_CHUNK);
+                const size_t e = range_begin(m, thread_num() + 1, team, ARRAY_CHUNK);
+
+                // Phi is replaced by PLCP chunk by chunk
+                len_t local_max = 0;
+                uint64_t buf[ARRAY_CHUNK];
+                for(len_t begin = b, l = 0; begin < e; begin += ARRAY_CHUNK) {
+                    const len_t len = std::min<len_t>(ARRAY_CHUNK, e - begin);
+                    unpack(begin, len, buf);
+                    for(len_t j = 0; j < len; ++j) {
+                        const len_t i = begin + j;
+                        const len_t phii = buf[j];
+                        while(t[i+l] == t[phii+l]) ++l;
+                        local_max = std::max(local_max, l);
+                        buf[j] = l;
+                        if(l) --l;
+                    }
+                    pack(begin, len, buf);
+                }
+                max[thread_num()] = local_max;
+            }
+            m_max = *std::max_element(max.begin(), max.end());
+
+            StatPhase::log("threads", threads);
+            StatPhase::log("bit_width", size_t(width()));
+            StatPhase::log("size", bit_size() / 8);
+        });
+
+        if(cm == CompressMode::compressed || cm == CompressMode::delayed) {
+            compress();
+        }
+    }
+
+	inline len_t max_lcp() const {
+		return m_max;
+	}
+
+    void compress() {
+        debug_check_array_is_initialized();
+
+        StatPhase::wrap("Compress PLCP Array", [this]{
+            width(bits_for(m_max));
+            shrink_to_fit();
+
+            StatPhase::log("bit_width", size_t(width()));
+            StatPhase::log("size", bit_size() / 8);
+        });
+    }
+};
+
+} //ns
@@ -32,13 +32,20 @@ public:
 
         StatPhase::wrap("Construct Phi Array", [&]{
             // Construct Phi Array
-            set_array(iv_t(n, 0, (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS));
-
-            for(len_t i = 1, prev = sa[0]; i < n; i++) {
-                (*this)[sa[i]] = prev;
-                prev = sa[i];
+            set_array(new_array(n,
+                (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS,
+                t.disk_backed(ds::PHI), t.tmp_dir()));
+
+            // read the suffix array in chunks
+            uint64_t buf[ARRAY_CHUNK];
+            for(len_t begin = 0, prev = sa[n-1]; begin < n; begin += ARRAY_CHUNK) {
+                const len_t len = std::min<len_t>(ARRAY_CHUNK, n - begin);
+                sa.unpack(begin, len, buf);
+                for(len_t j = 0; j < len; j++) {
+                    (*this)[buf[j]] = prev;
+                    prev = buf[j];
+                }
             }
-            (*this)[sa[0]] = sa[n-1];
 
             StatPhase::log("bit_width", size_t(width()));
             StatPhase::log("size", bit_size() / 8);
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+
+#include <tudocomp/ds/TextDSFlags.hpp>
+#include <tudocomp/ds/CompressMode.hpp>
+#include <tudocomp/ds/ArrayDS.hpp>
+#include <tudocomp/util/Parallel.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+
+/// Constructs the Phi array using the suffix array in parallel.
+///
+/// Each thread scatters a contiguous range of the suffix array into a
+/// temporary array of native integers, which is packed into the Phi array
+/// afterwards. Hence, this needs additional space for n integers of type
+/// \ref len_compact_t during the construction.
+class PhiFromSAParallel: public Algorithm, public ArrayDS {
+    /// Minimum amount of suffixes per thread.
+    static constexpr size_t MIN_PER_THREAD = 1ULL << 14;
+
+public:
+    inline static Meta meta() {
+        Meta m("phi", "parallel",
+            "Constructs the Phi array in parallel, using the TextDS threads.");
+        return m;
+    }
+
+    inline static ds::InputRestrictions restrictions() {
+        return ds::InputRestrictions {};
+    }
+
+    template<typename textds_t>
+    inline PhiFromSAParallel(Env&& env, textds_t& t, CompressMode cm)
+            : Algorithm(std::move(env)) {
+
+        // Construct Suffix Array
+        auto& sa = t.require_sa(cm);
+
+        const size_t n = t.size();
+        const size_t w = bits_for(n);
+        const size_t threads = threads_for(n, MIN_PER_THREAD, t.threads());
+
+        StatPhase::wrap("Construct Phi Array", [&]{
+            set_array(new_array(n,
+                (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS,
+                t.disk_backed(ds::PHI), t.tmp_dir()));
+            std::vector<len_compact_t> phi(n);
+
+            #pragma omp parallel num_threads(threads)
+            {
+                const size_t team = num_threads();
+                const size_t b = range_begin(n, thread_num(), team, ARRAY_CHUNK);
+                const size_t e = range_begin(n, thread_num() + 1, team, ARRAY_CHUNK);
+
+                uint64_t buf[ARRAY_CHUNK];
+                for(len_t begin = b, prev = sa[(b + n - 1) % n]; begin < e; begin += ARRAY_CHUNK) {
+                    const len_t len = std::min<len_t>(ARRAY_CHUNK, e - begin);
+                    sa.unpack(begin, len, buf);
+                    for(len_t j = 0; j < len; j++) {
+                        phi[buf[j]] = prev;
+                        prev = buf[j];
+                    }
+                }
+
+                // the ranges are aligned, so no two threads pack into the same word
+                #pragma omp barrier
+                for(len_t begin = b; begin < e; begin += ARRAY_CHUNK) {
+                    pack(begin, std::min<len_t>(ARRAY_CHUNK, e - begin), phi.data() + begin);
+                }
+            }
+
+            StatPhase::log("threads", threads);
+            StatPhase::log("bit_width", size_t(width()));
+            StatPhase::log("size", bit_size() / 8);
+        });
+
+        if(cm == CompressMode::delayed) compress();
+    }
+
+    void compress() {
+        debug_check_array_is_initialized();
+
+        StatPhase::wrap("Compress Phi Array", [this]{
+            width(bits_for(size()));
+            shrink_to_fit();
+
+            StatPhase::log("bit_width", size_t(width()));
+            StatPhase::log("size", bit_size() / 8);
+        });
+    }
+};
+
+} //ns
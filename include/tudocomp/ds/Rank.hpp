@@ -1,72 +1,142 @@
 #pragma once
 
+#include <vector>
+
 #include <tudocomp/util.hpp>
 #include <tudocomp/ds/rank_64bit.hpp>
 #include <tudocomp/ds/IntVector.hpp>
 
 namespace tdc {
 
-/// \brief Implements a rank data structure for a \ref BitVector.
+/// \cond INTERNAL
+
+/// \brief Counts the flagged bits of a \ref BitVector in the interleaved
+///        layout of rank9.
 ///
-/// The data structure follows a block / superblock principle. Blocks are
-/// always of fixed size (e.g. 64 bits), the size of a superblock is
-/// the squared block size.
+/// The bit vector is divided into basic blocks of 512 bits (eight words).
+/// For each basic block, an entry of two 64-bit words is stored: the amount
+/// of flagged bits in front of the block, and the amounts of flagged bits
+/// in front of the words 1 to 7 within the block as seven 9-bit fields.
+/// A query thus reads one 16-byte entry and one word of the bit vector.
+/// An additional entry at the end holds the total amount of flagged bits.
 ///
-/// The structure supports both rank1 and rank0 queries.
-class Rank {
+/// The index takes 25% of the space of the bit vector.
+///
+/// \tparam m_bit the bits to count (0 or 1)
+template<bool m_bit>
+class RankIndex {
 public:
-    /// The size of a block in bits.
-    static constexpr size_t block_size =
-        8 * sizeof(BitVector::internal_data_type);
+    static constexpr size_t word_bits = 64;
+    static constexpr size_t block_words = 8;
+    static constexpr size_t block_bits = word_bits * block_words;
 
-    static_assert(block_size <= 64, "block_size cannot be larger than 64 bits");
+    static_assert(8 * sizeof(BitVector::internal_data_type) == word_bits,
+        "bit vectors must be backed by 64-bit words");
 
 private:
-    const BitVector* m_bv;
+    static constexpr size_t field_bits = 9;
+    static constexpr uint64_t field_mask = (1ULL << field_bits) - 1;
 
-    size_t m_supblock_size;
-    DynamicIntVector m_blocks;
-    DynamicIntVector m_supblocks;
+    const BitVector* m_bv;
+    std::vector<uint64_t> m_entries;
 
 public:
-    /// \brief Default constructor.
-    inline Rank()
-        : m_bv(nullptr),
-          m_supblock_size(0) {
+    inline RankIndex() : m_bv(nullptr) {}
+
+    inline RankIndex(const BitVector& bv) : m_bv(&bv) {
+        const size_t n = bv.size();
+        const size_t num_words = idiv_ceil(n, word_bits);
+        const size_t num_blocks = idiv_ceil(num_words, block_words);
+
+        m_entries.resize(2 * (num_blocks + 1));
+
+        size_t abs = 0;
+        for(size_t b = 0; b < num_blocks; b++) {
+            uint64_t rel = 0;
+            size_t r = 0;
+            for(size_t t = 0; t < block_words; t++) {
+                if(t > 0) rel |= uint64_t(r) << (field_bits * (t - 1));
+
+                const size_t i = b * block_words + t;
+                if(i < num_words) r += rank1(word(i));
+            }
+            m_entries[2*b] = abs;
+            m_entries[2*b+1] = rel;
+            abs += r;
+        }
+        m_entries[2*num_blocks] = abs;
+    }
+
+    /// \brief The i-th word of the bit vector with the flagged bits set.
+    ///
+    /// The padding bits behind the last bit of the vector are never flagged.
+    inline uint64_t word(size_t i) const {
+        const uint64_t v = m_bit ? m_bv->data()[i] : ~m_bv->data()[i];
+        const size_t end = m_bv->size() - i * word_bits;
+        return (end < word_bits) ? (v & ((1ULL << end) - 1)) : v;
+    }
+
+    /// \brief The amount of basic blocks.
+    inline size_t num_blocks() const {
+        return m_entries.size() / 2 - 1;
     }
 
-    /// \brief Copy constructor.
-    inline Rank(const Rank& other)
-        : m_bv(other.m_bv),
-          m_supblock_size(other.m_supblock_size),
-          m_blocks(other.m_blocks),
-          m_supblocks(other.m_supblocks) {
+    /// \brief The amount of flagged bits in front of basic block b.
+    ///
+    /// For b equal to \ref num_blocks, this is the total amount.
+    inline size_t block_rank(size_t b) const {
+        return m_entries[2*b];
     }
 
-    /// \brief Move constructor.
-    inline Rank(Rank&& other)
-        : m_bv(other.m_bv),
-          m_supblock_size(other.m_supblock_size),
-          m_blocks(std::move(other.m_blocks)),
-          m_supblocks(std::move(other.m_supblocks)) {
+    /// \brief The amount of flagged bits in front of the t-th word in
+    ///        basic block b.
+    inline size_t word_rank(size_t b, size_t t) const {
+        // for t = 0, this reads the unused most significant bit
+        t -= 1;
+        t += (t >> 60) & 8;
+        return (m_entries[2*b+1] >> (field_bits * t)) & field_mask;
     }
 
-    /// \brief Copy assignment.
-    inline Rank& operator=(const Rank& other) {
-        m_bv = other.m_bv;
-        m_supblock_size = other.m_supblock_size;
-        m_blocks = other.m_blocks;
-        m_supblocks = other.m_supblocks;
-        return *this;
+    /// \brief The total amount of flagged bits.
+    inline size_t total() const {
+        return block_rank(num_blocks());
     }
 
-    /// \brief Move assignment.
-    inline Rank& operator=(Rank&& other) {
-        m_bv = other.m_bv;
-        m_supblock_size = other.m_supblock_size;
-        m_blocks = std::move(other.m_blocks);
-        m_supblocks = std::move(other.m_supblocks);
-        return *this;
+    /// \brief The amount of flagged bits up to (including) position x.
+    inline size_t rank(size_t x) const {
+        DCHECK_LT(x, m_bv->size());
+        const size_t i = x / word_bits;
+        const size_t b = i / block_words;
+        const uint8_t o = x % word_bits;
+
+        const uint64_t mask = (o == word_bits - 1) ? ~0ULL : ((2ULL << o) - 1);
+        return block_rank(b)
+            + word_rank(b, i % block_words)
+            + rank1(uint64_t((m_bit ? m_bv->data()[i] : ~m_bv->data()[i]) & mask));
+    }
+};
+
+/// \endcond
+
+/// \brief Implements a rank data structure for a \ref BitVector.
+///
+/// The data structure stores, for each block of 512 bits, the absolute rank
+/// and the ranks relative to the block within one 16-byte entry
+/// (see rank9 by Vigna). Hence, a query touches one entry and one word of
+/// the bit vector, and needs no bit-packed accesses.
+///
+/// The structure supports both rank1 and rank0 queries.
+class Rank {
+public:
+    /// The size of a block in bits.
+    static constexpr size_t block_size = RankIndex<1>::word_bits;
+
+private:
+    RankIndex<1> m_index;
+
+public:
+    /// \brief Default constructor.
+    inline Rank() {
     }
 
     /// \brief Constructs the rank data structure for the given bit vector.
@@ -76,47 +146,7 @@ public:
     /// anymore. In other words, this data structure is static.
     ///
     /// \param bv the underlying bit vector
-    inline Rank(const BitVector& bv)
-        : m_bv(&bv),
-          m_supblock_size(block_size * block_size) {
-
-        DCHECK_GT(m_supblock_size, block_size)
-            << "superblocks must be larger than blocks!";
-        DCHECK_EQ(0, m_supblock_size % block_size)
-            << "superblock size must be a multiple of the block size!";
-
-        const size_t n = m_bv->size();
-        const auto data = m_bv->data();
-
-        // compute number of superblocks / blocks
-        const size_t num_supblocks = idiv_ceil(n, m_supblock_size);
-        const size_t num_blocks    = idiv_ceil(n, block_size);
-
-        const size_t blocks_per_supblock = m_supblock_size / block_size;
-
-        m_supblocks = DynamicIntVector(num_supblocks, 0, bits_for(n));
-        m_blocks = DynamicIntVector(num_blocks, 0, bits_for(m_supblock_size));
-
-        // construct
-        size_t rank_bv = 0; // 1-bits in whole BV
-        size_t rank_sb = 0; // 1-bits in current superblock
-        size_t cur_sb = 0;  // current superblock
-
-        for(size_t j = 0; j < num_blocks; j++) {
-            size_t i = j / blocks_per_supblock;
-            if(i > cur_sb) {
-                // we reached a new superblock
-                m_supblocks[cur_sb] = rank_bv;
-                rank_sb = 0;
-                cur_sb = i;
-            }
-
-            auto rank_b = tdc::rank1(data[j]);
-            rank_sb += rank_b;
-            rank_bv += rank_b;
-
-            m_blocks[j] = rank_sb;
-        }
+    inline Rank(const BitVector& bv) : m_index(bv) {
     }
 
     /// \brief Counts the amount of 1-bits from the beginning of the bit vector
@@ -124,17 +154,7 @@ public:
     /// \param x the position up to which to count (inclusively)
     /// \return the amount of counted 1-bits
     inline size_t rank1(size_t x) const {
-        DCHECK_LT(x, m_bv->size());
-        size_t r = 0;
-        size_t i = x / m_supblock_size;
-        if(i > 0) r += m_supblocks[i-1];
-        size_t j = x / block_size;
-
-        size_t k = j - i * (m_supblock_size / block_size);
-        if(k > 0) r += m_blocks[j-1];
-
-        r += tdc::rank1(m_bv->data()[j], x % block_size);
-        return r;
+        return m_index.rank(x);
     }
 
     /// \brief Counts the amount of 1-bits in the given interval (borders
@@ -4,268 +4,253 @@
 // https://gist.github.com/makagonov/f7ed8ce729da72621b321f0ab547debb
 //from: http://stackoverflow.com/questions/9452701/ukkonens-suffix-tree-algorithm-in-plain-english/9513423#9513423
 #include <string>
-#include <map>
 #include <vector>
-#include <tuple>
-
-#include <unordered_map>
-
+#include <cstdint>
 
 #include <tudocomp/io.hpp>
+#include <tudocomp_stat/StatPhase.hpp>
 
 
 namespace tdc {
 
+/// A suffix tree built with Ukkonen's algorithm.
+///
+/// All nodes are stored in one array and are addressed by 32-bit indices.
+/// The root has index 0, which also serves as the null index for children
+/// and siblings. The children of a node form a sibling list sorted by the
+/// first character of their edges.
+///
+/// The tree does not copy the text, so it must outlive the tree.
 class SuffixTree{
 public:
-    struct STNode;
-    struct STLeaf;
-    struct STInnerNode;
+    using node_type = uint32_t;
+
 private:
+    static constexpr node_type ROOT = 0;
+    static constexpr uint32_t OPEN_END = UINT32_MAX;
+
+    struct Node {
+        //represents the edge leading to this node, [start, end)
+        uint32_t start;
+        uint32_t end;
+
+        node_type first_child;
+        node_type next_sibling;
 
+        //suffix link of inner nodes, suffix number of leaves
+        uint32_t link;
+    };
 
-    //root node
-    STInnerNode* root;
+    View m_text;
+    std::vector<Node> m_nodes;
 
-    //text added to st
-    std::string Text;
-    int pos;
-    uint suffix;
+    //position of the last character added to the tree
+    uint32_t pos;
+    uint32_t suffix;
 
     //number of suffixes to be added;
-    uint remainder;
+    uint32_t remainder;
 
     //active point, from where to start inserting new suffixes
-    STNode* active_node;
-    char active_edge;
-    uint active_length;
-
+    node_type active_node;
+    uint8_t active_edge;
+    uint32_t active_length;
 
     //saves last added node
-    STInnerNode* last_added_sl;
-
-    void add_sl(STInnerNode* node){
+    node_type last_added_sl;
 
-        if(last_added_sl != root) {
-            last_added_sl->suffix_link=node;
+    inline void add_sl(node_type node){
+        if(last_added_sl != ROOT) {
+            m_nodes[last_added_sl].link=node;
         }
         last_added_sl=node;
     }
 
-public:
-
-
-    //computes edge length:
-    uint edge_length(STNode* node){
-        if(node->start==-1){
-            return 0;
-        }
-
-        if(node->end == 0){
-            return pos - node->start+1;
-        } else {
-            return node->end - node->start;
-        }
+    inline node_type create_node(uint32_t start, uint32_t end, uint32_t link) {
+        m_nodes.push_back(Node { start, end, ROOT, ROOT, link });
+        return m_nodes.size() - 1;
     }
-    struct STNode{
-
-        //represents the edge leading to this node
-        int start;
-        int end;
-        STNode(int s, int e = 0) :  start(s), end (e) {}
-        virtual ~STNode(){}
-
-    };
-
-    struct STLeaf : STNode {
-        //suffix if leaf
-        uint suffix;
-        //constructor. e=0
-        STLeaf(int s, int e = 0) : STNode(s,e){}
-
-        virtual ~STLeaf() {}
-
-    };
-
-    struct STInnerNode : STNode {
-        //
-        uint string_depth;
-        STInnerNode * parent;
-
-        // child nodes
-        std::unordered_map<char, STNode*> child_nodes;
-        //suffix link
-        STInnerNode* suffix_link;
-        //constructor. e=0
-
-        // start(s), end (e)
-        STInnerNode(int s, int e = 0) : STNode(s,e){ suffix_link = NULL; child_nodes.reserve(6);}
-
-        virtual ~STInnerNode(){}
-
-    };
-
-    //constructor
-    SuffixTree(){
-        //no Text is read
-        pos=-1;
-        Text="";
-        remainder=0;
-        suffix=0;
-
-
-        root = new STInnerNode(-1);
-        root->string_depth=0;
-
-
-        //active start node is root
-        active_node=root;
-        active_length=0;
 
-        last_added_sl=root;
-
-    }
-    ~SuffixTree(){
-        root=NULL;
-
-        active_node=root;
-        last_added_sl=root;
+    inline uint8_t first_char(node_type node) const {
+        return m_text[m_nodes[node].start];
     }
 
-private:
-    inline void add_char(char c){
-        //Text += c;
+    inline void add_char(uint8_t c){
         pos++;
         remainder++;
-        last_added_sl=root;
+        last_added_sl=ROOT;
 
         while(remainder > 0){
             if(active_length==0){
                 active_edge = c;
             }
 
+            //find the edge starting with the active edge character,
+            //or the sibling after which it has to be inserted
+            node_type prev = ROOT;
+            node_type next = m_nodes[active_node].first_child;
+            while(next != ROOT && first_char(next) < active_edge) {
+                prev = next;
+                next = m_nodes[next].next_sibling;
+            }
 
-
-            //if the active node doesnt have the corresponding edge:
-
-            STInnerNode * active_inner = dynamic_cast<STInnerNode *> (active_node);
-
-            auto next_it = active_inner->child_nodes.find(active_edge);
-            if(next_it==active_inner->child_nodes.end()){
+            if(next == ROOT || first_char(next) != active_edge){
                 //insert new leaf
-                STLeaf* new_leaf = new STLeaf(pos);
-                active_inner->child_nodes[active_edge] = new_leaf;
-         //       leaves.push_back(new_leaf);
-                new_leaf->suffix=suffix++;
-                add_sl(active_inner);
+                const node_type leaf = create_node(pos, OPEN_END, suffix++);
+                m_nodes[leaf].next_sibling = next;
+                if(prev == ROOT) {
+                    m_nodes[active_node].first_child = leaf;
+                } else {
+                    m_nodes[prev].next_sibling = leaf;
+                }
+                add_sl(active_node);
 
             } else {
-                STNode* next =  active_inner->child_nodes[active_edge] ;
                 //if the active length is greater than the edge length:
                 //switch active node to that
                 //walk down
-                if(active_length>= edge_length(next)){
+                const uint32_t next_length = edge_length(next);
+                if(active_length>= next_length){
                     active_node = next;
-                    active_length -= edge_length(next);
-                    active_edge = Text[pos-active_length];
+                    active_length -= next_length;
+                    active_edge = m_text[pos-active_length];
                     continue;
                 }
 
                 //if that suffix is already in the tree::
-                if(Text[next->start +active_length] == c){
+                if(m_text[m_nodes[next].start +active_length] == c){
                     active_length++;
-                    add_sl(active_inner);
+                    add_sl(active_node);
                     break;
                 }
 
                 //now split edge if the edge is found
+                const uint32_t split_start = m_nodes[next].start;
+                const node_type split = create_node(split_start, split_start+active_length, ROOT);
+                const node_type leaf = create_node(pos, OPEN_END, suffix++);
+
+                //the split node takes the place of next among its siblings
+                m_nodes[split].next_sibling = m_nodes[next].next_sibling;
+                if(prev == ROOT) {
+                    m_nodes[active_node].first_child = split;
+                } else {
+                    m_nodes[prev].next_sibling = split;
+                }
 
-                STInnerNode* split = new STInnerNode(next->start, next->start+active_length);
-                active_inner->child_nodes[active_edge] = split;
-
-                STLeaf* leaf = new STLeaf(pos);
-                leaf->suffix=suffix++;
-                split->child_nodes[c] = leaf;
+                //next and the new leaf become the children of split,
+                //ordered by their first character
+                m_nodes[next].start = split_start + active_length;
+                if(first_char(next) < c) {
+                    m_nodes[split].first_child = next;
+                    m_nodes[next].next_sibling = leaf;
+                } else {
+                    m_nodes[split].first_child = leaf;
+                    m_nodes[leaf].next_sibling = next;
+                    m_nodes[next].next_sibling = ROOT;
+                }
 
-                next->start=next->start + active_length;
-                split->child_nodes[Text[next->start]] = next;
                 add_sl(split);
-       //         leaves.push_back(leaf);
             }
             remainder--;
-            if(active_node==root && active_length>0){
+            if(active_node==ROOT && active_length>0){
                 active_length--;
-                active_edge = Text[pos-remainder+1];
+                active_edge = m_text[pos-remainder+1];
             }else {
-                if(active_inner->suffix_link != NULL){
-                    active_node = active_inner->suffix_link;
-                } else {
-                    active_node = root;
-                }
-
+                // the suffix link of an inner node is ROOT if not set
+                active_node = m_nodes[active_node].link;
             }
         }
-
     }
+
 public:
-    inline void append_char(char c){
+    /// Constructs the suffix tree of the given text.
+    ///
+    /// The amount of nodes and the memory used per input byte are
+    /// logged to the current \ref StatPhase.
+    SuffixTree(const View& text) : m_text(text) {
+        // there are at most 2n nodes, so the array never gets reallocated
+        // (pages that are never used do not get backed by memory)
+        m_nodes.reserve(2 * text.size() + 1);
+
+        //no text is read
+        pos=UINT32_MAX;
+        remainder=0;
+        suffix=0;
 
-        Text +=c;
-        add_char(c);
-    }
+        create_node(0, 0, ROOT); // root
+
+        //active start node is root
+        active_node=ROOT;
+        active_length=0;
+        last_added_sl=ROOT;
 
-    inline void append_string(std::string input){
-        Text += input;
-        for(uint i = 0; i<input.length();i++){
-            add_char(input[i]);
+        for (size_t i = 0; i < text.size(); i++) {
+            add_char(text[i]);
         }
-    }
 
-    inline void append_input(Input& input){
-        auto iview  = input.as_view();
-        append_input(iview);
+        StatPhase::log("nodes", m_nodes.size());
+        StatPhase::log("bytes per input byte",
+            text.size() ? double(m_nodes.size() * sizeof(Node)) / text.size() : 0.0);
     }
 
-    inline void append_input(io::InputView & input){
-        Text += input;
-        for (uint i = 0; i < input.size(); i++) {
-            uint8_t c = input[i];
-            add_char(c);
+    SuffixTree(const SuffixTree&) = delete;
+    SuffixTree& operator=(const SuffixTree&) = delete;
+
+    //computes edge length:
+    inline uint32_t edge_length(node_type node) const {
+        if(node==ROOT){
+            return 0;
         }
-    }
 
-    inline std::string get_text(){
-        return Text;
+        const Node& n = m_nodes[node];
+        if(n.end == OPEN_END){
+            return pos - n.start+1;
+        } else {
+            return n.end - n.start;
+        }
     }
 
-    inline uint get_size(){
-        return Text.size();
+    inline uint32_t get_size() const {
+        return m_text.size();
     }
 
-
-    inline SuffixTree::STNode* get_root(){
-        return root;
+    inline node_type get_root() const {
+        return ROOT;
     }
 
-    inline std::string get_string_of_edge(STNode* node){
-        return Text.substr(node->start, edge_length(node));
+    /// The first child of the node, or the root if it is a leaf.
+    inline node_type get_first_child(node_type node) const {
+        return m_nodes[node].first_child;
     }
 
+    /// The next sibling of the node, or the root if it is the last one.
+    inline node_type get_next_sibling(node_type node) const {
+        return m_nodes[node].next_sibling;
+    }
 
-    SuffixTree(Input& input) : SuffixTree(){
-        append_input(input);
+    inline bool is_leaf(node_type node) const {
+        return node != ROOT && m_nodes[node].first_child == ROOT;
     }
 
-    SuffixTree(io::InputView & input) : SuffixTree(){
-        append_input(input);
+    /// The starting position of the suffix a leaf represents.
+    inline uint32_t get_suffix(node_type node) const {
+        DCHECK(is_leaf(node));
+        return m_nodes[node].link;
     }
 
-    SuffixTree(std::string input) :  SuffixTree(){
-        append_string(input);
+    inline uint32_t get_edge_length(node_type node) const {
+        return edge_length(node);
     }
 
+    inline std::string get_string_of_edge(node_type node) const {
+        return std::string((const char*) m_text.data() + m_nodes[node].start,
+                           edge_length(node));
+    }
 
+    /// The amount of nodes, including the root.
+    inline size_t get_tree_size() const {
+        return m_nodes.size();
+    }
 };
 
 }
-
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <sstream>
+
 #include <tudocomp/ds/TextDSFlags.hpp>
 #include <tudocomp/Algorithm.hpp>
 #include <tudocomp/ds/IntVector.hpp>
@@ -47,7 +49,8 @@ public:
     inline static ds::InputRestrictions common_restrictions(dsflags_t flags) {
         ds::InputRestrictions rest;
 
-        if (flags & SA)   rest |= sa_type::restrictions();
+        // all other structures get constructed from the SA
+        if (flags & (SA | ISA | LCP | PHI | PLCP)) rest |= sa_type::restrictions();
         if (flags & ISA)  rest |= isa_type::restrictions();
         if (flags & LCP)  rest |= lcp_type::restrictions();
         if (flags & PHI)  rest |= phi_type::restrictions();
@@ -68,8 +71,31 @@ private:
     std::unique_ptr<isa_t> m_isa;
 
     dsflags_t m_ds_requested;
+    dsflags_t m_ds_disk;
+    std::string m_tmp_dir;
     CompressMode m_cm;
 
+    inline static dsflags_t parse_ds_list(const std::string& list) {
+        if(list == "none") return 0;
+        if(list == "all") return SA | ISA | LCP | PHI | PLCP;
+
+        dsflags_t flags = 0;
+        std::istringstream ss(list);
+        for(std::string name; std::getline(ss, name, ',');) {
+            if(name == "sa")        flags |= SA;
+            else if(name == "isa")  flags |= ISA;
+            else if(name == "lcp")  flags |= LCP;
+            else if(name == "phi")  flags |= PHI;
+            else if(name == "plcp") flags |= PLCP;
+            else throw std::logic_error(
+                "Unknown text data structure \"" + name + "\", "
+                "expected a comma separated list of sa, isa, lcp, phi and plcp, "
+                "or all or none."
+            );
+        }
+        return flags;
+    }
+
     template<typename ds_t>
     inline std::unique_ptr<ds_t> construct_ds(const std::string& option, CompressMode cm) {
         return std::make_unique<ds_t>(
@@ -122,6 +148,9 @@ public:
         m.option("lcp").templated<lcp_t, LCPFromPLCP>("lcp");
         m.option("isa").templated<isa_t, ISAFromSA>("isa");
         m.option("compress").dynamic("delayed");
+        m.option("threads").dynamic(0); // 0 = OpenMP default
+        m.option("disk").dynamic("none"); // arrays backed by temporary files
+        m.option("tmp").dynamic("/tmp"); // directory for temporary files
         return m;
     }
 
@@ -137,6 +166,11 @@ public:
             );
         }
 
+        // the PLCP array is computed in the storage of the Phi array
+        m_ds_disk = parse_ds_list(this->env().option("disk").as_string());
+        if(m_ds_disk & PLCP) m_ds_disk |= PHI;
+        m_tmp_dir = this->env().option("tmp").as_string();
+
         auto& cm_str = this->env().option("compress").as_string();
         if(cm_str == "delayed") {
             m_cm = CompressMode::delayed;
@@ -306,6 +340,31 @@ public:
         return m_text.size();
     }
 
+    /// Returns whether the given data structure is to be stored in a
+    /// memory-mapped temporary file instead of on the heap.
+    ///
+    /// The construction algorithms pass this on to
+    /// \ref ArrayDS::new_array. The file is deleted as soon as the
+    /// data structure is released or discarded.
+    inline bool disk_backed(dsflags_t flag) const {
+        return m_ds_disk & flag;
+    }
+
+    /// Returns the directory for the temporary files of disk-backed data
+    /// structures.
+    ///
+    /// This should name a directory on a disk rather than a RAM-backed
+    /// file system like tmpfs, which `/tmp` often is.
+    inline const std::string& tmp_dir() const {
+        return m_tmp_dir;
+    }
+
+    /// Returns the amount of threads the parallel construction algorithms
+    /// may use, or 0 for the OpenMP default.
+    inline size_t threads() const {
+        return env().option("threads").as_integer();
+    }
+
     inline void print(std::ostream& out, size_t base) {
         size_t w = std::max(8UL, (size_t)std::log10((double)size()) + 1);
         out << std::setfill(' ');
@@ -3,6 +3,10 @@
 #include <cstdint>
 #include <tudocomp/util.hpp>
 
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 namespace tdc {
 
 // thiss linear shifting approach is indeed the fastest, compared with
@@ -96,4 +100,33 @@ inline constexpr uint8_t select0(uint_t v, uint8_t l, uint8_t k) {
     }
 }
 
+/// \brief Finds the position of the k-th 1-bit in a 64-bit word without
+///        scanning.
+///
+/// If the target supports BMI2, the k-th 1-bit is isolated with a single
+/// `pdep` and located with `tzcnt`. Otherwise, the k-1 lowest 1-bits are
+/// cleared first.
+///
+/// \param v the input value
+/// \param k the searched 1-bit, \f$1 \leq k \leq 64\f$
+/// \return the position of the k-th 1-bit (LSBF and zero-based),
+///         or \ref SELECT_FAIL if no such bit exists
+inline uint8_t select1_word(uint64_t v, uint8_t k) {
+    DCHECK(k > 0 && k <= 64) << "order must be between 1 and 64";
+#ifdef __BMI2__
+    v = _pdep_u64(1ULL << (k - 1), v);
+#else
+    for(; k > 1 && v; --k) v &= v - 1;
+#endif
+    return v ? uint8_t(__builtin_ctzll(v)) : SELECT_FAIL;
+}
+
+/// \brief Finds the position of the k-th 0-bit in a 64-bit word without
+///        scanning.
+///
+/// \see select1_word
+inline uint8_t select0_word(uint64_t v, uint8_t k) {
+    return select1_word(~v, k);
+}
+
 }
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tudocomp/Generator.hpp>
+
+namespace tdc {
+
+/// \brief Streams a word of a sequence in which every word is the
+///        concatenation of two preceding words, e.g., the Fibonacci words.
+///
+/// Words up to \ref max_materialized characters are kept in memory. Longer
+/// words are expanded on the fly using a stack of pending words, which
+/// holds at most one entry per word of the sequence.
+class ConcatWordStream {
+public:
+    /// \brief Yields the indices `(a, b)` such that word `k` is the
+    ///        concatenation of the words `a` and `b`, with `a, b < k`.
+    using rule_fn_t = std::function<std::pair<size_t, size_t>(size_t k)>;
+
+    /// The maximum length of the words kept in memory.
+    static constexpr size_t max_materialized = 1ULL << 16;
+
+private:
+    std::shared_ptr<std::vector<std::string>> m_words;
+    rule_fn_t m_rule;
+    size_t m_k;
+    size_t m_length;
+
+    class Fill {
+        std::shared_ptr<std::vector<std::string>> m_words;
+        rule_fn_t m_rule;
+        std::vector<size_t> m_pending;
+        size_t m_offset = 0;
+
+    public:
+        inline Fill(const ConcatWordStream& s)
+            : m_words(s.m_words), m_rule(s.m_rule), m_pending { s.m_k } {
+        }
+
+        inline size_t operator()(char* buf, size_t n) {
+            size_t written = 0;
+            while(written < n && !m_pending.empty()) {
+                const size_t k = m_pending.back();
+                if(k < m_words->size()) {
+                    const std::string& w = (*m_words)[k];
+                    const size_t len = std::min(n - written, w.size() - m_offset);
+                    std::memcpy(buf + written, w.data() + m_offset, len);
+                    written += len;
+                    m_offset += len;
+                    if(m_offset == w.size()) {
+                        m_pending.pop_back();
+                        m_offset = 0;
+                    }
+                } else {
+                    const auto r = m_rule(k);
+                    m_pending.pop_back();
+                    m_pending.push_back(r.second);
+                    m_pending.push_back(r.first);
+                }
+            }
+            return written;
+        }
+    };
+
+public:
+    /// \brief Constructor.
+    ///
+    /// \param base the first words of the sequence, which are not
+    ///             defined by the rule.
+    /// \param rule the rule defining the remaining words.
+    /// \param k the index of the word to stream.
+    inline ConcatWordStream(std::vector<std::string> base, rule_fn_t rule, size_t k)
+        : m_words(std::make_shared<std::vector<std::string>>(std::move(base))),
+          m_rule(rule), m_k(k) {
+
+        auto& words = *m_words;
+        DCHECK(!words.empty());
+
+        std::vector<size_t> lengths;
+        for(auto& w : words) lengths.push_back(w.size());
+
+        for(size_t i = words.size(); i <= k; ++i) {
+            const auto r = rule(i);
+            DCHECK_LT(r.first, i);
+            DCHECK_LT(r.second, i);
+            CHECK_GE(lengths[r.first] + lengths[r.second], lengths[r.first])
+                << "word length exceeds the address space";
+            lengths.push_back(lengths[r.first] + lengths[r.second]);
+
+            if(words.size() == i && lengths[i] <= max_materialized) {
+                words.push_back(words[r.first] + words[r.second]);
+            }
+        }
+        m_length = lengths[k];
+    }
+
+    /// \brief The length of the streamed word.
+    inline size_t length() const {
+        return m_length;
+    }
+
+    /// \brief Provides the word as a streaming input.
+    inline Input input() const {
+        const ConcatWordStream s = *this;
+        return Generator::stream_input([s]() {
+            return io::ChunkStream::fill_fn_t(Fill(s));
+        }, m_length);
+    }
+
+    /// \brief Generates the word in memory.
+    inline std::string str() const {
+        std::string w(m_length, 0);
+        Fill(*this)(&w[0], m_length);
+        return w;
+    }
+};
+
+} //ns
+
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <tudocomp/Generator.hpp>
+#include <tudocomp/generators/ConcatWordStream.hpp>
 
 namespace tdc {
 
@@ -16,7 +17,7 @@ public:
 
     inline static std::string generate(size_t n) {
         if(n == 1) return "b";
-	    if(n == 2) return "a";
+	    if(n <= 2) return "a";
 
 	    std::string vold = "b";
 	    std::string old = "a";
@@ -35,11 +36,23 @@ public:
 	    return old;
     }
 
+    /// \brief Streams the n-th Fibonacci word without keeping it in memory.
+    inline static Input input(size_t n) {
+        return ConcatWordStream(
+            { "", "b", "a" },
+            [](size_t k) { return std::make_pair(k - 1, k - 2); },
+            (n == 0) ? 2 : n).input();
+    }
+
     using Generator::Generator;
 
     inline virtual std::string generate() override {
         return generate(env().option("n").as_integer());
     }
+
+    inline virtual Input input() override {
+        return input(env().option("n").as_integer());
+    }
 };
 
 } //ns
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <chrono>
+#include <cstring>
 #include <random>
 #include <tudocomp/Generator.hpp>
+#include <tudocomp/util/Parallel.hpp>
 
 namespace tdc {
 
@@ -14,35 +16,104 @@ namespace tdc {
 ///
 /// A seed of zero (default) will result in a seed obtained from the system
 /// clock.
+///
+/// The string is generated in blocks of \ref block_size characters, each
+/// drawn from an own engine seeded by the seed and the block number. Hence,
+/// the blocks can be generated in parallel (see the `threads` parameter)
+/// and the string only depends on the seed, not on the amount of threads.
 class RandomUniformGenerator : public Generator {
 
 public:
+    /// The amount of characters drawn from the same engine.
+    static constexpr size_t block_size = 1ULL << 20;
+
     inline static Meta meta() {
         Meta m("generator", "random", "Generates random strings.");
         m.option("length").dynamic();
         m.option("seed").dynamic(0);
         m.option("min").dynamic('0');
         m.option("max").dynamic('9');
+        m.option("threads").dynamic(0);
         return m;
     }
 
-    inline static std::string generate(
-        size_t length, size_t seed = 0, size_t min = '0', size_t max = '9') {
+    /// \brief Generates the blocks `[first, last)` of the string into `out`.
+    inline static void generate_blocks(
+        char* out, size_t length, size_t first, size_t last,
+        size_t seed, size_t min, size_t max, size_t threads = 0) {
 
         if(min > max) std::swap(min, max);
-        if(!seed) seed = std::chrono::system_clock::now().time_since_epoch().count();
 
-        std::string s(length,0);
-        std::default_random_engine engine(seed);
-        std::uniform_int_distribution<char> dist(min, max);
+        #pragma omp parallel for num_threads(threads_for(last - first, 1, threads))
+        for(size_t b = first; b < last; ++b) {
+            std::seed_seq seq {
+                uint32_t(seed), uint32_t(seed >> 32), uint32_t(b), uint32_t(b >> 32)
+            };
+            std::default_random_engine engine(seq);
+            std::uniform_int_distribution<char> dist(min, max);
+
+            const size_t begin = b * block_size;
+            const size_t end = std::min(length, begin + block_size);
 
-        for(size_t i = 0; i < length; ++i) {
-            s[i] = dist(engine);
+            char* o = out + (b - first) * block_size;
+            for(size_t i = begin; i < end; ++i) {
+                *o++ = dist(engine);
+            }
         }
+    }
+
+    inline static std::string generate(
+        size_t length, size_t seed = 0, size_t min = '0', size_t max = '9',
+        size_t threads = 0) {
+
+        if(!seed) seed = std::chrono::system_clock::now().time_since_epoch().count();
+
+        std::string s(length,0);
+        generate_blocks(&s[0], length, 0, idiv_ceil(length, block_size),
+            seed, min, max, threads);
 
         return s;
     }
 
+    /// \brief Streams the string generated by \ref generate without keeping
+    ///        it in memory.
+    ///
+    /// Up to `threads` blocks are generated in parallel at a time.
+    inline static Input input(
+        size_t length, size_t seed = 0, size_t min = '0', size_t max = '9',
+        size_t threads = 0) {
+
+        // every stream has to yield the same string
+        if(!seed) seed = std::chrono::system_clock::now().time_since_epoch().count();
+
+        const size_t num_blocks = idiv_ceil(length, block_size);
+        const size_t team = threads_for(num_blocks, 1, threads);
+
+        return stream_input([=]() {
+            std::vector<char> chunk(team * block_size);
+            size_t next = 0, pos = 0, filled = 0;
+
+            return [=](char* buf, size_t n) mutable {
+                if(pos == filled) {
+                    const size_t last = std::min(num_blocks, next + team);
+                    generate_blocks(chunk.data(), length, next, last,
+                        seed, min, max, team);
+
+                    filled = (last > next)
+                        ? std::min(length, last * block_size) - next * block_size
+                        : 0;
+                    pos = 0;
+                    next = last;
+                }
+
+                n = std::min(n, filled - pos);
+                std::memcpy(buf, chunk.data() + pos, n);
+                pos += n;
+                return n;
+            };
+        }, length);
+    }
+
     using Generator::Generator;
 
     inline virtual std::string generate() override {
@@ -50,7 +121,17 @@ public:
             env().option("length").as_integer(),
             env().option("seed").as_integer(),
             env().option("min").as_integer(),
-            env().option("max").as_integer());
+            env().option("max").as_integer(),
+            env().option("threads").as_integer());
+    }
+
+    inline virtual Input input() override {
+        return input(
+            env().option("length").as_integer(),
+            env().option("seed").as_integer(),
+            env().option("min").as_integer(),
+            env().option("max").as_integer(),
+            env().option("threads").as_integer());
     }
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <tudocomp/Generator.hpp>
+#include <tudocomp/generators/ConcatWordStream.hpp>
 
 namespace tdc {
 
@@ -36,11 +37,27 @@ public:
         return t3;
     }
 
+    /// \brief Streams the string generated by \ref generate(size_t) without
+    ///        keeping it in memory.
+    inline static Input input(size_t n) {
+        const std::string t2 = "01101011010010110101101", t1 = "0110101101001";
+        return ConcatWordStream(
+            { "0110101101001011010", t1, t2, t2 + t1 },
+            [](size_t k) {
+                return std::make_pair(k - 1, (k % 3 == 0) ? (k - 2) : (k - 4));
+            },
+            (n <= 3) ? n : (n - 1)).input();
+    }
+
     using Generator::Generator;
 
     inline virtual std::string generate() override {
         return generate(env().option("n").as_integer());
     }
+
+    inline virtual Input input() override {
+        return input(env().option("n").as_integer());
+    }
 };
 
 } //ns
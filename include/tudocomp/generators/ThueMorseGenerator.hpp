@@ -34,11 +34,36 @@ public:
         return a;
     }
 
+    /// \brief Streams the n-th Thue Morse word without keeping it in memory.
+    ///
+    /// The i-th character is the parity of the amount of 1-bits in i.
+    inline static Input input(size_t n) {
+        CHECK_LT(n, 64) << "too long!";
+
+        const size_t length = 1ULL << ((n == 0) ? 0 : (n - 1));
+        return stream_input([length]() {
+            size_t pos = 0;
+            return [length, pos](char* buf, size_t k) mutable {
+                const size_t end = std::min(length, pos + k);
+                for(size_t i = pos; i < end; ++i) {
+                    *buf++ = (__builtin_popcountll(i) & 1) ? '1' : '0';
+                }
+                k = end - pos;
+                pos = end;
+                return k;
+            };
+        }, length);
+    }
+
     using Generator::Generator;
 
     inline virtual std::string generate() override {
         return generate(env().option("n").as_integer());
     }
+
+    inline virtual Input input() override {
+        return input(env().option("n").as_integer());
+    }
 };
 
 } //ns
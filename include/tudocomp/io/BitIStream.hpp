@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <vector>
 #include <tudocomp/util.hpp>
 
 namespace tdc {
@@ -11,73 +14,98 @@ namespace io {
 /// \brief Wrapper for input streams that provides bitwise reading
 /// functionality.
 ///
-/// The current byte in the underlying input stream is buffered and processed
-/// bitwise using another cursor.
+/// The underlying input stream is read in blocks of \ref block_size bytes.
+/// Reads are served from a window of the next 64 bits of the block, so
+/// integers and codes are read at once instead of bit by bit.
+///
+/// The end of the bit stream is marked by the last byte as written by
+/// \ref BitOStream. Until it is known, the last two bytes of a block are
+/// held back, because they may turn out to be that mark.
 class BitIStream {
-    InputStream m_stream;
-
-    uint8_t m_current = 0;
-    uint8_t m_next = 0;
-
-    bool m_is_final = false;
-    uint8_t m_final_bits = 0;
-
-    uint8_t m_cursor = 0;
-
-    inline void read_next() {
-        const uint8_t MSB = 7;
-
-        m_current = m_next;
-        m_cursor = MSB;
+public:
+    /// The amount of bytes read from the underlying stream at once.
+    static constexpr size_t block_size = 1ULL << 16;
 
-        char c;
-        if(m_stream.get(c)) {
-            m_next = c;
+private:
+    // bytes behind the valid ones in the buffer, such that windows can be
+    // loaded without checking for the end of the buffer
+    static constexpr size_t padding = 16;
 
-            if(m_stream.get(c)) {
-                /*DLOG(INFO) << "read_next: ...";*/
+    InputStream m_stream;
 
-                // stream still going
-                m_stream.unget();
+    std::vector<uint8_t> m_buffer;
+    size_t m_size = 0;  // valid bytes in the buffer
+    uint64_t m_pos = 0; // bit position of the next bit in the buffer
+    uint64_t m_end = 0; // bit position behind the last readable bit
+    bool m_final = false; // whether the underlying stream is exhausted
+
+    inline void refill() {
+        // keep the bytes not read entirely
+        const size_t first = size_t(m_pos / 8);
+        std::memmove(m_buffer.data(), m_buffer.data() + first, m_size - first);
+        m_size -= first;
+        m_pos -= uint64_t(first) * 8;
+
+        m_stream.read((char*) m_buffer.data() + m_size, block_size - m_size);
+        const size_t got = size_t(m_stream.gcount());
+        m_size += got;
+        m_final = (got == 0) || !m_stream;
+        std::fill(m_buffer.data() + m_size, m_buffer.data() + m_size + padding, 0);
+
+        if(m_final) {
+            // the low three bits of the last byte are the amount of bits
+            // used in the byte, or in the byte before if it is 6 or 7
+            const size_t final_bits = m_size ? (m_buffer[m_size - 1] & 0x7) : 0;
+            if(m_size == 0) {
+                m_end = 0;
+            } else if(final_bits >= 6) {
+                m_end = (m_size >= 2) ? uint64_t(m_size - 2) * 8 + final_bits : 0;
             } else {
-                // stream over after next, do some checks
-                m_final_bits = c;
-                m_final_bits &= 0x7;
-                if(m_final_bits >= 6) {
-                    // special case - already final
-                    m_is_final = true;
-                    m_next = 0;
-                    /*DLOG(INFO) << "read_next: EOF*" <<
-                        ", m_final_bits := " << size_t(m_final_bits);*/
-                }
+                m_end = uint64_t(m_size - 1) * 8 + final_bits;
             }
+            m_end = std::max(m_end, m_pos);
         } else {
-            m_is_final = true;
-            m_final_bits = m_current & 0x7;
+            m_end = uint64_t(m_size - 2) * 8;
+        }
+    }
 
-            m_next = 0;
+    /// Returns the next 64 bits, MSB first. Bits behind the end are zero.
+    inline uint64_t peek() const {
+        const uint8_t* p = m_buffer.data() + (m_pos / 8);
+        const size_t offset = size_t(m_pos % 8);
+
+        uint64_t window;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        std::memcpy(&window, p, sizeof(window));
+        window = __builtin_bswap64(window);
+#else
+        window = 0;
+        for(size_t i = 0; i < 8; ++i) window = (window << 8) | p[i];
+#endif
+        if(offset) window = (window << offset) | (p[8] >> (8 - offset));
+
+        const uint64_t avail = m_end - m_pos;
+        return (avail < 64) ? (window & ~(~uint64_t(0) >> avail)) : window;
+    }
 
-            /*DLOG(INFO) << "read_next: EOF" <<
-                ", m_final_bits := " << size_t(m_final_bits);*/
-        }
+    /// Advances by `bits` bits, which must not exceed the end.
+    inline void consume(size_t bits) {
+        m_pos += bits;
+        if(tdc_unlikely(m_end - m_pos < 64 && !m_final)) refill();
+    }
+
+    /// The amount of bits left to read in the window.
+    inline size_t available() const {
+        return size_t(std::min(m_end - m_pos, uint64_t(64)));
     }
 
 public:
     /// \brief Constructs a bitwise input stream.
     ///
     /// \param input The underlying input stream.
-    inline BitIStream(InputStream&& input) : m_stream(std::move(input)) {
-        char c;
-        if(m_stream.get(c)) {
-            m_is_final = false;
-            m_next = c;
-
-            read_next();
-        } else {
-            //empty stream
-            m_is_final = true;
-            m_final_bits = 0;
-        }
+    inline BitIStream(InputStream&& input)
+        : m_stream(std::move(input)), m_buffer(block_size + padding, 0) {
+        refill();
     }
 
     /// \brief Constructs a bitwise input stream.
@@ -89,27 +117,18 @@ public:
     /// \brief Reads the next single bit from the input.
     /// \return 1 if the next bit is set, 0 otherwise.
     inline uint8_t read_bit() {
-        /*DLOG(INFO) <<"read_bit: " <<
-                "m_is_final = " << m_is_final <<
-                ", m_final_bits = " << size_t(m_final_bits) <<
-                ", m_cursor = " << size_t(m_cursor);*/
-
-        if(!eof()) {
-            uint8_t bit = (m_current >> m_cursor) & 1;
-            if(m_cursor) {
-                --m_cursor;
-            } else {
-                read_next();
-            }
+        if(eof()) return 0; //EOF
 
-            return bit;
-        } else {
-            return 0; //EOF
-        }
+        const uint8_t bit = (m_buffer[m_pos / 8] >> (7 - m_pos % 8)) & 1;
+        consume(1);
+        return bit;
     }
 
     /// \brief Reads the integer value of the next \c amount bits in MSB first
     ///        order.
+    ///
+    /// Bits behind the end of the input are read as zero.
+    ///
     /// \tparam The integer type to read.
     /// \param amount The bit width of the integer to read. By default, this
     ///               equals the bit width of type \c T.
@@ -117,18 +136,49 @@ public:
     ///         order.
     template<class T>
     inline T read_int(size_t amount = sizeof(T) * CHAR_BIT) {
-        T value = 0;
-        for(size_t i = 0; i < amount; i++) {
-            value <<= 1;
-            value |= read_bit();
+        DCHECK_LE(amount, 64U);
+        if(amount == 0) return T(0);
+
+        const uint64_t value = peek() >> (64 - amount);
+        consume(std::min(amount, available()));
+        return T(value);
+    }
+
+    /// \brief Reads a sequence of bytes written by
+    ///        \ref BitOStream::write_bytes.
+    ///
+    /// \param bytes The buffer to read the bytes into.
+    /// \param n The amount of bytes to read.
+    inline void read_bytes(uint8_t* bytes, size_t n) {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const uint64_t word = read_int<uint64_t>(64);
+            for (size_t j = 0; j < 8; ++j) bytes[i + j] = uint8_t(word >> (56 - 8 * j));
+        }
+        for (; i < n; ++i) {
+            bytes[i] = read_int<uint8_t>(8);
         }
-        return value;
     }
 
+    /// \brief Reads a unary code, i.e., the amount of 0-bits before the
+    ///        next 1-bit.
+    ///
+    /// The 0-bits are counted a window at a time.
     template<typename value_t>
     inline value_t read_unary() {
         value_t v = 0;
-        while(!read_bit()) ++v;
+        while(!eof()) {
+            const uint64_t window = peek();
+            if(window) {
+                const size_t zeros = __builtin_clzll(window);
+                consume(zeros + 1);
+                return v + value_t(zeros);
+            }
+
+            const size_t bits = available();
+            v += value_t(bits);
+            consume(bits);
+        }
         return v;
     }
 
@@ -149,14 +199,45 @@ public:
         return v;
     }
 
+    /// \brief Reads an Elias-gamma code.
+    ///
+    /// If the code fits into the window, it is decoded from the window at
+    /// once.
     template<typename value_t>
     inline value_t read_elias_gamma() {
+        const uint64_t window = peek();
+        if(tdc_likely(window)) {
+            const size_t bits = __builtin_clzll(window);
+            const size_t len = 2 * bits + 1;
+            if(tdc_likely(bits > 0 && len <= available())) {
+                consume(len);
+                return value_t((window << (bits + 1)) >> (64 - bits));
+            }
+        }
+
         auto bits = read_unary<size_t>();
         return read_int<value_t>(bits);
     }
 
+    /// \brief Reads an Elias-delta code.
+    ///
+    /// If the code fits into the window, it is decoded from the window at
+    /// once.
     template<typename value_t>
     inline value_t read_elias_delta() {
+        const uint64_t window = peek();
+        if(tdc_likely(window)) {
+            const size_t bits_bits = __builtin_clzll(window);
+            const size_t gamma_len = 2 * bits_bits + 1;
+            if(tdc_likely(bits_bits > 0 && gamma_len <= available())) {
+                const size_t bits = size_t((window << (bits_bits + 1)) >> (64 - bits_bits));
+                if(tdc_likely(bits > 0 && gamma_len + bits <= available())) {
+                    consume(gamma_len + bits);
+                    return value_t((window << gamma_len) >> (64 - bits));
+                }
+            }
+        }
+
         auto bits = read_elias_gamma<size_t>();
         return read_int<value_t>(bits);
     }
@@ -187,9 +268,9 @@ public:
         return T(value);
     }
 
-    /// TODO document
+    /// \brief Tests whether all bits of the input have been read.
     inline bool eof() const {
-        return m_is_final && m_cursor <= (7 - m_final_bits);
+        return m_pos >= m_end;
     }
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
 #include <cstdint>
 #include <iostream>
@@ -96,18 +97,146 @@ public:
     ///             this equals the bit width of type \c T.
     template<class T>
     inline void write_int(T value, size_t bits = sizeof(T) * CHAR_BIT) {
-        for (int i = bits - 1; i >= 0; i--) {
-            write_bit((value & T(T(1) << i)) != T(0));
+        DCHECK_LE(bits, 64U);
+        if (bits == 0) return;
+
+        // the word must hold the pending bits and the integer
+        if (bits > 56) {
+            write_int(uint64_t(value) >> 32, bits - 32);
+            write_int(uint32_t(value), 32);
+            return;
+        }
+
+        const uint64_t v = uint64_t(value) & ((uint64_t(1) << bits) - 1);
+        const size_t free = m_cursor + 1;
+        if (bits < free) {
+            // the integer fits into the buffer byte
+            m_next |= uint8_t(v << (free - bits));
+            m_cursor -= bits;
+            m_dirty = true;
+            return;
+        }
+
+        // write all completed bytes at once
+        size_t len = 8 - free + bits;
+        const uint64_t word = (uint64_t(m_next >> free) << bits) | v;
+
+        char bytes[8];
+        size_t c = 0;
+        while (len >= 8) {
+            len -= 8;
+            bytes[c++] = char(word >> len);
         }
+        m_stream.rdbuf()->sputn(bytes, c);
+
+        // keep the remaining bits in the buffer byte
+        m_next = uint8_t(word << (8 - len));
+        m_cursor = 7 - int(len);
+        m_dirty = (len > 0);
     }
 
-    template<typename value_t>
-    inline void write_unary(value_t v) {
-        while(v--) {
-            write_bit(0);
+    /// \brief Writes a sequence of integers of the same bit width.
+    ///
+    /// This is equivalent to writing `values[i] - min` for each value using
+    /// \ref write_int, but the bits are collected in a word and written to
+    /// the underlying stream in chunks of bytes.
+    ///
+    /// \tparam The type of integers to write.
+    /// \param values The integers to write.
+    /// \param n The amount of integers to write.
+    /// \param bits The amount of low bits to write of each integer.
+    /// \param min The value subtracted from each integer before writing.
+    template<class T>
+    inline void write_ints(const T* values, size_t n, size_t bits, uint64_t min = 0) {
+        DCHECK_LE(bits, 64U);
+        if (n == 0 || bits == 0) return;
+
+        // the word must hold the pending bits and another integer
+        if (bits > 56) {
+            for (size_t i = 0; i < n; ++i) write_int(uint64_t(values[i]) - min, bits);
+            return;
         }
 
-        write_bit(1);
+        const uint64_t mask = (uint64_t(1) << bits) - 1;
+
+        // start with the bits pending in the buffer byte
+        size_t len = 7 - m_cursor;
+        uint64_t word = m_next >> (m_cursor + 1);
+
+        char chunk[256];
+        size_t c = 0;
+
+        for (size_t i = 0; i < n; ++i) {
+            word = (word << bits) | ((uint64_t(values[i]) - min) & mask);
+            len += bits;
+
+            while (len >= 8) {
+                len -= 8;
+                chunk[c++] = char(word >> len);
+            }
+
+            if (c > sizeof(chunk) - 8) {
+                m_stream.write(chunk, c);
+                c = 0;
+            }
+        }
+        m_stream.write(chunk, c);
+
+        // keep the remaining bits in the buffer byte
+        m_next = uint8_t(word << (8 - len));
+        m_cursor = 7 - int(len);
+        m_dirty = (len > 0);
+    }
+
+    /// \brief Writes a sequence of bytes to the output.
+    ///
+    /// This is equivalent to writing each byte using \ref write_int, but
+    /// bypasses the buffer byte if no bits are pending.
+    ///
+    /// \param bytes The bytes to write.
+    /// \param n The amount of bytes to write.
+    inline void write_bytes(const uint8_t* bytes, size_t n) {
+        if (!m_dirty) {
+            m_stream.write((const char*) bytes, n);
+            return;
+        }
+
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t word = 0;
+            for (size_t j = 0; j < 8; ++j) word = (word << 8) | bytes[i + j];
+            write_int(word, 64);
+        }
+        for (; i < n; ++i) {
+            write_int(bytes[i], 8);
+        }
+    }
+
+    /// \brief Returns the amount of bits written that are held back in the
+    ///        buffer byte, i.e., not yet written to the underlying stream.
+    inline size_t pending_bits() const {
+        return 7 - m_cursor;
+    }
+
+    /// \brief Removes the bits held back in the buffer byte.
+    ///
+    /// Together with \ref pending_bits, this allows to move the contents of
+    /// a bit stream to another one, e.g., via \ref write_bytes.
+    ///
+    /// \return The removed bits, stored in the lowest \ref pending_bits
+    ///         bits.
+    inline uint8_t take_pending_bits() {
+        const uint8_t bits = uint8_t(m_next >> (m_cursor + 1));
+        reset();
+        return bits;
+    }
+
+    /// \brief Writes a unary code, i.e., \c v 0-bits followed by a 1-bit.
+    template<typename value_t>
+    inline void write_unary(value_t v) {
+        uint64_t zeros = uint64_t(v);
+        for(; zeros >= 64; zeros -= 64) write_int(0, 64);
+        write_int(1, zeros + 1);
     }
 
     template<typename value_t>
@@ -122,16 +251,38 @@ public:
         write_int(3, 2); // terminator -> 11
     }
 
+    /// \brief Writes an Elias-gamma code, i.e., the bit width of \c v in
+    ///        unary followed by the bits of \c v.
+    ///
+    /// Codes of up to 64 bits are written at once.
     template<typename value_t>
     inline void write_elias_gamma(value_t v) {
-        write_unary(bits_for(v));
-        write_int(v, bits_for(v));
+        const uint64_t u = uint64_t(v);
+        const size_t bits = bits_for(u);
+        if(bits < 32) {
+            write_int((uint64_t(1) << bits) | u, 2 * bits + 1);
+        } else {
+            write_unary(bits);
+            write_int(u, bits);
+        }
     }
 
+    /// \brief Writes an Elias-delta code, i.e., the bit width of \c v as an
+    ///        Elias-gamma code followed by the bits of \c v.
+    ///
+    /// Codes of up to 64 bits are written at once.
     template<typename value_t>
     inline void write_elias_delta(value_t v) {
-        write_elias_gamma(bits_for(v));
-        write_int(v, bits_for(v));
+        const uint64_t u = uint64_t(v);
+        const size_t bits = bits_for(u);
+        const size_t bits_bits = bits_for(bits);
+        const size_t len = 2 * bits_bits + 1 + bits;
+        if(len <= 64) {
+            write_int((((uint64_t(1) << bits_bits) | bits) << bits) | u, len);
+        } else {
+            write_elias_gamma(bits);
+            write_int(u, bits);
+        }
     }
 
     /// \brief Writes a compressed integer to the input.
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <functional>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+namespace tdc {
+namespace io {
+
+/// \brief An input stream whose contents are produced chunk by chunk.
+///
+/// Whenever the buffered chunk has been read completely, the fill function
+/// is called to write the next characters into the buffer. Hence, the
+/// stream's contents never need to be held in memory as a whole.
+class ChunkStream : public std::istream {
+public:
+    /// \brief Writes up to `n` next characters of the stream into `buf`.
+    ///
+    /// Returns the amount of characters written. A return value of zero
+    /// signals the end of the stream.
+    using fill_fn_t = std::function<size_t(char* buf, size_t n)>;
+
+    /// The default chunk size in bytes.
+    static constexpr size_t default_chunk_size = 1ULL << 16;
+
+private:
+    class Buf : public std::streambuf {
+        fill_fn_t m_fill;
+        std::vector<char> m_chunk;
+
+    public:
+        inline Buf(fill_fn_t fill, size_t chunk_size)
+            : m_fill(std::move(fill)), m_chunk(chunk_size) {
+        }
+
+    protected:
+        inline virtual int_type underflow() override {
+            if(gptr() < egptr()) {
+                return traits_type::to_int_type(*gptr());
+            }
+
+            const size_t n = m_fill(m_chunk.data(), m_chunk.size());
+            if(n == 0) return traits_type::eof();
+
+            setg(m_chunk.data(), m_chunk.data(), m_chunk.data() + n);
+            return traits_type::to_int_type(*gptr());
+        }
+    };
+
+    Buf m_buf;
+
+public:
+    /// \brief Constructs the stream.
+    ///
+    /// \param fill the function producing the stream's contents.
+    /// \param chunk_size the maximum amount of characters requested from
+    ///                   the fill function at once.
+    inline ChunkStream(fill_fn_t fill, size_t chunk_size = default_chunk_size)
+        : std::istream(nullptr), m_buf(std::move(fill), chunk_size) {
+        rdbuf(&m_buf);
+    }
+
+    ChunkStream(const ChunkStream&) = delete;
+};
+
+}}
+
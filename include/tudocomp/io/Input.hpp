@@ -158,6 +158,18 @@ namespace tdc {namespace io {
         Input(std::istream& stream):
             m_data(std::make_shared<Variant>(InputSource(&stream))) {}
 
+        /// \brief Constructs an input whose data is generated on demand.
+        ///
+        /// Every stream on the input obtains a new stream from the given
+        /// function, such that the data never needs to be held in memory
+        /// as a whole. Only views are backed by a buffer.
+        ///
+        /// \param open The function opening a new stream on the data.
+        ///             Every call has to yield the same data.
+        /// \param size The amount of characters in the data, if known.
+        Input(const InputSource::open_fn_t& open, size_t size = npos):
+            m_data(std::make_shared<Variant>(InputSource(open, size))) {}
+
         /// \brief Move assignment operator.
         Input& operator=(Input&& other) {
             m_data = std::move(other.m_data);
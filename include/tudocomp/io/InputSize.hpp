@@ -44,6 +44,24 @@ namespace tdc {namespace io {
                 }
             }
 
+        } else if (source().is_generated()) {
+
+            if(escaped_size_unknown()) {
+                const size_t size = source().generated_size();
+                if(restrictions().has_no_restrictions() && size != npos) {
+                    set_escaped_size((to_unknown() ? size : to()) - from());
+                } else {
+                    auto strm = as_stream();
+                    size_t i = 0;
+                    char c;
+                    while (strm.get(c)) {
+                        ++i;
+                    }
+
+                    set_escaped_size(i);
+                }
+            }
+
         } else if (source().is_stream()) {
             if(escaped_size_unknown()) {
                 auto p = alloc().find_or_construct(
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <tudocomp/util/View.hpp>
 
@@ -8,20 +10,32 @@ namespace tdc {namespace io {
     /// Class that stores the source of input data.
     ///
     /// This can store either the path of a file, a view into memory,
-    /// or a pointer to a `std::istream`.
+    /// a pointer to a `std::istream`, or a function that generates the
+    /// input data as a stream.
     class InputSource {
     public:
         enum class Content {
             View,
             File,
-            Stream
+            Stream,
+            Generated
         };
+
+        /// Opens a new stream yielding the generated input data.
+        ///
+        /// Every call has to yield the same data.
+        using open_fn_t = std::function<std::unique_ptr<std::istream>()>;
+
+        static constexpr size_t npos = -1;
     private:
         Content       m_content;
 
         View          m_view = ""_v;
         std::string   m_path = "";
         std::istream* m_stream = nullptr;
+
+        std::shared_ptr<open_fn_t> m_open;
+        size_t        m_generated_size = npos;
     public:
         friend inline bool operator==(const InputSource&, const InputSource&);
 
@@ -34,10 +48,15 @@ namespace tdc {namespace io {
         inline InputSource(std::istream* stream):
             m_content(Content::Stream),
             m_stream(stream) {}
+        inline InputSource(const open_fn_t& open, size_t size):
+            m_content(Content::Generated),
+            m_open(std::make_shared<open_fn_t>(open)),
+            m_generated_size(size) {}
 
         inline bool is_view() const { return m_content == Content::View; }
         inline bool is_stream() const { return m_content == Content::Stream; }
         inline bool is_file() const { return m_content == Content::File; }
+        inline bool is_generated() const { return m_content == Content::Generated; }
 
         inline const View& view() const {
             DCHECK(is_view());
@@ -53,6 +72,17 @@ namespace tdc {namespace io {
             DCHECK(is_file());
             return m_path;
         }
+
+        inline std::unique_ptr<std::istream> open() const {
+            DCHECK(is_generated());
+            return (*m_open)();
+        }
+
+        /// The amount of generated characters, or npos if unknown.
+        inline size_t generated_size() const {
+            DCHECK(is_generated());
+            return m_generated_size;
+        }
     };
 
     inline bool operator==(const InputSource& lhs, const InputSource& rhs) {
@@ -60,7 +90,8 @@ namespace tdc {namespace io {
             && lhs.m_view.data() == rhs.m_view.data()
             && lhs.m_view.size() == rhs.m_view.size()
             && lhs.m_path == rhs.m_path
-            && lhs.m_stream == rhs.m_stream;
+            && lhs.m_stream == rhs.m_stream
+            && lhs.m_open == rhs.m_open;
     }
 
     inline std::ostream& operator<<(std::ostream& o, const InputSource& v) {
@@ -75,6 +106,9 @@ namespace tdc {namespace io {
         if (v.is_file()) {
             return o << "{ file:   " << v.file() << " }";
         }
+        if (v.is_generated()) {
+            return o << "{ generated with len " << v.generated_size() << " }";
+        }
         return o;
     }
 }}
@@ -69,6 +69,29 @@ namespace tdc {namespace io {
             inline File() = delete;
         };
 
+        class Generated: public InputStreamInternal::Variant {
+            std::unique_ptr<std::istream> m_stream;
+
+            friend class InputStreamInternal;
+        public:
+            inline Generated(std::unique_ptr<std::istream>&& stream, size_t offset):
+                m_stream(std::move(stream))
+            {
+                m_stream->ignore(offset);
+            }
+
+            inline Generated(Generated&& other):
+                m_stream(std::move(other.m_stream))
+            {}
+
+            inline std::istream& stream() override {
+                return *m_stream;
+            }
+
+            inline Generated(const Generated& other) = delete;
+            inline Generated() = delete;
+        };
+
         std::unique_ptr<InputStreamInternal::Variant> m_variant;
         std::unique_ptr<RestrictedIStreamBuf> m_restricted_istream;
 
@@ -100,6 +123,17 @@ namespace tdc {namespace io {
                 );
             }
         }
+        inline InputStreamInternal(InputStreamInternal::Generated&& g,
+                                   const InputRestrictions& restrictions):
+            m_variant(std::make_unique<InputStreamInternal::Generated>(std::move(g)))
+        {
+            if (!restrictions.has_no_restrictions()) {
+                m_restricted_istream = std::make_unique<RestrictedIStreamBuf>(
+                    m_variant->stream(),
+                    restrictions
+                );
+            }
+        }
         inline InputStreamInternal(InputStreamInternal&& s):
             m_variant(std::move(s.m_variant)),
             m_restricted_istream(std::move(s.m_restricted_istream)) {}
@@ -160,6 +194,19 @@ namespace tdc {namespace io {
                     restrictions()
                 }
             };
+        } if (source().is_generated()) {
+            DCHECK(to_unknown())
+                << "TODO: Can not yet slice the trailing end of a stream";
+
+            return InputStream {
+                InputStreamInternal {
+                    InputStream::Generated {
+                        source().open(),
+                        from()
+                    },
+                    restrictions()
+                }
+            };
         } if (source().is_view()) {
             return InputStream {
                 InputStreamInternal {
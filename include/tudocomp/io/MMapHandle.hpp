@@ -5,12 +5,15 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
 #include <tudocomp_stat/malloc.hpp>
 #include <tudocomp/def.hpp>
 #include <tudocomp/util/View.hpp>
 #include <tudocomp/io/IOUtil.hpp>
+#include <tudocomp/util/HugePages.hpp>
 
 /// \cond INTERNAL
 namespace tdc {namespace io {
@@ -42,6 +45,12 @@ namespace tdc {namespace io {
             }
             CHECK(ptr != MAP_FAILED) << "Error at " << descr;
         }
+
+        // the length of the actual mapping
+        inline size_t mapped_size() const {
+            return m_huge ? huge_pages::mapped_size(adj_size(m_size))
+                          : adj_size(m_size);
+        }
     public:
         enum class Mode {
             Read,
@@ -54,6 +63,9 @@ namespace tdc {namespace io {
         State    m_state = State::Unmapped;
         Mode     m_mode  = Mode::Read;
 
+        huge_pages::Policy m_policy = huge_pages::Policy::none;
+        bool     m_huge  = false;
+
     public:
         inline static bool is_offset_valid(size_t offset) {
             return (offset % pagesize()) == 0;
@@ -175,27 +187,39 @@ namespace tdc {namespace io {
         }
 
         /// Create a memory map of length `size`.
-        inline MMap(size_t size)
+        ///
+        /// If the huge page policy applies to the size, the map is backed
+        /// by huge pages and its length is rounded up to full huge pages.
+        inline MMap(size_t size,
+                    huge_pages::Policy policy = huge_pages::global_policy())
         {
             m_mode = Mode::ReadWrite;
             m_size = size;
-
-            int mmap_prot = PROT_READ | PROT_WRITE;
-            int mmap_flags = MAP_PRIVATE | MAP_ANONYMOUS;
-
-            void* ptr = mmap(NULL,
-                             adj_size(m_size),
-                             mmap_prot,
-                             mmap_flags,
-                             -1,
-                             0);
+            m_policy = policy;
+
+            void* ptr;
+            if (huge_pages::applies(m_policy, adj_size(m_size))) {
+                ptr = huge_pages::map(adj_size(m_size), m_policy);
+                if (!ptr) ptr = MAP_FAILED;
+                m_huge = true;
+            } else {
+                int mmap_prot = PROT_READ | PROT_WRITE;
+                int mmap_flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+                ptr = mmap(NULL,
+                           adj_size(m_size),
+                           mmap_prot,
+                           mmap_flags,
+                           -1,
+                           0);
+            }
             check_mmap_error(ptr, "creating anon. memory map");
 
             m_ptr = (uint8_t*) ptr;
 
             m_state = State::Private;
             IF_STATS(if (m_state == State::Private) {
-                malloc_callback::on_alloc(adj_size(m_size));
+                malloc_callback::on_alloc(mapped_size());
             })
         }
 
@@ -206,6 +230,16 @@ namespace tdc {namespace io {
             DCHECK(m_mode == Mode::ReadWrite);
             DCHECK(m_state == State::Private);
 
+            // Mappings backed by huge pages are copied into a new one, which
+            // keeps them aligned to huge pages
+            if (m_huge || huge_pages::applies(m_policy, adj_size(new_size))) {
+                MMap new_map(new_size, m_policy);
+                size_t common_size = std::min(new_size, m_size);
+                std::memcpy(new_map.m_ptr, m_ptr, common_size);
+                std::swap(*this, new_map);
+                return;
+            }
+
             // On Linux, use mremap to expand memory in place
             #ifndef __MACH__
 
@@ -224,7 +258,7 @@ namespace tdc {namespace io {
             // On Mac there is no mremap, so we just copy
             #else
 
-            auto new_map = MMap(new_size);
+            auto new_map = MMap(new_size, m_policy);
             size_t common_size = std::min(new_size, m_size);
             std::memcpy(new_map.view().data(), view().data(), common_size);
             *this = std::move(new_map);
@@ -254,9 +288,13 @@ namespace tdc {namespace io {
             m_state = other.m_state;
             m_mode  = other.m_mode;
 
+            m_policy = other.m_policy;
+            m_huge  = other.m_huge;
+
             other.m_state = State::Unmapped;
             other.m_ptr = (uint8_t*) EMPTY;
             other.m_size = 0;
+            other.m_huge = false;
         }
     public:
         inline MMap(MMap&& other) {
@@ -272,10 +310,10 @@ namespace tdc {namespace io {
             if (m_state != State::Unmapped) {
                 DCHECK(m_ptr != EMPTY);
 
-                int rc = munmap(m_ptr, adj_size(m_size));
+                int rc = munmap(m_ptr, mapped_size());
                 CHECK(rc == 0) << "Error at unmapping";
                 IF_STATS(if (m_state == State::Private) {
-                    malloc_callback::on_free(adj_size(m_size));
+                    malloc_callback::on_free(mapped_size());
                 })
             }
         }
@@ -105,6 +105,70 @@ namespace tdc {namespace io {
             return extra;
         }
 
+        /// Reads at most len bytes from the stream into a growing buffer.
+        inline void init_from_stream(std::istream& is, size_t len) {
+            // Start with a typical page size to not realloc as often
+            // for small inputs, or with the exact size if it is known
+            size_t capacity = (len != npos && len > 0) ? len : pagesize();
+            size_t size = 0;
+            size_t extra_size = 0;
+            FastEscapeMap fast_escape_map;
+            if (!m_restrictions.has_no_escape_restrictions()) {
+                fast_escape_map = FastEscapeMap {
+                    EscapeMap(m_restrictions)
+                };
+            }
+
+            size_t noff = m_restrictions.null_terminate()? 1 : 0;
+            extra_size += noff;
+
+            // Initial allocation
+
+            m_map = MMap(capacity);
+
+            // Fill and grow
+            {
+                bool done = false;
+
+                while(!done) {
+                    // fill until capacity
+                    uint8_t* ptr = m_map.view().begin() + size;
+                    while(size < capacity && size < len) {
+                        char c;
+                        if(!is.get(c)) {
+                            done = true;
+                            break;
+                        } else {
+                            *ptr = uint8_t(c);
+                            ++ptr;
+                            ++size;
+                            extra_size += fast_escape_map.lookup_flag(uint8_t(c));
+                        }
+                    }
+                    if (done || size == len) break;
+
+                    // realloc to greater size;
+                    capacity *= 2;
+                    m_map.remap(capacity);
+                }
+
+                // Throw away overallocation
+                // For null termination,
+                // a trailing unwritten byte is automatically 0
+                m_map.remap(size + extra_size);
+
+                m_restricted_data = m_map.view();
+            }
+
+            // Escape
+            {
+                uint8_t* begin_stream_data = m_map.view().begin();
+                uint8_t* end_stream_data   = begin_stream_data + size;
+                uint8_t* end_data          = end_stream_data   + extra_size - noff;
+                escape_with_iters(begin_stream_data, end_stream_data, end_data);
+            }
+        }
+
         inline void init(size_t m_from, size_t m_to) {
             if (m_source.is_view()) {
                 View s;
@@ -187,67 +251,18 @@ namespace tdc {namespace io {
                 DCHECK_EQ(m_from, 0);
                 DCHECK_EQ(m_to, npos);
 
-                // Start with a typical page size to not realloc as often
-                // for small inputs
-                size_t capacity = pagesize();
-                size_t size = 0;
-                size_t extra_size = 0;
-                FastEscapeMap fast_escape_map;
-                if (!m_restrictions.has_no_escape_restrictions()) {
-                    fast_escape_map = FastEscapeMap {
-                        EscapeMap(m_restrictions)
-                    };
-                }
-
-                size_t noff = m_restrictions.null_terminate()? 1 : 0;
-                extra_size += noff;
+                init_from_stream(*(m_source.stream()), npos);
+            } else if (m_source.is_generated()) {
+                auto is = m_source.open();
+                is->ignore(m_from);
 
-                // Initial allocation
-
-                m_map = MMap(capacity);
-
-                // Fill and grow
-                {
-                    std::istream& is = *(m_source.stream());
-                    bool done = false;
-
-                    while(!done) {
-                        // fill until capacity
-                        uint8_t* ptr = m_map.view().begin() + size;
-                        while(size < capacity) {
-                            char c;
-                            if(!is.get(c)) {
-                                done = true;
-                                break;
-                            } else {
-                                *ptr = uint8_t(c);
-                                ++ptr;
-                                ++size;
-                                extra_size += fast_escape_map.lookup_flag(uint8_t(c));
-                            }
-                        }
-                        if (done) break;
-
-                        // realloc to greater size;
-                        capacity *= 2;
-                        m_map.remap(capacity);
-                    }
-
-                    // Throw away overallocation
-                    // For null termination,
-                    // a trailing unwritten byte is automatically 0
-                    m_map.remap(size + extra_size);
-
-                    m_restricted_data = m_map.view();
-                }
-
-                // Escape
-                {
-                    uint8_t* begin_stream_data = m_map.view().begin();
-                    uint8_t* end_stream_data   = begin_stream_data + size;
-                    uint8_t* end_data          = end_stream_data   + extra_size - noff;
-                    escape_with_iters(begin_stream_data, end_stream_data, end_data);
+                size_t len = npos;
+                if (m_to != npos) {
+                    len = m_to - m_from;
+                } else if (m_source.generated_size() != npos) {
+                    len = m_source.generated_size() - m_from;
                 }
+                init_from_stream(*is, len);
             } else {
                 DCHECK(false) << "This should not happen";
             }
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <glog/logging.h>
+
+namespace tdc {namespace io {
+    /// A file on local disk for spilling temporary data.
+    ///
+    /// The file is unlinked right after its creation, so it gets removed
+    /// by the operating system as soon as the handle is closed, even if the
+    /// process terminates abnormally.
+    class TempFile {
+        int m_fd = -1;
+        size_t m_size = 0;
+
+        inline static std::string default_dir() {
+            const char* env = std::getenv("TMPDIR");
+            return (env && *env) ? std::string(env) : std::string("/tmp");
+        }
+
+        inline static void check_io_error(bool ok, const char* descr) {
+            if (!ok) {
+                perror("TempFile error");
+            }
+            CHECK(ok) << "Error at " << descr;
+        }
+
+    public:
+        /// Create an empty file in the directory `dir`.
+        ///
+        /// If `dir` is empty, `$TMPDIR` or `/tmp` is used.
+        inline TempFile(const std::string& dir = "") {
+            std::string path = (dir.empty() ? default_dir() : dir)
+                + "/tudocomp.XXXXXX";
+
+            std::vector<char> buf(path.begin(), path.end());
+            buf.push_back(0);
+
+            m_fd = mkstemp(buf.data());
+            check_io_error(m_fd != -1, "creating temporary file");
+            unlink(buf.data());
+        }
+
+        inline TempFile(TempFile&& other):
+            m_fd(other.m_fd), m_size(other.m_size) {
+            other.m_fd = -1;
+            other.m_size = 0;
+        }
+
+        inline TempFile& operator=(TempFile&& other) {
+            std::swap(m_fd, other.m_fd);
+            std::swap(m_size, other.m_size);
+            return *this;
+        }
+
+        TempFile(const TempFile&) = delete;
+        TempFile& operator=(const TempFile&) = delete;
+
+        inline ~TempFile() {
+            if (m_fd != -1) {
+                close(m_fd);
+            }
+        }
+
+        /// The underlying file descriptor.
+        inline int fd() const {
+            return m_fd;
+        }
+
+        /// The amount of bytes written to the file so far.
+        inline size_t size() const {
+            return m_size;
+        }
+
+        /// Resize the file to `size` bytes, new bytes are zero.
+        inline void resize(size_t size) {
+            check_io_error(ftruncate(m_fd, size) == 0, "resizing temporary file");
+            m_size = size;
+        }
+
+        /// Write `bytes` bytes from `data` at file offset `offset`.
+        inline void write(const void* data, size_t bytes, size_t offset) {
+            auto ptr = (const char*) data;
+            const size_t end = offset + bytes;
+            while (bytes > 0) {
+                auto ret = pwrite(m_fd, ptr, bytes, offset);
+                check_io_error(ret > 0, "writing temporary file");
+                ptr += ret;
+                offset += ret;
+                bytes -= ret;
+            }
+            m_size = std::max(m_size, end);
+        }
+
+        /// Append `bytes` bytes from `data` to the end of the file.
+        inline void append(const void* data, size_t bytes) {
+            write(data, bytes, m_size);
+        }
+
+        /// Read `bytes` bytes at file offset `offset` into `data`.
+        inline void read(void* data, size_t bytes, size_t offset) const {
+            auto ptr = (char*) data;
+            while (bytes > 0) {
+                auto ret = pread(m_fd, ptr, bytes, offset);
+                check_io_error(ret > 0, "reading temporary file");
+                ptr += ret;
+                offset += ret;
+                bytes -= ret;
+            }
+        }
+    };
+}}
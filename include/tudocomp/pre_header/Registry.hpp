@@ -7,6 +7,7 @@
 namespace tdc {
 
 class Env;
+class Meta;
 
 /// \cond INTERNAL
 struct AlreadySeenPair {
@@ -28,10 +29,30 @@ inline bool operator==(const AlreadySeenPair& lhs, const AlreadySeenPair& rhs) {
 template<typename algorithm_t>
 class Registry {
     typedef std::function<std::unique_ptr<algorithm_t>(Env&&)> constructor_t;
+    typedef std::unique_ptr<algorithm_t> (*construct_fn_t)(Env&&);
+    typedef Meta (*meta_fn_t)();
+
+    /// An algorithm whose static signature is not evaluated yet.
+    struct Entry {
+        meta_fn_t meta;
+        construct_fn_t construct;
+    };
+
+    /// A group of algorithms that share the same name and are evaluated
+    /// together once the name is requested.
+    struct Family {
+        std::vector<Entry> m_entries;
+        std::string m_name;
+        bool m_named = false;
+        bool m_loaded = false;
+    };
 
     struct RegistryData {
         eval::AlgorithmTypes m_algorithms;
         std::map<pattern::Algorithm, constructor_t> m_registered;
+
+        std::vector<Family> m_families;
+        bool m_in_family = false;
     };
 
     std::shared_ptr<RegistryData> m_data;
@@ -40,6 +61,15 @@ class Registry {
     /// \cond INTERNAL
     friend class AlgorithmTypeBuilder;
     friend class GlobalRegistry;
+
+    template<typename T>
+    static std::unique_ptr<algorithm_t> construct(Env&& env);
+
+    inline const std::string& family_name(Family& family) const;
+    inline void load_family(Family& family) const;
+    inline bool load_by_name(const std::string& name) const;
+    inline void load_all() const;
+    inline void load_for(const ast::Value& value) const;
     /// \endcond
 
 public:
@@ -53,10 +83,27 @@ public:
     /// This meta information is used to automatically generate the
     /// documentation for the driver application's help message.
     ///
+    /// The algorithm is not evaluated at this point. This happens only once
+    /// an algorithm of the same name is requested, or once the whole
+    /// registry is enumerated (e.g., for the documentation).
+    ///
     /// \tparam T The algorithm to register.
     template<typename T>
     void register_algorithm();
 
+    /// \brief Registers a family of algorithms.
+    ///
+    /// All algorithms registered by the given function must share the same
+    /// name, i.e., differ only in their static arguments. Only the first
+    /// algorithm's meta information is inspected to determine that name.
+    /// The whole family is then evaluated once the name is requested.
+    ///
+    /// Algorithms registered directly via \ref register_algorithm form a
+    /// family on their own.
+    ///
+    /// \param f The function that registers the family's algorithms.
+    inline void register_family(std::function<void(Registry&)> f);
+
     inline eval::AlgorithmTypes& algorithm_map();
     inline const eval::AlgorithmTypes& algorithm_map() const;
 
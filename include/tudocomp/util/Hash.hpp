@@ -3,6 +3,7 @@
 #include <tudocomp/Algorithm.hpp>
 #include <tudocomp/util.hpp>
 #include <tudocomp/CreateAlgorithm.hpp>
+#include <tudocomp/util/HugePages.hpp>
 #include <tudocomp_stat/StatPhase.hpp>
 // #include <tudocomp/util/hash/clhash.h>
 // #include <tudocomp/util/hash/zobrist.h>
@@ -376,6 +377,7 @@ class HashMap {
 	HashFcn m_h;
 	ProbeFcn m_probe;
 	SizeManager m_sizeman;
+	huge_pages::Policy m_huge; // backs large tables by huge pages
 	size_t m_size;
 	key_t* m_keys;
 	value_t* m_values;
@@ -412,14 +414,27 @@ class HashMap {
 	const size_t m_n;
 	const size_t& m_remaining_characters;
 
+	private:
+	template<class T>
+	T* allocate_array(size_t n) const {
+		return (T*) huge_pages::allocate(sizeof(T) * n, m_huge);
+	}
+	template<class T>
+	void free_array(T* arr, size_t n) const {
+		if(arr != nullptr) { huge_pages::deallocate(arr, sizeof(T) * n, m_huge); }
+	}
+
+	public:
+
 	HashMap(Env&, const size_t n, const size_t& remaining_characters)
 		: m_h(create_env(HashFcn::meta()))
 		, m_probe(create_env(ProbeFcn::meta()))
 // env.env_for_option("hash_prober"))
 		, m_sizeman(create_env(SizeManager::meta())) //env.env_for_option("hash_manager"))
+		, m_huge(huge_pages::global_policy())
 		, m_size(initial_size)
-		, m_keys((key_t*) malloc(sizeof(key_t) * initial_size))
-		, m_values((value_t*) malloc(sizeof(value_t) * initial_size))
+		, m_keys(allocate_array<key_t>(initial_size))
+		, m_values(allocate_array<value_t>(initial_size))
 		, m_n(n)
 		, m_remaining_characters(remaining_characters)
 	{
@@ -429,9 +444,10 @@ class HashMap {
 	template<class T>
 	void incorporate(T&& o, len_t newsize)
 	{
-		if(m_keys != nullptr) { free(m_keys); }
-		if(m_values != nullptr) { free(m_values); }
+		free_array(m_keys, m_size);
+		free_array(m_values, m_size);
 
+		m_huge = o.m_huge;
 		m_keys = std::move(o.m_keys);
 		m_values = std::move(o.m_values);
 		m_size = std::move(o.m_size);
@@ -451,8 +467,8 @@ class HashMap {
 	MoveGuard m_guard;
 	~HashMap() {
         if (m_guard) {
-            if(m_keys != nullptr) { free(m_keys); }
-            if(m_values != nullptr) { free(m_values); }
+            free_array(m_keys, m_size);
+            free_array(m_values, m_size);
         }
 	}
 	inline HashMap(HashMap&& other) = default;
@@ -465,8 +481,8 @@ class HashMap {
 			const size_t oldsize = m_size;
 			m_size = size;
 			m_sizeman.resize(m_size);
-			key_t* keys = (key_t*) malloc(sizeof(key_t) * m_size);
-			value_t* values = (value_t*) malloc(sizeof(value_t) * m_size);
+			key_t* keys = allocate_array<key_t>(m_size);
+			value_t* values = allocate_array<value_t>(m_size);
 			for(size_t i = 0; i < m_size; ++i) values[i] = undef_id;
 //			memset(values, 0, sizeof(value_t)*size);
 			std::swap(m_values,values);
@@ -477,16 +493,19 @@ class HashMap {
 				auto ret = insert(std::make_pair(std::move(keys[i]),std::move(values[i])));
 				DCHECK_EQ(ret.second, true); // no duplicates
 			}
-			free(keys);
-			free(values);
+			free_array(keys, oldsize);
+			free_array(values, oldsize);
 		}
 		else {
+			// the table is empty, so nothing needs to be moved
+			free_array(m_keys, m_size);
+			free_array(m_values, m_size);
 			m_size = size;
 			m_sizeman.resize(m_size);
-			m_values = (value_t*) realloc(m_values, sizeof(value_t) * m_size);
+			m_values = allocate_array<value_t>(m_size);
 			//memset(m_values, 0, sizeof(value_t)*size);
 			for(size_t i = 0; i < m_size; ++i) m_values[i] = undef_id;
-			m_keys = (key_t*) realloc(m_keys, sizeof(key_t) * m_size);
+			m_keys = allocate_array<key_t>(m_size);
 		}
 	}
 
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <sys/mman.h>
+
+#include <tudocomp_stat/malloc.hpp>
+#include <tudocomp/def.hpp>
+
+namespace tdc {
+
+/// \brief Allocation of large arrays backed by huge pages.
+///
+/// Large arrays that are accessed randomly, like suffix arrays or hash
+/// tables, cause a TLB miss on almost every access when backed by regular
+/// pages. Backing them by huge pages lets the TLB cover a much larger part
+/// of them.
+///
+/// Allocations of at least \ref threshold bytes are backed by huge pages
+/// according to a \ref Policy. Smaller allocations are served from the
+/// heap as usual. Memory mapped for huge pages is tracked by
+/// \ref StatPhase like heap allocations.
+namespace huge_pages {
+
+/// \brief Determines how large allocations are backed.
+enum class Policy {
+    /// Regular pages from the heap.
+    none,
+    /// Transparent huge pages, requested via `madvise(MADV_HUGEPAGE)`.
+    /// The kernel falls back to regular pages if it cannot provide huge
+    /// pages or transparent huge pages are disabled.
+    transparent,
+    /// Explicit huge pages from the kernel's pool, mapped with
+    /// `MAP_HUGETLB`. If the pool is exhausted or not configured (see
+    /// `/proc/sys/vm/nr_hugepages`), transparent huge pages are used
+    /// instead.
+    hugetlb
+};
+
+/// The assumed huge page size, 2 MiB on x86-64 and most other platforms.
+constexpr size_t page_size = size_t(1) << 21;
+
+/// The minimum size in bytes of an allocation to be backed by huge pages.
+constexpr size_t threshold = page_size;
+
+/// \brief Returns the process-wide policy.
+///
+/// Allocators capture the policy when they are created, so changing it
+/// only affects data structures created afterwards. The default is
+/// \ref Policy::none.
+inline Policy& global_policy() {
+    static Policy policy = Policy::none;
+    return policy;
+}
+
+/// \brief Parses a policy from its name, one of `none`, `thp` and
+///        `hugetlb`.
+inline Policy parse_policy(const std::string& name) {
+    if(name == "none")    return Policy::none;
+    if(name == "thp")     return Policy::transparent;
+    if(name == "hugetlb") return Policy::hugetlb;
+    throw std::invalid_argument(
+        "Unknown huge page policy \"" + name + "\", "
+        "expected none, thp or hugetlb.");
+}
+
+/// \brief Tests whether an allocation of the given size is backed by huge
+///        pages under the given policy.
+inline bool applies(Policy policy, size_t bytes) {
+    return policy != Policy::none && bytes >= threshold;
+}
+
+/// \brief Returns the length of the mapping backing an allocation of the
+///        given size, i.e., the size rounded up to full huge pages.
+inline size_t mapped_size(size_t bytes) {
+    return (bytes + page_size - 1) & ~(page_size - 1);
+}
+
+/// \brief Maps anonymous memory of the given size backed by huge pages.
+///
+/// The mapping has the length \ref mapped_size and is aligned to the huge
+/// page size. The memory is not tracked, see \ref allocate.
+///
+/// \return the mapped memory, or `nullptr` if the mapping failed
+inline void* map(size_t bytes, Policy policy) {
+    const size_t len = mapped_size(bytes);
+    const int prot = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#ifdef MAP_HUGETLB
+    if(policy == Policy::hugetlb) {
+        void* ptr = mmap(nullptr, len, prot, flags | MAP_HUGETLB, -1, 0);
+        if(ptr != MAP_FAILED) return ptr;
+    }
+#endif
+
+    // map an additional huge page and trim the mapping to huge page
+    // boundaries, so the kernel can back all of it with huge pages
+    void* raw = mmap(nullptr, len + page_size, prot, flags, -1, 0);
+    if(raw == MAP_FAILED) return nullptr;
+
+    const uintptr_t begin = uintptr_t(raw);
+    const uintptr_t aligned = (begin + page_size - 1) & ~uintptr_t(page_size - 1);
+    if(aligned > begin) {
+        munmap(raw, aligned - begin);
+    }
+    if(begin + page_size > aligned) {
+        munmap((void*)(aligned + len), begin + page_size - aligned);
+    }
+
+#ifdef MADV_HUGEPAGE
+    // fails harmlessly if transparent huge pages are not supported
+    madvise((void*) aligned, len, MADV_HUGEPAGE);
+#endif
+    return (void*) aligned;
+}
+
+/// \brief Unmaps memory mapped by \ref map.
+inline void unmap(void* ptr, size_t bytes) {
+    munmap(ptr, mapped_size(bytes));
+}
+
+/// \brief Allocates memory of the given size.
+///
+/// The memory is backed by huge pages if the policy \ref applies, and is
+/// allocated on the heap otherwise. It must be released using
+/// \ref deallocate with the same size and policy.
+///
+/// \throws std::bad_alloc if the memory could not be allocated
+inline void* allocate(size_t bytes, Policy policy) {
+    if(!applies(policy, bytes)) {
+        return ::operator new(bytes);
+    }
+
+    void* ptr = map(bytes, policy);
+    if(!ptr) throw std::bad_alloc();
+
+    IF_STATS(malloc_callback::on_alloc(mapped_size(bytes)));
+    return ptr;
+}
+
+/// \brief Releases memory allocated by \ref allocate.
+inline void deallocate(void* ptr, size_t bytes, Policy policy) {
+    if(!applies(policy, bytes)) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    unmap(ptr, bytes);
+    IF_STATS(malloc_callback::on_free(mapped_size(bytes)));
+}
+
+/// \brief An allocator for standard containers that backs large
+///        allocations by huge pages.
+///
+/// The allocator captures the \ref global_policy when it is created and
+/// is propagated on copies, moves and swaps.
+template<typename T>
+class Allocator {
+    Policy m_policy;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    inline Allocator(): m_policy(global_policy()) {}
+    inline Allocator(Policy policy): m_policy(policy) {}
+
+    template<typename U>
+    inline Allocator(const Allocator<U>& other): m_policy(other.policy()) {}
+
+    /// The policy the allocator follows.
+    inline Policy policy() const {
+        return m_policy;
+    }
+
+    inline T* allocate(size_t n) {
+        return static_cast<T*>(huge_pages::allocate(n * sizeof(T), m_policy));
+    }
+
+    inline void deallocate(T* ptr, size_t n) {
+        huge_pages::deallocate(ptr, n * sizeof(T), m_policy);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(const Allocator<T>& a, const Allocator<U>& b) {
+    return a.policy() == b.policy();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const Allocator<T>& a, const Allocator<U>& b) {
+    return !(a == b);
+}
+
+}} //ns
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+
+#include <tudocomp/def.hpp>
+
+namespace tdc {
+
+/// The width of the blocks copied at once by \ref lz_copy, in bytes.
+#ifdef __AVX2__
+constexpr size_t LZ_COPY_WIDTH = 32;
+#else
+constexpr size_t LZ_COPY_WIDTH = 16;
+#endif
+
+/// \brief Copies `len` characters from `src` to `dst` with the semantics of
+///        a character-by-character forward copy.
+///
+/// This is how an LZ factor is decoded: if the target follows the source
+/// closely, the copied characters are copied again (e.g., a factor of
+/// distance 1 repeats a single character).
+///
+/// Instead of single characters, blocks of \ref LZ_COPY_WIDTH characters
+/// are copied whenever the distance between target and source allows it.
+/// Shorter distances are first widened by replicating the pattern between
+/// source and target, which doubles the distance with every step.
+inline void lz_copy(uliteral_t* dst, const uliteral_t* src, size_t len) {
+    if(dst <= src || size_t(dst - src) >= len) {
+        // a forward copy to a lower address is a plain memmove
+        std::memmove(dst, src, len);
+        return;
+    }
+
+    // replicate short patterns until the distance allows wide copies
+    while(len > 0 && size_t(dst - src) < LZ_COPY_WIDTH) {
+        const size_t n = std::min(size_t(dst - src), len);
+        std::memcpy(dst, src, n);
+        dst += n;
+        len -= n;
+    }
+
+    // the blocks read only characters written by preceding blocks
+    size_t i = 0;
+    for(; i + LZ_COPY_WIDTH <= len; i += LZ_COPY_WIDTH) {
+        std::memcpy(dst + i, src + i, LZ_COPY_WIDTH);
+    }
+    std::memcpy(dst + i, src + i, len - i);
+}
+
+/// \brief Writes `len` characters to the given stream at once.
+inline void write_block(std::ostream& out, const uliteral_t* data, size_t len) {
+    out.write((const char*) data, len);
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace tdc {
+
+/// Returns the maximum number of threads a parallel region may use.
+///
+/// This is the OpenMP default (controlled by `OMP_NUM_THREADS`), or 1 if
+/// tudocomp was built without OpenMP support.
+inline size_t max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/// Returns the number of the calling thread within a parallel region.
+inline size_t thread_num() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+/// Returns the number of threads in the current parallel region.
+inline size_t num_threads() {
+#ifdef _OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+/// Determines how many threads to use for processing `n` items.
+///
+/// Parallelization is only worth it if every thread receives at least
+/// `min_per_thread` items.
+///
+/// \param n the number of items to process.
+/// \param min_per_thread the minimum amount of items per thread.
+/// \param threads the desired amount of threads, 0 for the default.
+inline size_t threads_for(size_t n, size_t min_per_thread, size_t threads = 0) {
+    if(threads == 0) threads = max_threads();
+    return std::max(size_t(1), std::min(threads, n / std::max(size_t(1), min_per_thread)));
+}
+
+/// Returns the beginning of the `t`-th of `team` contiguous ranges that
+/// partition `[0, n)`, or `n` if `t == team`.
+///
+/// All ranges but the last one have a size that is a multiple of `align`.
+/// If `align` is a multiple of 64, threads that write different ranges of
+/// a bit-packed integer vector therefore never write the same word.
+inline size_t range_begin(size_t n, size_t t, size_t team, size_t align = 1) {
+    return (t >= team) ? n : ((n / align) * t / team) * align;
+}
+
+}
@@ -7,6 +7,7 @@
 
 #include <tudocomp/ds/IntVector.hpp>
 #include <tudocomp/ds/IntPtr.hpp>
+#include <tudocomp/util/HugePages.hpp>
 
 namespace tdc {
 
@@ -342,8 +343,8 @@ class compact_hash {
     // Compact table data
     IntVector<uint_t<2>> m_cv;
 
-    // Sparse table data
-    std::vector<Bucket<val_t>> m_buckets;
+    // Sparse table data, backed by huge pages for large tables
+    std::vector<Bucket<val_t>, huge_pages::Allocator<Bucket<val_t>>> m_buckets;
 
     inline static constexpr size_t min_size(size_t size) {
         return (size < 2) ? 2 : size;
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <tudocomp/def.hpp>
 
 /// \cond INTERNAL
@@ -36,6 +36,47 @@ inline void write_vbyte(std::ostream& os, int_t v) {
 	} while(v > 0);
 }
 
+/// The maximum amount of bytes \ref write_vbyte writes for a 64-bit integer.
+constexpr size_t VBYTE_MAX_BYTES = 10;
+
+/**
+ * Reads an integer in the vbyte-encoding from a buffer.
+ *
+ * \param p The position to read from, which is advanced behind the integer.
+ * \param end The end of the buffer.
+ */
+template<class int_t>
+inline int_t read_vbyte(const uint8_t*& p, const uint8_t* end) {
+	// most integers fit into a single byte
+	if(tdc_likely(p < end && !(*p & 0x80))) return int_t(*p++);
+
+	int_t ret = 0;
+	size_t shift = 0;
+	while(p < end) {
+		const uint8_t byte = *p++;
+		ret |= int_t(byte & 0x7F) << shift;
+		if(!(byte & 0x80)) return ret;
+		shift += 7;
+	}
+	DCHECK(false) << "VByte ended without reading a byte with the most significant bit equals zero.";
+	return ret;
+}
+
+/**
+ * Stores an integer in the vbyte-encoding into a buffer, which must
+ * provide space for at least \ref VBYTE_MAX_BYTES bytes.
+ *
+ * \return The position behind the written bytes.
+ */
+template<class int_t>
+inline uint8_t* write_vbyte(uint8_t* p, int_t v) {
+	while(v > 0x7F) {
+		*p++ = uint8_t(v & 0x7F) | 0x80;
+		v >>= 7;
+	}
+	*p++ = uint8_t(v);
+	return p;
+}
 
 }//ns
 
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+/// \cond INTERNAL
+namespace tdc_driver {
+
+// getopt data
+constexpr int BENCH_OPT_HELP = 1000;
+constexpr int BENCH_OPT_HUGEPAGES = 1001;
+
+constexpr option BENCH_OPTIONS[] = {
+    {"algorithm",   required_argument, nullptr, 'a'},
+    {"generator",   required_argument, nullptr, 'g'},
+    {"repetitions", required_argument, nullptr, 'n'},
+    {"output",      required_argument, nullptr, 'o'},
+    {"title",       required_argument, nullptr, 't'},
+    {"warmup",      required_argument, nullptr, 'w'},
+    {"help",        no_argument,       nullptr, BENCH_OPT_HELP},
+    {"hugepages",   required_argument, nullptr, BENCH_OPT_HUGEPAGES},
+    {0, 0, 0, 0} // termination (required last entry!!)
+};
+
+class BenchOptions {
+public:
+    static inline void print_usage(const std::string& cmd, std::ostream& out) {
+        using namespace std;
+
+        // Usage
+        out << left;
+        out << setw(7) << "Usage: " << cmd << " [OPTION] -a ALGORITHM... "
+            << setw(14) << "FILE" << "(1)" << endl;
+        out << setw(7) << "or: " << cmd << " [OPTION] -a ALGORITHM... "
+            << setw(14) << "-g GENERATOR" << "(2)" << endl;
+
+        // Brief description
+        out << endl;
+        out << "Benchmarks the given algorithms on a file (1) or a generated string (2)." << endl;
+        out << "The input is loaded into memory once. Each algorithm compresses and" << endl;
+        out << "decompresses it in-process after the given amount of warmup runs, and" << endl;
+        out << "every round trip is verified. A JSON report containing the median and the" << endl;
+        out << "median absolute deviation of the running times, the throughput and the" << endl;
+        out << "memory peaks is printed, which can also be plotted by the charter." << endl;
+
+        // Options
+        out << endl;
+        out << "Options:" << endl;
+
+        constexpr int W_SF = 4;
+        constexpr int W_NOSF = 6;
+        constexpr int W_LF = 24;
+        constexpr int W_INDENT = 30;
+
+        // -a, --algorithm
+        out << right << setw(W_SF) << "-a" << ", "
+            << left << setw(W_LF) << "--algorithm=ALGORITHM"
+            << "benchmark ALGORITHM (can be given multiple times)"
+            << endl << setw(W_INDENT) << "" << "(use tdc -l for more information)"
+            << endl;
+
+        // -g, --generator
+        out << right << setw(W_SF) << "-g" << ", "
+            << left << setw(W_LF) << "--generator=GENERATOR"
+            << "generate the input using GENERATOR"
+            << endl;
+
+        // -n, --repetitions
+        out << right << setw(W_SF) << "-n" << ", "
+            << left << setw(W_LF) << "--repetitions=N"
+            << "measure N runs per algorithm (default: 5)"
+            << endl;
+
+        // -w, --warmup
+        out << right << setw(W_SF) << "-w" << ", "
+            << left << setw(W_LF) << "--warmup=N"
+            << "run N unmeasured runs first (default: 1)"
+            << endl;
+
+        // -o, --output
+        out << right << setw(W_SF) << "-o" << ", "
+            << left << setw(W_LF) << "--output=FILE"
+            << "write the report to FILE instead of stdout"
+            << endl;
+
+        // -t, --title
+        out << right << setw(W_SF) << "-t" << ", "
+            << left << setw(W_LF) << "--title=TITLE"
+            << "title of the report"
+            << endl;
+
+        // --hugepages
+        out << right << setw(W_NOSF) << ""
+            << left << setw(W_LF) << "--hugepages=POLICY"
+            << "back large arrays and hash tables by huge pages"
+            << endl << setw(W_INDENT) << "" << "(none, thp or hugetlb, see tdc --help)"
+            << endl;
+
+        // --help
+        out << right << setw(W_NOSF) << ""
+            << left << setw(W_LF) << "--help"
+            << "display this help"
+            << endl;
+    }
+
+private:
+    /// Parses a non-negative decimal number. Returns false if the string is
+    /// not one or if it is out of range.
+    static inline bool parse_count(const char* str, size_t& value) {
+        if(!std::isdigit(static_cast<unsigned char>(str[0]))) return false;
+
+        errno = 0;
+        char* end;
+        const unsigned long long v = std::strtoull(str, &end, 10);
+        if(*end != '\0' || errno == ERANGE || v > SIZE_MAX) return false;
+
+        value = v;
+        return true;
+    }
+
+    // fields
+    bool m_unknown_options;
+    bool m_help;
+    std::string m_invalid_argument;
+
+    std::vector<std::string> m_algorithms;
+    std::string m_generator;
+
+    size_t m_repetitions;
+    size_t m_warmup;
+
+    std::string m_output;
+    std::string m_title;
+    std::string m_hugepages;
+
+    std::vector<std::string> m_remaining;
+
+public:
+    // The reference-based accessors will
+    // get invalidated in case of a move or copy, so forbid them
+    BenchOptions(const BenchOptions& other) = delete;
+    BenchOptions(BenchOptions&& other) = delete;
+
+    inline BenchOptions(int argc, char **argv) :
+        m_unknown_options(false),
+        m_help(false),
+        m_repetitions(5),
+        m_warmup(1),
+        m_hugepages("none")
+    {
+        int c, option_index = 0;
+        while((c = getopt_long(argc, argv, "a:g:n:o:t:w:",
+            BENCH_OPTIONS, &option_index)) != -1) {
+
+            switch(c) {
+                case 'a': // --algorithm=<optarg>
+                    m_algorithms.emplace_back(optarg);
+                    break;
+
+                case 'g': // --generator=<optarg>
+                    m_generator = std::string(optarg);
+                    break;
+
+                case 'n': // --repetitions=<optarg>
+                    if(!parse_count(optarg, m_repetitions) || m_repetitions == 0) {
+                        m_invalid_argument = "invalid amount of repetitions: " + std::string(optarg);
+                    }
+                    break;
+
+                case 'o': // --output=<optarg>
+                    m_output = std::string(optarg);
+                    break;
+
+                case 't': // --title=<optarg>
+                    m_title = std::string(optarg);
+                    break;
+
+                case 'w': // --warmup=<optarg>
+                    if(!parse_count(optarg, m_warmup)) {
+                        m_invalid_argument = "invalid amount of warmup runs: " + std::string(optarg);
+                    }
+                    break;
+
+                case BENCH_OPT_HELP: // --help
+                    m_help = true;
+                    break;
+
+                case BENCH_OPT_HUGEPAGES: // --hugepages=<optarg>
+                    m_hugepages = std::string(optarg);
+                    break;
+
+                case '?': // unknown option
+                    m_unknown_options = true;
+                    break;
+
+                default: // declared, but unhandled
+                    std::cerr << "Unhandled option \"" <<
+                        BENCH_OPTIONS[option_index].name << "\"";
+                    break;
+            }
+        }
+
+        // remaining options (e.g. filename)
+        while(optind < argc) {
+            m_remaining.emplace_back(argv[optind++]);
+        }
+    }
+
+    // public accessors
+    const bool& unknown_options = m_unknown_options;
+    const bool& help = m_help;
+    const std::string& invalid_argument = m_invalid_argument; //! empty if all arguments are valid
+
+    const std::vector<std::string>& algorithms = m_algorithms;
+    const std::string& generator = m_generator;
+
+    const size_t& repetitions = m_repetitions;
+    const size_t& warmup = m_warmup;
+
+    const std::string& output = m_output;
+    const std::string& title = m_title;
+    const std::string& hugepages = m_hugepages;
+
+    const std::vector<std::string>& remaining = m_remaining;
+};
+
+}
+/// \endcond
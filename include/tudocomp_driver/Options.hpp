@@ -11,6 +11,7 @@ constexpr int OPT_HELP   = 1000;
 constexpr int OPT_RAW    = 1001;
 constexpr int OPT_STDIN  = 1002;
 constexpr int OPT_STDOUT = 1003;
+constexpr int OPT_HUGEPAGES = 1004;
 
 constexpr option OPTIONS[] = {
     {"algorithm",  required_argument, nullptr, 'a'},
@@ -25,6 +26,7 @@ constexpr option OPTIONS[] = {
     {"raw",        no_argument,       nullptr, OPT_RAW},
     {"usestdin",   no_argument,       nullptr, OPT_STDIN},
     {"usestdout",  no_argument,       nullptr, OPT_STDOUT},
+    {"hugepages",  required_argument, nullptr, OPT_HUGEPAGES},
     {"logdir",     required_argument, nullptr, 'L'},
     {"loglevel",   required_argument, nullptr, 'O'},
     {"logverbosity",   required_argument, nullptr, 'V'},
@@ -128,6 +130,14 @@ public:
             << "use stdout for input"
             << endl;
 
+        // --hugepages
+        out << right << setw(W_NOSF) << ""
+            << left << setw(W_LF) << "--hugepages=POLICY"
+            << "back large arrays and hash tables by huge pages"
+            << endl << setw(W_INDENT) << "" << "POLICY is none (default), thp for transparent"
+            << endl << setw(W_INDENT) << "" << "huge pages or hugetlb for explicit huge pages"
+            << endl;
+
         // -v, --version
         out << right << setw(W_SF) << "-v" << ", "
             << left << setw(W_LF) << "--version"
@@ -177,6 +187,8 @@ private:
     bool m_stats;
     std::string m_stats_title;
 
+    std::string m_hugepages;
+
     std::vector<std::string> m_remaining;
 
 public:
@@ -195,7 +207,8 @@ public:
         m_stdout(false),
         m_raw(false),
         m_decompress(false),
-        m_stats(false)
+        m_stats(false),
+        m_hugepages("none")
     {
         int c, option_index = 0;
         while((c = getopt_long(argc, argv, "O:V:L:a:dfg:lo:s::v",
@@ -264,6 +277,10 @@ public:
                     m_stdout = true;
                     break;
 
+                case OPT_HUGEPAGES: // --hugepages=<optarg>
+                    m_hugepages = std::string(optarg);
+                    break;
+
                 case '?': // unknown option
                     m_unknown_options = true;
                     break;
@@ -302,6 +319,8 @@ public:
     const bool& stats = m_stats;
     const std::string& stats_title = m_stats_title;
 
+    const std::string& hugepages = m_hugepages;
+
     const std::vector<std::string>& remaining = m_remaining;
 };
 
@@ -76,6 +76,11 @@ inline void TValue<char>::str(std::ostream& s, unsigned int) const {
     s << quote_char;
 }
 
+template<>
+inline void TValue<bool>::str(std::ostream& s, unsigned int) const {
+    s << (m_value ? "true" : "false");
+}
+
 template<>
 inline TValue<std::string>::TValue(const std::string& value) {
     m_value = std::string(value);
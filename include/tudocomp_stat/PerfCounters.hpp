@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// \cond INTERNAL
+
+namespace tdc {
+
+/// \brief Provides access to hardware performance counters of the process.
+///
+/// On Linux, the counters are opened once via \c perf_event_open and count
+/// in user space only, for the calling thread and threads created by it.
+/// Counters that cannot be opened, e.g., because the kernel does not permit
+/// it (see \c /proc/sys/kernel/perf_event_paranoid) or because the hardware
+/// or virtual machine does not support them, are reported as unavailable.
+/// On other platforms, no counter is available.
+class PerfCounters {
+public:
+    /// The amount of counters.
+    static constexpr size_t num = 4;
+
+    /// Returns the name of the i-th counter as used in the JSON output.
+    inline static const char* name(size_t i) {
+        static const char* const names[num] = {
+            "cycles", "instructions", "cacheMisses", "branchMisses"
+        };
+        return names[i];
+    }
+
+    /// Returns the process-wide counter instance.
+    inline static PerfCounters& get() {
+        static PerfCounters counters;
+        return counters;
+    }
+
+private:
+    int m_fd[num];
+
+#ifdef __linux__
+    inline static int open(uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+                         | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    inline PerfCounters() {
+        const uint64_t config[num] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for(size_t i = 0; i < num; ++i) m_fd[i] = open(config[i]);
+    }
+
+    inline ~PerfCounters() {
+        for(size_t i = 0; i < num; ++i) {
+            if(m_fd[i] >= 0) close(m_fd[i]);
+        }
+    }
+#else
+    inline PerfCounters() {
+        for(size_t i = 0; i < num; ++i) m_fd[i] = -1;
+    }
+#endif
+
+public:
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /// Tests whether the i-th counter is available.
+    inline bool available(size_t i) const {
+        return m_fd[i] >= 0;
+    }
+
+    /// Tests whether any counter is available.
+    inline bool any_available() const {
+        for(size_t i = 0; i < num; ++i) {
+            if(available(i)) return true;
+        }
+        return false;
+    }
+
+    /// Reads the current values of all counters.
+    ///
+    /// If the kernel had to multiplex the counters, the values are
+    /// extrapolated to the time the counters were enabled. Values of
+    /// unavailable counters are zero.
+    inline void read(uint64_t* values) const {
+        for(size_t i = 0; i < num; ++i) {
+            values[i] = 0;
+#ifdef __linux__
+            // value, time enabled, time running
+            uint64_t data[3];
+            if(m_fd[i] >= 0 &&
+               ::read(m_fd[i], data, sizeof(data)) == ssize_t(sizeof(data))) {
+
+                if(data[2] > 0 && data[2] < data[1]) {
+                    values[i] = uint64_t(double(data[0]) * data[1] / data[2]);
+                } else {
+                    values[i] = data[0];
+                }
+            }
+#endif
+        }
+    }
+};
+
+}
+
+/// \endcond
@@ -1,12 +1,24 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <tudocomp_stat/Json.hpp>
+#include <tudocomp_stat/PerfCounters.hpp>
 
 /// \cond INTERNAL
 
 namespace tdc {
 
+/// A snapshot of the time and resources used by the process. All times are
+/// in nanoseconds.
+struct ResourceUsage {
+    uint64_t time;       // monotonic wall-clock time
+    uint64_t cpu_user;   // user CPU time of the process
+    uint64_t cpu_sys;    // system CPU time of the process
+    uint64_t cpu_thread; // CPU time of the calling thread
+    uint64_t counters[PerfCounters::num];
+};
+
 class PhaseData {
 private:
     static constexpr size_t STR_BUFFER_SIZE = 64;
@@ -27,8 +39,8 @@ private:
     char m_title[STR_BUFFER_SIZE];
 
 public:
-    unsigned long time_start;
-    unsigned long time_end;
+    ResourceUsage start;
+    ResourceUsage end;
     ssize_t mem_off;
     ssize_t mem_current;
     ssize_t mem_peak;
@@ -79,8 +91,13 @@ public:
     inline json::Object to_json() const {
         json::Object obj;
         obj.set("title",     m_title);
-        obj.set("timeStart", time_start);
-        obj.set("timeEnd",   time_end);
+        obj.set("timeStart", start.time / 1000000UL); // milliseconds
+        obj.set("timeEnd",   end.time / 1000000UL);
+        obj.set("timeStartNs", start.time);
+        obj.set("timeEndNs",   end.time);
+        obj.set("cpuUserNs",   end.cpu_user - start.cpu_user);
+        obj.set("cpuSysNs",    end.cpu_sys - start.cpu_sys);
+        obj.set("cpuThreadNs", end.cpu_thread - start.cpu_thread);
         obj.set("memOff",    mem_off);
         obj.set("memPeak",   mem_peak);
         obj.set("memFinal",  mem_current);
@@ -96,6 +113,18 @@ public:
         }
         obj.set("stats", stats);
 
+        const PerfCounters& perf = PerfCounters::get();
+        if(perf.any_available()) {
+            json::Object counters;
+            for(size_t i = 0; i < PerfCounters::num; ++i) {
+                if(perf.available(i)) {
+                    counters.set(PerfCounters::name(i),
+                                 end.counters[i] - start.counters[i]);
+                }
+            }
+            obj.set("counters", counters);
+        }
+
         json::Array sub;
 
         PhaseData* child = first_child;
@@ -11,6 +11,7 @@
 #include <tudocomp_stat/PhaseData.hpp>
 
 #include <time.h>
+#include <sys/resource.h>
 #include <sys/time.h>
 
 #ifdef __MACH__
@@ -41,15 +42,47 @@ inline void get_monotonic_time(struct timespec *ts){
 /// Phases are used to track runtime and memory allocations over the course
 /// of the application. The measured data can be printed as a JSON string for
 /// use in the tudocomp charter for visualization or third party applications.
+///
+/// Besides the wall-clock time, each phase records the user and system CPU
+/// time of the process, the CPU time of the calling thread and, if available,
+/// hardware performance counters (cycles, instructions, cache misses and
+/// branch misses).
 class StatPhase {
 private:
     static StatPhase* s_current;
 
-    inline static unsigned long current_time_millis() {
+    inline static uint64_t nanos(const timespec& t) {
+        return uint64_t(t.tv_sec) * 1000000000ULL + uint64_t(t.tv_nsec);
+    }
+
+    inline static uint64_t nanos(const timeval& t) {
+        return uint64_t(t.tv_sec) * 1000000000ULL + uint64_t(t.tv_usec) * 1000ULL;
+    }
+
+    inline static void current_usage(ResourceUsage& usage) {
         timespec t;
         get_monotonic_time(&t);
+        usage.time = nanos(t);
+
+        rusage r;
+        if(getrusage(RUSAGE_SELF, &r) == 0) {
+            usage.cpu_user = nanos(r.ru_utime);
+            usage.cpu_sys = nanos(r.ru_stime);
+        } else {
+            usage.cpu_user = usage.cpu_sys = 0;
+        }
 
-        return t.tv_sec * 1000L + t.tv_nsec / 1000000L;
+#ifdef CLOCK_THREAD_CPUTIME_ID
+        if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t) == 0) {
+            usage.cpu_thread = nanos(t);
+        } else {
+            usage.cpu_thread = 0;
+        }
+#else
+        usage.cpu_thread = 0;
+#endif
+
+        PerfCounters::get().read(usage.counters);
     }
 
     StatPhase* m_parent = nullptr;
@@ -105,14 +138,14 @@ private:
         m_data->mem_current = 0;
         m_data->mem_peak = 0;
 
-        m_data->time_end = 0;
-        m_data->time_start = current_time_millis();
+        current_usage(m_data->start);
+        m_data->end = m_data->start;
 
         s_current = this;
     }
 
     inline void finish() {
-        m_data->time_end = current_time_millis();
+        current_usage(m_data->end);
 
         if(m_parent) {
             // add data to parent's data
@@ -303,6 +336,14 @@ public:
         }
     }
 
+    /// \brief Returns the peak amount of memory allocated during this phase
+    ///        so far, including its sub phases.
+    ///
+    /// \return the memory peak in bytes
+    inline ssize_t mem_peak() const {
+        return m_disabled ? 0 : m_data->mem_peak;
+    }
+
     /// \brief Constructs the JSON representation of the measured data.
     ///
     /// It contains the subtree of phases beneath this phase.
@@ -310,7 +351,7 @@ public:
     /// \return the \ref json::Object containing the JSON representation
     inline json::Object to_json() {
         if (!m_disabled) {
-            m_data->time_end = current_time_millis();
+            current_usage(m_data->end);
             pause();
             json::Object obj = m_data->to_json();
             resume();
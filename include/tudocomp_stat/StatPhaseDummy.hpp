@@ -66,6 +66,10 @@ public:
     inline void log_stat(const char* key, const T& value) {
     }
 
+    inline ssize_t mem_peak() const {
+        return 0;
+    }
+
     inline json::Object to_json() {
         return json::Object();
     }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace tdc {
+
+/// \brief Returns the median of the given values.
+///
+/// For an even amount of values, this is the mean of the two middle values.
+inline double median(std::vector<double> values) {
+    DCHECK(!values.empty());
+    std::sort(values.begin(), values.end());
+
+    const size_t n = values.size();
+    return (n % 2) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+/// \brief Measures the running time of a function in nanoseconds.
+template<typename F>
+inline double time_ns(F func) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/// \brief Collects the running times of repeated runs of an operation.
+class Timings {
+    std::vector<double> m_times; // in nanoseconds
+
+public:
+    /// \brief Runs the given function and adds its running time.
+    template<typename F>
+    inline void measure(F func) {
+        m_times.push_back(time_ns(func));
+    }
+
+    /// \brief Adds a running time in nanoseconds.
+    inline void add(double ns) {
+        m_times.push_back(ns);
+    }
+
+    /// \brief The running times in nanoseconds, in the order of the runs.
+    inline const std::vector<double>& times() const {
+        return m_times;
+    }
+
+    inline bool empty() const {
+        return m_times.empty();
+    }
+
+    /// \brief The median running time in nanoseconds.
+    inline double median() const {
+        return tdc::median(m_times);
+    }
+};
+
+} //ns
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <tudocomp/Compressor.hpp>
+#include <tudocomp/io.hpp>
+#include <tudocomp/io/IOUtil.hpp>
+#include <tudocomp/util/HugePages.hpp>
+
+#include <tudocomp_driver/BenchOptions.hpp>
+#include <tudocomp_driver/Registry.hpp>
+
+#include <tudocomp_stat/Json.hpp>
+#include <tudocomp_stat/StatPhase.hpp>
+#include <tudocomp_stat/Timing.hpp>
+
+#include <glog/logging.h>
+
+namespace tdc_driver {
+
+using namespace tdc;
+using namespace tdc_algorithms;
+using tdc::io::file_exists;
+
+static int bad_usage(const char* cmd, const std::string& message) {
+    using namespace std;
+    cerr << cmd << ": " << message << endl;
+    cerr << "Try '" << cmd << " --help' for more information." << endl;
+    return 2;
+}
+
+/// The measured runs of an algorithm in one direction.
+class Measurement {
+    std::vector<double> m_times; // in nanoseconds
+    ssize_t m_mem_peak = 0;
+
+public:
+    inline void add(double ns, ssize_t mem_peak) {
+        m_times.push_back(ns);
+        m_mem_peak = std::max(m_mem_peak, mem_peak);
+    }
+
+    /// Reports the median and the median absolute deviation of the running
+    /// times, the resulting throughput for the given amount of (uncompressed)
+    /// bytes and the memory peak over all runs.
+    inline json::Object to_json(size_t bytes) const {
+        json::Object obj;
+        if(m_times.empty()) return obj;
+
+        const double med = median(m_times);
+        std::vector<double> dev;
+        for(double t : m_times) dev.push_back(std::abs(t - med));
+
+        obj.set("medianNs", uint64_t(med));
+        obj.set("madNs", uint64_t(median(dev)));
+        obj.set("minNs", uint64_t(*std::min_element(m_times.begin(), m_times.end())));
+        obj.set("maxNs", uint64_t(*std::max_element(m_times.begin(), m_times.end())));
+        obj.set("throughputMiBs", (med > 0) ? (bytes / 1048576.0) / (med / 1e9) : 0.0);
+        obj.set("memPeak", m_mem_peak);
+        return obj;
+    }
+};
+
+/// Benchmarks a single algorithm on the given text.
+///
+/// Every run compresses and decompresses the text in a statistics phase of
+/// its own and verifies the round trip. The compressors are set up outside
+/// of the time measurement and the output buffers are reused, so after the
+/// first run, neither the setup nor the growth of the buffers is measured.
+static json::Object bench(
+    const Registry<Compressor>& registry,
+    const std::string& id,
+    const std::vector<uint8_t>& text,
+    size_t warmup, size_t repetitions,
+    bool& ok) {
+
+    json::Object result;
+    result.set("config", id);
+
+    Measurement comp, decomp;
+    std::vector<uint8_t> compressed, decompressed;
+    bool verified = true;
+
+    try {
+        StatPhase phase(id);
+
+        const auto av = registry.parse_algorithm_id(id);
+        const auto restrictions = av.textds_flags();
+
+        auto run = [&](bool measure) {
+            auto compressor = registry.select_algorithm(av);
+            compressed.clear();
+            {
+                StatPhase p("compress");
+
+                Input in(text);
+                if(restrictions.has_restrictions()) {
+                    in = Input(in, restrictions);
+                }
+                Output out(compressed);
+
+                const double t = time_ns([&]{ compressor->compress(in, out); });
+                if(measure) comp.add(t, p.mem_peak());
+            }
+
+            compressor = registry.select_algorithm(av);
+            decompressed.clear();
+            {
+                StatPhase p("decompress");
+
+                Input in(compressed);
+                Output out(decompressed);
+                if(restrictions.has_restrictions()) {
+                    out = Output(out, restrictions);
+                }
+
+                const double t = time_ns([&]{ compressor->decompress(in, out); });
+                if(measure) decomp.add(t, p.mem_peak());
+            }
+
+            verified = verified && (decompressed == text);
+        };
+
+        if(warmup > 0) {
+            StatPhase::wrap("warmup", [&]{
+                for(size_t i = 0; i < warmup; ++i) run(false);
+            });
+        }
+
+        for(size_t i = 0; i < repetitions; ++i) run(true);
+    } catch(std::exception& e) {
+        result.set("error", std::string(e.what()));
+        std::cerr << id << ": " << e.what() << std::endl;
+        ok = false;
+        return result;
+    }
+
+    if(!verified) {
+        std::cerr << id << ": round trip failed" << std::endl;
+        ok = false;
+    }
+
+    result.set("verified", verified);
+    result.set("outputSize", compressed.size());
+    result.set("rate", text.empty() ? 0.0 :
+        double(compressed.size()) / double(text.size()));
+    result.set("compress", comp.to_json(text.size()));
+    result.set("decompress", decomp.to_json(text.size()));
+    return result;
+}
+
+} // namespace tdc_driver
+
+int main(int argc, char** argv) {
+    using namespace tdc_driver;
+    using namespace tdc_algorithms;
+
+    const char* cmd = argv[0];
+
+    FLAGS_logtostderr = 1;
+
+    // parse command line options
+    const BenchOptions options(argc, argv);
+
+    if(options.unknown_options) {
+        return bad_usage(cmd, "unknown options");
+    }
+
+    if(!options.invalid_argument.empty()) {
+        return bad_usage(cmd, options.invalid_argument);
+    }
+
+    if(options.help) {
+        BenchOptions::print_usage(cmd, std::cout);
+        return 0;
+    }
+
+    google::InitGoogleLogging(cmd);
+
+    if(options.algorithms.empty()) {
+        return bad_usage(cmd, "missing algorithm");
+    }
+
+    if(options.generator.empty() == options.remaining.empty()
+        || options.remaining.size() > 1) {
+
+        return bad_usage(cmd, "expecting either an input file or a generator");
+    }
+
+    try {
+        huge_pages::global_policy() = huge_pages::parse_policy(options.hugepages);
+    } catch(std::invalid_argument& e) {
+        return bad_usage(cmd, e.what());
+    }
+
+    try {
+        const Registry<Compressor>& compressor_registry = COMPRESSOR_REGISTRY;
+        const Registry<Generator>& generator_registry = GENERATOR_REGISTRY;
+
+        // load the input once
+        std::vector<uint8_t> text;
+        std::string input_name;
+
+        if(!options.generator.empty()) {
+            const std::string s = generator_registry.select(options.generator)->generate();
+            text.assign(s.begin(), s.end());
+            input_name = options.generator;
+        } else {
+            input_name = options.remaining[0];
+            if(!file_exists(input_name)) {
+                std::cerr << "input path not found or is not a file: " << input_name << std::endl;
+                return 1;
+            }
+
+            Input input(io::Path{input_name});
+            auto view = input.as_view();
+            text.assign(view.data(), view.data() + view.size());
+        }
+
+        const auto start_time = std::chrono::system_clock::now();
+
+        // run the benchmarks
+        bool ok = true;
+        json::Array results;
+        json::Object data;
+        {
+            StatPhase root("tdc_bench");
+            for(auto& id : options.algorithms) {
+                results.add(bench(compressor_registry, id, text,
+                                  options.warmup, options.repetitions, ok));
+            }
+            data = root.to_json();
+        }
+
+        // the meta and data blocks follow the format of tdc --stats, so
+        // the report can be plotted by the charter
+        json::Object meta;
+        meta.set("title", options.title);
+        meta.set("startTime",
+            std::chrono::duration_cast<std::chrono::seconds>(
+                start_time.time_since_epoch()).count());
+
+        std::string config;
+        for(auto& id : options.algorithms) {
+            if(!config.empty()) config += "; ";
+            config += id;
+        }
+        meta.set("config", config);
+        meta.set("input", input_name);
+        meta.set("inputSize", text.size());
+        meta.set("output", "<memory>");
+        meta.set("warmup", options.warmup);
+        meta.set("repetitions", options.repetitions);
+        meta.set("hugepages", options.hugepages);
+
+        json::Object report;
+        report.set("meta", meta);
+        report.set("data", data);
+        report.set("results", results);
+
+        if(options.output.empty()) {
+            report.str(std::cout);
+            std::cout << std::endl;
+        } else {
+            std::ofstream out(options.output);
+            report.str(out);
+            out << std::endl;
+        }
+
+        return ok ? 0 : 1;
+    } catch (std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
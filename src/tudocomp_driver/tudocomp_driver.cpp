@@ -11,6 +11,7 @@
 #include <tudocomp/Compressor.hpp>
 #include <tudocomp/io.hpp>
 #include <tudocomp/io/IOUtil.hpp>
+#include <tudocomp/util/HugePages.hpp>
 #include <tudocomp/version.hpp>
 
 #include <tudocomp_driver/Options.hpp>
@@ -118,6 +119,13 @@ int main(int argc, char** argv) {
             }
         }
 
+        // select the huge page policy before anything is allocated
+        try {
+            huge_pages::global_policy() = huge_pages::parse_policy(options.hugepages);
+        } catch(std::invalid_argument& e) {
+            return bad_usage(cmd, e.what());
+        }
+
         // select input
         if(!options.stdin && options.generator.empty() && options.remaining.empty()) {
             return bad_usage(cmd, "missing generator, input file or standard input");
@@ -146,7 +154,6 @@ int main(int argc, char** argv) {
         }
 
         // determined later
-        std::string generated;
         size_t in_size;
 
         // select output
@@ -241,8 +248,7 @@ int main(int argc, char** argv) {
                 inp = Input(std::cin);
                 in_size = 0;
             } else if(generator) { // input from generated string
-                generated = generator->generate();
-                inp = Input(generated);
+                inp = generator->input();
                 in_size = inp.size();
             } else { // input from file
                 inp = Input(io::Path{file});
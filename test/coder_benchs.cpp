@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+#include "test/util.hpp"
+#include "test/bench_util.hpp"
+
+#include <iomanip>
+#include <random>
+
+#include <tudocomp/CreateAlgorithm.hpp>
+#include <tudocomp/io.hpp>
+
+#include <tudocomp/coders/BitCoder.hpp>
+#include <tudocomp/coders/BlockHuffmanCoder.hpp>
+#include <tudocomp/coders/EliasDeltaCoder.hpp>
+#include <tudocomp/coders/EliasGammaCoder.hpp>
+#include <tudocomp/coders/RANSCoder.hpp>
+
+#include <tudocomp/compressors/LZ78Compressor.hpp>
+#include <tudocomp/compressors/LZSSLCPCompressor.hpp>
+#include <tudocomp/compressors/LZWCompressor.hpp>
+#include <tudocomp/compressors/lz78/BinaryTrie.hpp>
+#include <tudocomp/compressors/lz78/TernaryTrie.hpp>
+
+using namespace tdc;
+
+const size_t BENCH_SYMBOLS = 1 << 22;
+const size_t BENCH_TEXT = 1 << 23;
+
+void print(const std::string& name, const std::string& unit, double enc, double dec) {
+    std::cout << std::setw(30) << std::left << name
+              << std::setw(10) << std::right
+              << std::fixed << std::setprecision(3)
+              << enc << " " << unit << " (enc)"
+              << std::setw(10) << dec << " " << unit << " (dec)"
+              << std::endl;
+}
+
+/// Prints the median time per symbol needed to encode and decode
+/// BENCH_SYMBOLS values with the given coder.
+///
+/// The encode function is called with the encoder and the symbol index,
+/// the decode function with the decoder and the symbol index and is expected
+/// to return what was encoded for that index.
+template<typename coder_t, typename enc_f, typename dec_f>
+void bench_coder(const std::string& name, enc_f enc, dec_f dec, size_t repetitions = 5) {
+    Timings enc_times, dec_times;
+    for(size_t rep = 0; rep < repetitions; rep++) {
+        std::vector<uint8_t> buffer;
+
+        enc_times.measure([&]{
+            Output out(buffer);
+            typename coder_t::Encoder coder(
+                create_env(coder_t::meta()), out, NoLiterals());
+
+            for(size_t i = 0; i < BENCH_SYMBOLS; i++) enc(coder, i);
+        });
+        bool correct = true;
+        dec_times.measure([&]{
+            Input in(buffer);
+            typename coder_t::Decoder decoder(create_env(coder_t::meta()), in);
+
+            for(size_t i = 0; i < BENCH_SYMBOLS; i++) correct &= dec(decoder, i);
+        });
+        ASSERT_TRUE(correct) << name;
+    }
+
+    print(name, "ns/symbol",
+        enc_times.median() / BENCH_SYMBOLS,
+        dec_times.median() / BENCH_SYMBOLS);
+}
+
+/// Prints the median time per symbol needed to encode and decode the given
+/// values of the given range in batches of `batch` values.
+template<typename coder_t, typename value_t, typename range_t>
+void bench_batch(const std::string& name, const std::vector<value_t>& values,
+    const range_t& r, size_t batch = 256, size_t repetitions = 5) {
+
+    Timings enc_times, dec_times;
+    for(size_t rep = 0; rep < repetitions; rep++) {
+        std::vector<uint8_t> buffer;
+        std::vector<value_t> decoded(values.size());
+
+        enc_times.measure([&]{
+            Output out(buffer);
+            typename coder_t::Encoder coder(
+                create_env(coder_t::meta()), out, NoLiterals());
+
+            for(size_t i = 0; i < values.size(); i += batch) {
+                encode_batch(coder, values.data() + i,
+                    std::min(batch, values.size() - i), r);
+            }
+        });
+        dec_times.measure([&]{
+            Input in(buffer);
+            typename coder_t::Decoder decoder(create_env(coder_t::meta()), in);
+
+            for(size_t i = 0; i < values.size(); i += batch) {
+                decode_batch(decoder, decoded.data() + i,
+                    std::min(batch, values.size() - i), r);
+            }
+        });
+        ASSERT_EQ(values, decoded) << name;
+    }
+
+    print(name, "ns/symbol",
+        enc_times.median() / values.size(),
+        dec_times.median() / values.size());
+}
+
+/// Prints the median time per input byte needed to compress and decompress
+/// the given text with the given compressor.
+template<typename comp_t>
+void bench_compressor(const std::string& name, const std::string& text, size_t repetitions = 3) {
+    auto compressor = create_algo<comp_t>();
+
+    Timings enc_times, dec_times;
+    for(size_t rep = 0; rep < repetitions; rep++) {
+        std::vector<uint8_t> compressed, decompressed;
+
+        enc_times.measure([&]{
+            Input in(text);
+            Output out(compressed);
+            compressor.compress(in, out);
+        });
+        dec_times.measure([&]{
+            Input in(compressed);
+            Output out(decompressed);
+            compressor.decompress(in, out);
+        });
+        ASSERT_EQ(text, std::string(decompressed.begin(), decompressed.end())) << name;
+    }
+
+    print(name, "ns/byte",
+        enc_times.median() / text.size(),
+        dec_times.median() / text.size());
+}
+
+TEST(CoderBench, per_symbol) {
+    std::mt19937 gen(42);
+    std::vector<uint32_t> values(BENCH_SYMBOLS);
+    for(auto& v : values) v = gen() % 100000;
+
+    bench_coder<BitCoder>("bit::literal_r",
+        [&](BitCoder::Encoder& c, size_t i) { c.encode(uliteral_t(values[i]), literal_r); },
+        [&](BitCoder::Decoder& d, size_t i) { return d.decode<uliteral_t>(literal_r) == uliteral_t(values[i]); });
+    bench_coder<BitCoder>("bit::len_r",
+        [&](BitCoder::Encoder& c, size_t i) { c.encode(values[i], len_r); },
+        [&](BitCoder::Decoder& d, size_t i) { return d.decode<len_t>(len_r) == values[i]; });
+    bench_coder<BitCoder>("bit::Range(dynamic)",
+        [&](BitCoder::Encoder& c, size_t i) { c.encode(values[i], Range(i + 100000)); },
+        [&](BitCoder::Decoder& d, size_t i) { return d.decode<len_t>(Range(i + 100000)) == values[i]; });
+    bench_coder<BitCoder>("bit::FixedRange",
+        [&](BitCoder::Encoder& c, size_t i) { c.encode(values[i], FixedRange<0, 99999>()); },
+        [&](BitCoder::Decoder& d, size_t i) { return d.decode<len_t>(FixedRange<0, 99999>()) == values[i]; });
+    bench_coder<BitCoder>("bit::bit_r",
+        [&](BitCoder::Encoder& c, size_t i) { c.encode(values[i] & 1, bit_r); },
+        [&](BitCoder::Decoder& d, size_t i) { return d.decode<bool>(bit_r) == bool(values[i] & 1); });
+
+    // literals with an entropy of about 5.7 bits
+    std::geometric_distribution<size_t> dist(0.05);
+    std::vector<uliteral_t> literals(BENCH_SYMBOLS);
+    for(auto& c : literals) c = uliteral_t(dist(gen));
+
+    bench_coder<BlockHuffmanCoder>("bhuff::literal_r",
+        [&](BlockHuffmanCoder::Encoder& c, size_t i) { c.encode(literals[i], literal_r); },
+        [&](BlockHuffmanCoder::Decoder& d, size_t i) { return d.decode<uliteral_t>(literal_r) == literals[i]; });
+    bench_coder<RANSCoder>("rans::literal_r",
+        [&](RANSCoder::Encoder& c, size_t i) { c.encode(literals[i], literal_r); },
+        [&](RANSCoder::Decoder& d, size_t i) { return d.decode<uliteral_t>(literal_r) == literals[i]; });
+    bench_coder<EliasGammaCoder>("gamma::Range",
+        [&](EliasGammaCoder::Encoder& c, size_t i) { c.encode(values[i], Range(100000)); },
+        [&](EliasGammaCoder::Decoder& d, size_t i) { return d.decode<len_t>(Range(100000)) == values[i]; });
+    bench_coder<EliasDeltaCoder>("delta::Range",
+        [&](EliasDeltaCoder::Encoder& c, size_t i) { c.encode(values[i], Range(100000)); },
+        [&](EliasDeltaCoder::Decoder& d, size_t i) { return d.decode<len_t>(Range(100000)) == values[i]; });
+}
+
+TEST(CoderBench, batch) {
+    std::mt19937 gen(42);
+    std::vector<len_t> values(BENCH_SYMBOLS);
+    for(auto& v : values) v = gen() % 100000;
+
+    std::geometric_distribution<size_t> dist(0.05);
+    std::vector<uliteral_t> literals(BENCH_SYMBOLS);
+    for(auto& c : literals) c = uliteral_t(dist(gen));
+
+    bench_batch<BitCoder>("bit::literal_r (batch)", literals, literal_r);
+    bench_batch<BitCoder>("bit::Range (batch)", values, Range(100000));
+    bench_batch<BlockHuffmanCoder>("bhuff::literal_r (batch)", literals, literal_r);
+    bench_batch<RANSCoder>("rans::literal_r (batch)", literals, literal_r);
+    bench_batch<EliasGammaCoder>("gamma::Range (batch)", values, Range(100000));
+}
+
+/// The bitwise universal codes the word-level ones in BitIStream and
+/// BitOStream are measured against.
+namespace bitwise {
+    void write_gamma(BitOStream& out, uint64_t v) {
+        for(size_t k = bits_for(v); k; k--) out.write_bit(0);
+        out.write_bit(1);
+        out.write_int(v, bits_for(v));
+    }
+
+    void write_delta(BitOStream& out, uint64_t v) {
+        write_gamma(out, bits_for(v));
+        out.write_int(v, bits_for(v));
+    }
+
+    uint64_t read_gamma(BitIStream& in) {
+        size_t bits = 0;
+        while(!in.read_bit()) ++bits;
+        return in.read_int<uint64_t>(bits);
+    }
+
+    uint64_t read_delta(BitIStream& in) {
+        return in.read_int<uint64_t>(read_gamma(in));
+    }
+}
+
+/// Prints the median time per value needed to write and read the given
+/// values with the given functions.
+template<typename write_f, typename read_f>
+void bench_code(const std::string& name, const std::vector<uint64_t>& values,
+    write_f write, read_f read, size_t repetitions = 5) {
+
+    Timings enc_times, dec_times;
+    for(size_t rep = 0; rep < repetitions; rep++) {
+        std::vector<uint8_t> buffer;
+
+        enc_times.measure([&]{
+            Output output(buffer);
+            BitOStream out(output);
+            for(auto v : values) write(out, v);
+        });
+        bool correct = true;
+        dec_times.measure([&]{
+            Input input(buffer);
+            BitIStream in(input);
+            for(auto v : values) correct &= (read(in) == v);
+        });
+        ASSERT_TRUE(correct) << name;
+    }
+
+    print(name, "ns/value",
+        enc_times.median() / values.size(),
+        dec_times.median() / values.size());
+}
+
+TEST(CoderBench, universal_codes) {
+    std::mt19937_64 gen(42);
+    std::geometric_distribution<uint64_t> small(0.1);
+
+    std::vector<std::pair<std::string, std::vector<uint64_t>>> distributions {
+        { "geometric(0.1)", {} }, { "uniform 20 bits", {} }, { "uniform 64 bits", {} },
+    };
+    for(size_t i = 0; i < BENCH_SYMBOLS; i++) {
+        distributions[0].second.push_back(small(gen));
+        distributions[1].second.push_back(gen() >> 44);
+        distributions[2].second.push_back(gen() >> (gen() % 64));
+    }
+
+    for(auto& d : distributions) {
+        auto& values = d.second;
+        bench_code("gamma, bitwise: " + d.first, values,
+            [](BitOStream& out, uint64_t v) { bitwise::write_gamma(out, v); },
+            [](BitIStream& in) { return bitwise::read_gamma(in); });
+        bench_code("gamma: " + d.first, values,
+            [](BitOStream& out, uint64_t v) { out.write_elias_gamma(v); },
+            [](BitIStream& in) { return in.read_elias_gamma<uint64_t>(); });
+        bench_code("delta, bitwise: " + d.first, values,
+            [](BitOStream& out, uint64_t v) { bitwise::write_delta(out, v); },
+            [](BitIStream& in) { return bitwise::read_delta(in); });
+        bench_code("delta: " + d.first, values,
+            [](BitOStream& out, uint64_t v) { out.write_elias_delta(v); },
+            [](BitIStream& in) { return in.read_elias_delta<uint64_t>(); });
+    }
+}
+
+TEST(CoderBench, compressors) {
+    // a text of random words, such that factors are neither trivially
+    // long nor only single characters
+    const std::string words[] = {
+        "the ", "compress", "ion ", "of ", "data ",
+        "suffix ", "array ", "and ", "a ", "tree "
+    };
+    std::mt19937 gen(42);
+    std::string text;
+    while(text.size() < BENCH_TEXT) text += words[gen() % 10];
+
+    bench_compressor<LZ78Compressor<BitCoder, lz78::BinaryTrie>>(
+        "lz78(bit, binary)", text);
+    bench_compressor<LZ78Compressor<EliasGammaCoder, lz78::BinaryTrie>>(
+        "lz78(gamma, binary)", text);
+    bench_compressor<LZ78Compressor<BitCoder, lz78::TernaryTrie>>(
+        "lz78(bit, ternary)", text);
+    bench_compressor<LZWCompressor<BitCoder, lz78::BinaryTrie>>(
+        "lzw(bit, binary)", text);
+    bench_compressor<LZWCompressor<EliasGammaCoder, lz78::TernaryTrie>>(
+        "lzw(gamma, ternary)", text);
+    bench_compressor<LZSSLCPCompressor<BitCoder>>(
+        "lzss_lcp(bit)", text + '\0');
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include <tudocomp/Generator.hpp>
 #include <tudocomp/Compressor.hpp>
 #include <tudocomp/CreateAlgorithm.hpp>
@@ -10,9 +12,12 @@
 #include <tudocomp/generators/ThueMorseGenerator.hpp>
 
 #include <tudocomp/coders/ASCIICoder.hpp>
+#include <tudocomp/coders/BitCoder.hpp>
 #include <tudocomp/coders/EliasDeltaCoder.hpp>
 #include <tudocomp/coders/EliasGammaCoder.hpp>
 #include <tudocomp/coders/HuffmanCoder.hpp>
+#include <tudocomp/coders/BlockHuffmanCoder.hpp>
+#include <tudocomp/coders/RANSCoder.hpp>
 #include <tudocomp/coders/SLECoder.hpp>
 #include <tudocomp/coders/ArithmeticCoder.hpp>
 #include <tudocomp/coders/TernaryCoder.hpp>
@@ -185,6 +190,132 @@ void test_mixed() {
     }
 }
 
+template<typename coder_t>
+void test_batch() {
+    // Generate a fibonacci word and use it as test subject
+    const std::string word = FibonacciGenerator::generate(20);
+    const std::vector<uliteral_t> literals(word.begin(), word.end());
+    const size_t n = literals.size();
+
+    std::unique_ptr<bool[]> bits(new bool[n]);
+    for(size_t i = 0; i < n; i++) bits[i] = (word[i] == 'a');
+
+    std::vector<size_t> ints;
+    for(size_t i = 0; i < n; i++) ints.push_back(3 + (i * i) % 1000);
+    const Range int_r(3, 1002);
+    const MinDistributedRange min_r(3, 1002);
+
+    // the literals are encoded in batches of varying size
+    const size_t splits[] = { 0, 1, 18, 1000, n };
+
+    // encode each value on its own and in batches, which must be equivalent
+    std::stringstream single, batch;
+    {
+        Output out(single);
+        typename coder_t::Encoder coder(create_env(coder_t::meta()), out, ViewLiterals(word));
+
+        for(size_t i = 0; i < n; i++) coder.encode(bits[i], bit_r);
+        for(size_t i = 0; i < n; i++) coder.encode(ints[i], int_r);
+        for(size_t i = 0; i < n; i++) coder.encode(ints[i], min_r);
+        for(size_t i = 0; i < n; i++) coder.encode(literals[i], literal_r);
+    }
+    {
+        Output out(batch);
+        typename coder_t::Encoder coder(create_env(coder_t::meta()), out, ViewLiterals(word));
+
+        encode_batch(coder, bits.get(), n, bit_r);
+        encode_batch(coder, ints.data(), n, int_r);
+        encode_batch(coder, ints.data(), n, min_r);
+        for(size_t j = 0; j + 1 < 5; j++) {
+            encode_batch(coder, literals.data() + splits[j],
+                splits[j + 1] - splits[j], literal_r);
+        }
+    }
+    ASSERT_EQ(single.str(), batch.str());
+
+    // Decode
+    std::string result = batch.str();
+    {
+        Input in(result);
+        typename coder_t::Decoder decoder(create_env(coder_t::meta()), in);
+
+        std::unique_ptr<bool[]> dec_bits(new bool[n]);
+        decode_batch(decoder, dec_bits.get(), n, bit_r);
+        ASSERT_TRUE(std::equal(bits.get(), bits.get() + n, dec_bits.get()));
+
+        std::vector<size_t> dec_ints(n);
+        decode_batch(decoder, dec_ints.data(), n, int_r);
+        ASSERT_EQ(ints, dec_ints);
+        decode_batch(decoder, dec_ints.data(), n, min_r);
+        ASSERT_EQ(ints, dec_ints);
+
+        std::vector<uliteral_t> dec_literals(n);
+        for(size_t j = 0; j + 1 < 5; j++) {
+            decode_batch(decoder, dec_literals.data() + splits[j],
+                splits[j + 1] - splits[j], literal_r);
+        }
+        ASSERT_EQ(literals, dec_literals);
+        ASSERT_TRUE(decoder.eof());
+    }
+}
+
+TEST(coder, bit_batch) { test_batch<BitCoder>(); }
+
+TEST(coder, bit_fixed_ranges) {
+    // ranges known at compile time are encoded like the equivalent ranges
+    // given at run time
+    std::mt19937_64 gen(7);
+    std::vector<size_t> values(1000);
+    for(auto& v : values) v = gen();
+
+    const size_t len_max = std::numeric_limits<len_t>::max();
+
+    std::stringstream fixed, runtime;
+    {
+        Output out(fixed);
+        BitCoder::Encoder coder(create_env(BitCoder::meta()), out, NoLiterals());
+        for(size_t v : values) {
+            coder.encode(5 + v % 996, FixedRange<5, 1000>());
+            coder.encode(uliteral_t(v), literal_r);
+            coder.encode(len_t(v), len_r);
+            coder.encode(v, size_r);
+        }
+    }
+    {
+        Output out(runtime);
+        BitCoder::Encoder coder(create_env(BitCoder::meta()), out, NoLiterals());
+        for(size_t v : values) {
+            coder.encode(5 + v % 996, Range(5, 1000));
+            coder.encode(uliteral_t(v), Range(255));
+            coder.encode(len_t(v), Range(len_max));
+            coder.encode(v, Range(SIZE_MAX));
+        }
+    }
+    ASSERT_EQ(runtime.str(), fixed.str());
+
+    std::string result = fixed.str();
+    {
+        Input in(result);
+        BitCoder::Decoder decoder(create_env(BitCoder::meta()), in);
+        for(size_t v : values) {
+            ASSERT_EQ(5 + v % 996, (decoder.decode<size_t>(FixedRange<5, 1000>())));
+            ASSERT_EQ(uliteral_t(v), decoder.decode<uliteral_t>(literal_r));
+            ASSERT_EQ(len_t(v), decoder.decode<len_t>(len_r));
+            ASSERT_EQ(v, decoder.decode<size_t>(size_r));
+        }
+        ASSERT_TRUE(decoder.eof());
+    }
+}
+TEST(coder, ascii_batch) { test_batch<ASCIICoder>(); }
+TEST(coder, sle_batch) { test_batch<SLECoder>(); }
+TEST(coder, delta_batch) { test_batch<EliasDeltaCoder>(); }
+TEST(coder, gamma_batch) { test_batch<EliasGammaCoder>(); }
+TEST(coder, huff_batch) { test_batch<HuffmanCoder>(); }
+TEST(coder, bhuff_batch) { test_batch<BlockHuffmanCoder>(); }
+TEST(coder, rans_batch) { test_batch<RANSCoder>(); }
+TEST(coder, arithm_batch) { test_batch<ArithmeticCoder>(); }
+TEST(coder, ternary_batch) { test_batch<TernaryCoder>(); }
+
 TEST(coder, ascii_mt) { test_mt<ASCIICoder>(); }
 TEST(coder, ascii_bits) { test_bits<ASCIICoder>(); }
 TEST(coder, ascii_int) { test_int<ASCIICoder>(); }
@@ -215,6 +346,111 @@ TEST(coder, huff_int) { test_int<HuffmanCoder>(); }
 TEST(coder, huff_str) { test_str<HuffmanCoder>(); }
 TEST(coder, huff_mixed) { test_mixed<HuffmanCoder>(); }
 
+TEST(coder, bhuff_mt) { test_mt<BlockHuffmanCoder>(); }
+TEST(coder, bhuff_bits) { test_bits<BlockHuffmanCoder>(); }
+TEST(coder, bhuff_int) { test_int<BlockHuffmanCoder>(); }
+TEST(coder, bhuff_str) { test_str<BlockHuffmanCoder>(); }
+TEST(coder, bhuff_mixed) { test_mixed<BlockHuffmanCoder>(); }
+
+TEST(coder, bhuff_blocks) {
+    // small blocks such that the code gets rebuilt many times
+    const std::string word = FibonacciGenerator::generate(20) + ThueMorseGenerator::generate(12);
+
+    std::stringstream ss;
+    {
+        Output out(ss);
+        BlockHuffmanCoder::Encoder coder(create_env(BlockHuffmanCoder::meta(), "block=7"), out, NoLiterals());
+
+        for(size_t i = 0; i < word.length(); i++) {
+            coder.encode(word[i], literal_r);
+            coder.encode(i, size_r);
+        }
+    }
+
+    std::string result = ss.str();
+    {
+        Input in(result);
+        BlockHuffmanCoder::Decoder decoder(create_env(BlockHuffmanCoder::meta(), "block=7"), in);
+
+        for(size_t i = 0; i < word.length(); i++) {
+            ASSERT_EQ(uliteral_t(word[i]), decoder.template decode<uliteral_t>(literal_r)) << "i=" << i;
+            ASSERT_EQ(i, decoder.template decode<size_t>(size_r));
+        }
+    }
+
+    // the skewed distribution must take less than 8 bits per literal
+    ASSERT_LT(result.size(), word.length() * (1 + sizeof(size_t)));
+}
+
+TEST(coder, rans_mt) { test_mt<RANSCoder>(); }
+TEST(coder, rans_bits) { test_bits<RANSCoder>(); }
+TEST(coder, rans_int) { test_int<RANSCoder>(); }
+TEST(coder, rans_str) { test_str<RANSCoder>(); }
+TEST(coder, rans_mixed) { test_mixed<RANSCoder>(); }
+
+TEST(coder, rans_blocks) {
+    // blocks of varying lengths that are not a multiple of the lanes,
+    // interleaved with other values
+    const std::string word = FibonacciGenerator::generate(20) + ThueMorseGenerator::generate(12);
+
+    for(auto block : { "1", "7", "100000" }) {
+        const std::string options = std::string("block=") + block;
+
+        std::stringstream ss;
+        {
+            Output out(ss);
+            RANSCoder::Encoder coder(create_env(RANSCoder::meta(), options), out, NoLiterals());
+
+            for(size_t i = 0; i < word.length(); i++) {
+                coder.encode(word[i], literal_r);
+                coder.encode(i, size_r);
+                if(i % 3 == 0) coder.encode(i % 2, bit_r);
+            }
+        }
+
+        std::string result = ss.str();
+        {
+            Input in(result);
+            RANSCoder::Decoder decoder(create_env(RANSCoder::meta(), options), in);
+
+            for(size_t i = 0; i < word.length(); i++) {
+                ASSERT_EQ(uliteral_t(word[i]), decoder.template decode<uliteral_t>(literal_r)) << "i=" << i;
+                ASSERT_EQ(i, decoder.template decode<size_t>(size_r));
+                if(i % 3 == 0) {
+                    ASSERT_EQ(bool(i % 2), decoder.template decode<bool>(bit_r));
+                }
+            }
+            ASSERT_TRUE(decoder.eof());
+        }
+    }
+}
+
+TEST(coder, rans_alphabet) {
+    // all literals, with a skewed distribution
+    std::mt19937 gen(42);
+    std::geometric_distribution<size_t> dist(0.05);
+    std::vector<uliteral_t> literals(300000);
+    for(auto& c : literals) c = uliteral_t(dist(gen));
+
+    std::vector<uint8_t> result;
+    {
+        Output out(result);
+        RANSCoder::Encoder coder(create_env(RANSCoder::meta()), out, NoLiterals());
+        for(auto c : literals) coder.encode(c, literal_r);
+    }
+    {
+        Input in(result);
+        RANSCoder::Decoder decoder(create_env(RANSCoder::meta()), in);
+        for(size_t i = 0; i < literals.size(); i++) {
+            ASSERT_EQ(literals[i], decoder.template decode<uliteral_t>(literal_r)) << "i=" << i;
+        }
+        ASSERT_TRUE(decoder.eof());
+    }
+
+    // the entropy of the distribution is about 5.7 bits
+    ASSERT_LT(result.size(), literals.size() * 6 / 8);
+}
+
 TEST(coder, arithm_mt) { test_mt<ArithmeticCoder>(); }
 TEST(coder, arithm_bits) { test_bits<ArithmeticCoder>(); }
 TEST(coder, arithm_int) { test_int<ArithmeticCoder>(); }
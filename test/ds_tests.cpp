@@ -11,6 +11,10 @@
 #include <tudocomp/ds/bwt.hpp>
 #include <tudocomp/ds/SparseISA.hpp>
 #include <tudocomp/ds/CompressedLCP.hpp>
+#include <tudocomp/ds/PhiFromSAParallel.hpp>
+#include <tudocomp/ds/PLCPFromPhiParallel.hpp>
+#include <tudocomp/ds/LCPFromPLCPParallel.hpp>
+#include <tudocomp/compressors/lcpcomp/compress/PLCPArraysComp.hpp>
 #include <tudocomp/CreateAlgorithm.hpp>
 #include "test/util.hpp"
 
@@ -160,3 +164,149 @@ using textds_comp_lcp_t = TextDS<
 
 TEST(ds, comp_lcp_LCP)         { TEST_DS_STRINGCOLLECTION(textds_comp_lcp_t, test_lcp); }
 TEST(ds, comp_lcp_Integration) { TEST_DS_STRINGCOLLECTION(textds_comp_lcp_t, test_all_ds); }
+
+using textds_parallel_t = TextDS<
+    SADivSufSort, PhiFromSAParallel, PLCPFromPhiParallel, LCPFromPLCPParallel, ISAFromSA>;
+
+TEST(ds, parallel_LCP)         { TEST_DS_STRINGCOLLECTION(textds_parallel_t, test_lcp); }
+TEST(ds, parallel_Integration) { TEST_DS_STRINGCOLLECTION(textds_parallel_t, test_all_ds); }
+
+TEST(ds, parallel_threads) {
+    // large enough to be split among the threads
+    for(auto& str : {
+        RandomUniformGenerator::generate(200000, 3, 'a', 'c'),
+        FibonacciGenerator::generate(26),
+        RunRichGenerator::generate(17)}) {
+
+        test::TestInput input = test::compress_input(str);
+        InputView in = input.as_view();
+
+        for(const std::string cm : { "plain", "compressed", "delayed" }) {
+            auto seq = create_algo<textds_default_t>("compress=\"" + cm + "\"", in);
+            auto par = create_algo<textds_parallel_t>("compress=\"" + cm + "\", threads=4", in);
+
+            par.require(textds_parallel_t::SA | textds_parallel_t::PHI |
+                        textds_parallel_t::PLCP | textds_parallel_t::LCP);
+            seq.require(textds_default_t::SA | textds_default_t::PHI |
+                        textds_default_t::PLCP | textds_default_t::LCP);
+
+            auto& phi = par.require_phi();
+            auto& plcp = par.require_plcp();
+            auto& lcp = par.require_lcp();
+            ASSERT_EQ(plcp.max_lcp(), seq.require_plcp().max_lcp());
+            ASSERT_EQ(lcp.max_lcp(), seq.require_lcp().max_lcp());
+            for(size_t i = 0; i < in.size(); ++i) {
+                ASSERT_EQ(phi[i], seq.require_phi()[i]) << cm << " i=" << i;
+                ASSERT_EQ(plcp[i], seq.require_plcp()[i]) << cm << " i=" << i;
+                ASSERT_EQ(lcp[i], seq.require_lcp()[i]) << cm << " i=" << i;
+            }
+        }
+    }
+}
+
+TEST(ds, disk_backed) {
+    const std::string str = RandomUniformGenerator::generate(100000, 3, 'a', 'c');
+    test::TestInput input = test::compress_input(str);
+    InputView in = input.as_view();
+
+    for(const std::string cm : { "plain", "compressed", "delayed" }) {
+        auto heap = create_algo<textds_default_t>("compress=\"" + cm + "\"", in);
+        auto disk = create_algo<textds_default_t>(
+            "compress=\"" + cm + "\", disk=\"sa,lcp,isa\"", in);
+
+        auto& sa = disk.require_sa();
+        auto& lcp = disk.require_lcp();
+        auto& isa = disk.require_isa();
+        ASSERT_TRUE(sa.disk_backed());
+        ASSERT_TRUE(lcp.disk_backed());
+        ASSERT_TRUE(isa.disk_backed());
+
+        ASSERT_EQ((const DynamicIntVector&) sa, (const DynamicIntVector&) heap.require_sa());
+        ASSERT_EQ((const DynamicIntVector&) lcp, (const DynamicIntVector&) heap.require_lcp());
+        ASSERT_EQ((const DynamicIntVector&) isa, (const DynamicIntVector&) heap.require_isa());
+    }
+
+    for(const std::string cm : { "plain", "compressed", "delayed" }) {
+        auto disk = create_algo<textds_default_t>(
+            "compress=\"" + cm + "\", disk=\"all\", tmp=\".\"", in);
+        disk.require(textds_default_t::SA | textds_default_t::PLCP |
+                     textds_default_t::LCP | textds_default_t::ISA);
+        ASSERT_TRUE(disk.require_plcp().disk_backed());
+        test_all_ds(str, disk);
+    }
+}
+
+TEST(ds, plcp_arrays_comp) {
+    for(auto& str : {
+        RandomUniformGenerator::generate(20000, 3, 'a', 'c'),
+        FibonacciGenerator::generate(20),
+        RunRichGenerator::generate(14)}) {
+
+        test::TestInput input = test::compress_input(str);
+        InputView in = input.as_view();
+        const len_t n = in.size();
+
+        // the PLCP array it works on matches the existing LCP construction
+        {
+            auto plcp_ds = create_algo<textds_default_t>("", in);
+            auto lcp_ds = create_algo<textds_default_t>("", in);
+            plcp_ds.require(textds_default_t::PHI | textds_default_t::PLCP);
+            lcp_ds.require(textds_default_t::SA | textds_default_t::LCP);
+
+            auto& phi = plcp_ds.require_phi();
+            auto& plcp = plcp_ds.require_plcp();
+            auto& sa = lcp_ds.require_sa();
+            auto& lcp = lcp_ds.require_lcp();
+            ASSERT_EQ(plcp.max_lcp(), lcp.max_lcp());
+            for(len_t i = 1; i < n; ++i) {
+                ASSERT_EQ(phi[sa[i]], sa[i-1]) << "i=" << i;
+                ASSERT_EQ(plcp[sa[i]], lcp[i]) << "i=" << i;
+            }
+        }
+
+        for(len_t threshold : { 2, 5 }) {
+            auto text = create_algo<textds_default_t>("", in);
+            auto comp = create_algo<lcpcomp::PLCPArraysComp>("");
+            lzss::FactorBuffer factors;
+            comp.factorize(text, threshold, factors);
+            ASSERT_FALSE(factors.empty());
+
+            // the factors are valid and do not overlap
+            std::vector<int> decoded(n, -1);
+            std::vector<bool> covered(n, false);
+            for(size_t j = 0; j < factors.size(); ++j) {
+                const len_t pos = factors.pos(j);
+                const len_t src = factors.src(j);
+                const len_t len = factors.len(j);
+                ASSERT_GE(len, threshold);
+                ASSERT_NE(pos, src);
+                for(len_t k = 0; k < len; ++k) {
+                    ASSERT_FALSE(covered[pos + k]) << "pos=" << pos + k;
+                    covered[pos + k] = true;
+                    ASSERT_EQ(in[pos + k], in[src + k]);
+                }
+            }
+
+            // decode the text from the literals and factors
+            for(len_t i = 0; i < n; ++i) {
+                if(!covered[i]) decoded[i] = in[i];
+            }
+            for(bool progress = true; progress;) {
+                progress = false;
+                for(size_t j = 0; j < factors.size(); ++j) {
+                    const len_t pos = factors.pos(j);
+                    const len_t src = factors.src(j);
+                    for(len_t k = 0; k < factors.len(j); ++k) {
+                        if(decoded[pos + k] < 0 && decoded[src + k] >= 0) {
+                            decoded[pos + k] = decoded[src + k];
+                            progress = true;
+                        }
+                    }
+                }
+            }
+            for(len_t i = 0; i < n; ++i) {
+                ASSERT_EQ(int(in[i]), decoded[i]) << "threshold=" << threshold << " i=" << i;
+            }
+        }
+    }
+}
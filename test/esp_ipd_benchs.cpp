@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "test/util.hpp"
+#include "test/bench_util.hpp"
+
+#include <tudocomp/compressors/esp/EspContextImpl.hpp>
+#include <tudocomp/compressors/esp/RoundContextImpl.hpp>
+
+#include <tudocomp/compressors/esp/StdUnorderedMapIPD.hpp>
+#include <tudocomp/compressors/esp/HashMapIPD.hpp>
+#include <tudocomp/compressors/esp/DynamicSizeIPD.hpp>
+#include <tudocomp/compressors/esp/LinearProbingIPD.hpp>
+
+using namespace tdc;
+
+/// The key sequences GrammarRules sends to its IPD, one entry per round.
+using round_keys_t = std::deque<std::vector<esp::Array<2>>>;
+
+static round_keys_t* recorded_keys = nullptr;
+
+/// IPD that records every access of a real ESP run
+/// and otherwise behaves like the std::unordered_map IPD.
+class RecordingIPD: public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("ipd", "recording");
+        return m;
+    };
+
+    using Algorithm::Algorithm;
+
+    template<size_t N, typename K, typename V>
+    class IPDMap {
+        esp::StdUnorderedMapIPD::IPDMap<N, K, V> m_map;
+        std::vector<esp::Array<2>>* m_keys;
+    public:
+        inline IPDMap(size_t bucket_count, const esp::Array<N, K>& empty):
+            m_map(bucket_count, empty)
+        {
+            recorded_keys->emplace_back();
+            m_keys = &recorded_keys->back();
+        }
+
+        template<typename Updater>
+        inline V access(const esp::Array<N, K>& key, Updater updater) {
+            m_keys->push_back(key);
+            return m_map.access(key, updater);
+        }
+
+        inline size_t size() const {
+            return m_map.size();
+        }
+
+        template<typename F>
+        void for_all(F f) const {
+            m_map.for_all(f);
+        }
+    };
+};
+
+round_keys_t record_rounds(const std::string& text) {
+    round_keys_t keys;
+    recorded_keys = &keys;
+    {
+        esp::EspContext<RecordingIPD> context { nullptr, true };
+        context.generate_grammar(View(text));
+    }
+    recorded_keys = nullptr;
+
+    // drop the key lists of maps that only got moved around
+    keys.erase(std::remove_if(keys.begin(), keys.end(), [](auto& v) {
+        return v.empty();
+    }), keys.end());
+
+    return keys;
+}
+
+template<typename ipd_t>
+void bench_ipd(const std::string& name,
+               const std::string& input_name,
+               const round_keys_t& rounds,
+               size_t repetitions = 5)
+{
+    using map_t = typename ipd_t::template IPDMap<2, size_t, size_t>;
+
+    size_t lookups = 0;
+    for (auto& r : rounds) lookups += r.size();
+
+    test::bench_median("[" + input_name + "] " + name, "ns/lookup", lookups, [&]{
+        size_t checksum = 0;
+        for (auto& r : rounds) {
+            size_t counter = 1;
+            auto updater = [&](size_t& v) {
+                if (v == 0) {
+                    v = counter++;
+                }
+            };
+
+            map_t map(0, esp::Array<2>(std::array<size_t, 2> {{ size_t(-1), size_t(-1) }}));
+            for (auto& key : r) {
+                checksum += map.access(key, updater);
+            }
+        }
+        return checksum;
+    }, repetitions, 52, 2);
+}
+
+void bench_all_ipds(const std::string& input_name, const std::string& text) {
+    auto rounds = record_rounds(text);
+
+    size_t lookups = 0;
+    for (auto& r : rounds) lookups += r.size();
+    std::cout << "[" << input_name << "] "
+              << text.size() << " bytes, "
+              << rounds.size() << " rounds, "
+              << lookups << " lookups" << std::endl;
+
+    bench_ipd<esp::StdUnorderedMapIPD>("std_unordered_map", input_name, rounds);
+    bench_ipd<esp::HashMapIPD>("hash_map", input_name, rounds);
+    bench_ipd<esp::LinearProbingIPD>("linear_probing", input_name, rounds);
+    bench_ipd<esp::DynamicSizeIPD<esp::StdUnorderedMapIPD>>("dynamic_size(std_unordered_map)", input_name, rounds);
+    bench_ipd<esp::DynamicSizeIPD<esp::HashMapIPD>>("dynamic_size(hash_map)", input_name, rounds);
+    bench_ipd<esp::DynamicSizeIPD<esp::LinearProbingIPD>>("dynamic_size(linear_probing)", input_name, rounds);
+}
+
+const size_t BENCH_SIZE = 1024 * 1024;
+
+TEST(IPDBench, random) {
+    bench_all_ipds("random", RandomUniformGenerator::generate(BENCH_SIZE, 42, 'a', 'z'));
+}
+
+TEST(IPDBench, fibonacci) {
+    auto text = FibonacciGenerator::generate(34);
+    text.resize(std::min(text.size(), BENCH_SIZE));
+    bench_all_ipds("fibonacci", text);
+}
+
+TEST(IPDBench, run_rich) {
+    auto text = RunRichGenerator::generate(32);
+    text.resize(std::min(text.size(), BENCH_SIZE));
+    bench_all_ipds("run_rich", text);
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "test/util.hpp"
 
+#include <random>
+
 #include "tudocomp/compressors/EspCompressor.hpp"
 
 #include "tudocomp/compressors/esp/SLPDepSort.hpp"
@@ -13,6 +15,7 @@
 
 #include <tudocomp/compressors/esp/HashMapIPD.hpp>
 #include <tudocomp/compressors/esp/DynamicSizeIPD.hpp>
+#include <tudocomp/compressors/esp/LinearProbingIPD.hpp>
 
 using namespace tdc;
 
@@ -470,7 +473,7 @@ TEST(Esp, tree_reducer_roundtrip) {
 
 }
 
-template<typename T>
+template<typename T, typename ipd_t = esp::StdUnorderedMapIPD>
 void test_esp() {
  // TODO: ensure ESP code is parametric over input alphabet size and format
 
@@ -504,7 +507,7 @@ void test_esp() {
 
     for (auto& c : cases) {
         std::cout << "---------------------\n";
-        test::roundtrip<EspCompressor<T>>(c);
+        test::roundtrip<EspCompressor<T, ipd_t>>(c);
     }
 }
 
@@ -536,6 +539,14 @@ TEST(ESP, test_sorted_range_fit) {
    test_esp<esp::SortedSLPCoder<esp::DRangeFit>>();
 }
 
+TEST(ESP, test_linear_probing_ipd) {
+   test_esp<esp::SortedSLPCoder<>, esp::LinearProbingIPD>();
+}
+
+TEST(ESP, test_dynamic_linear_probing_ipd) {
+   test_esp<esp::SortedSLPCoder<>, esp::DynamicSizeIPD<esp::LinearProbingIPD>>();
+}
+
 /*TEST(ESP, test_optimal_arithmetic) {
    test_esp<esp::SortedSLPCoder<esp::DArithmetic>>();
 }*/
@@ -1068,6 +1079,64 @@ TEST(IPD, DynamicSize) {
     auto x = builder<esp::DynamicSizeIPD<esp::StdUnorderedMapIPD>>().instance();
 }
 
+template<size_t N>
+void test_ipd_against_reference(size_t count, size_t max_symbol) {
+    using ipd_t = esp::LinearProbingIPD::IPDMap<N, size_t, size_t>;
+    using ref_t = esp::StdUnorderedMapIPD::IPDMap<N, size_t, size_t>;
+
+    esp::Array<N> empty;
+    for (auto& x : empty.m_data) x = size_t(-1);
+
+    ipd_t ipd(0, empty);
+    ref_t ref(0, empty);
+
+    size_t counter = 1;
+    auto updater = [&](size_t& v) {
+        if (v == 0) {
+            v = counter++;
+        }
+    };
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<size_t> dist(0, max_symbol);
+    for (size_t i = 0; i < count; i++) {
+        esp::Array<N> key;
+        for (auto& x : key.m_data) x = dist(rng);
+        // exercise the overflow path for unpackable symbols
+        if (i % 97 == 0) key.m_data[0] = size_t(-2);
+
+        size_t before = counter;
+        auto a = ipd.access(key, updater);
+        size_t after = counter;
+        counter = before;
+        auto b = ref.access(key, updater);
+        ASSERT_EQ(after, counter);
+        ASSERT_EQ(a, b);
+        ASSERT_EQ(ipd.size(), ref.size());
+    }
+
+    size_t visited = 0;
+    ipd.for_all([&](const esp::Array<N>& key, const size_t& val) {
+        ref.access(key, [&](size_t& v) {
+            ASSERT_EQ(v, val);
+        });
+        visited++;
+    });
+    ASSERT_EQ(visited, ref.size());
+}
+
+TEST(IPD, LinearProbing2) {
+    test_ipd_against_reference<2>(100000, 300);
+}
+
+TEST(IPD, LinearProbing3) {
+    test_ipd_against_reference<3>(100000, 100);
+}
+
+TEST(IPD, DynamicLinearProbing) {
+    auto x = builder<esp::DynamicSizeIPD<esp::LinearProbingIPD>>().instance();
+}
+
 TEST(Hashmaps, size) {
     using namespace tdc;
     using namespace esp;
@@ -1,6 +1,10 @@
+#include <cstdlib>
+#include <fstream>
 #include <string>
 #include <vector>
 
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 #include <tudocomp/ds/IntVector.hpp>
@@ -1312,3 +1316,191 @@ TEST(generic_int_vector_application, access_dynamic_autocast) {
     iv_access_autocast_const(iv);
     iv_access_autocast_nonconst(iv);
 }
+
+/// Checks a kernel against element-wise access for all widths and
+/// unaligned start positions.
+template<typename unpack_f, typename pack_f>
+void bulk_kernel_template(unpack_f unpack, pack_f pack) {
+    const size_t n = 700;
+    for(uint8_t w = 1; w <= 64; w++) {
+        for(size_t pos : { size_t(0), size_t(1), size_t(13), size_t(64) }) {
+            const uint64_t mask = int_vector::kernels::low_bits(w);
+
+            IntVector<dynamic_t> iv(pos + n + 3, 0, w);
+            std::vector<uint64_t> expected(n);
+            uint64_t x = 0x9E3779B97F4A7C15ULL * w + pos;
+            for(size_t i = 0; i < n; i++) {
+                x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                expected[i] = x & mask;
+            }
+            for(size_t i = 0; i < iv.size(); i++) iv[i] = mask;
+
+            // values wider than w must be truncated
+            std::vector<uint64_t> wide(expected);
+            if(w < 64) wide[0] |= mask + 1;
+
+            pack(iv.data(), pos * w, w, n, wide.data());
+            ASSERT_EQ(uint64_t(iv[pos - (pos > 0)]), pos > 0 ? mask : expected[0]) << "w=" << int(w);
+            ASSERT_EQ(uint64_t(iv[pos + n]), mask) << "w=" << int(w);
+            for(size_t i = 0; i < n; i++) {
+                ASSERT_EQ(uint64_t(iv[pos + i]), expected[i]) << "w=" << int(w) << ", i=" << i;
+            }
+
+            std::vector<uint64_t> out(n + 1, 42);
+            unpack(iv.data(), pos * w, w, n, out.data());
+            ASSERT_EQ(out[n], 42u);
+            out.pop_back();
+            ASSERT_EQ(out, expected) << "w=" << int(w) << ", pos=" << pos;
+        }
+    }
+}
+
+TEST(bulk_int_vector, scalar_kernels) {
+    using namespace int_vector::kernels;
+    bulk_kernel_template(unpack_scalar<uint64_t>, pack_scalar<uint64_t>);
+}
+
+#ifdef __BMI2__
+TEST(bulk_int_vector, bmi2_kernels) {
+    using namespace int_vector::kernels;
+    bulk_kernel_template(unpack_bmi2<uint64_t>, pack_bmi2<uint64_t>);
+}
+#endif
+
+#ifdef __AVX2__
+TEST(bulk_int_vector, avx2_kernels) {
+    using namespace int_vector::kernels;
+    bulk_kernel_template(unpack_avx2, pack_avx2);
+}
+#endif
+
+template<class T>
+void bulk_int_vector_template() {
+    using value_type = typename IntVector<T>::value_type;
+    IntVector<T> iv;
+    for(size_t i = 0; i < 1000; i++) iv.push_back((i * 7) % 100);
+
+    std::vector<uint32_t> buf(300);
+    iv.unpack(500, buf.size(), buf.data());
+    for(size_t i = 0; i < buf.size(); i++) {
+        ASSERT_EQ(buf[i], uint32_t(value_type(iv[500 + i])));
+        buf[i] = (i * 3) % 100;
+    }
+
+    iv.pack(10, buf.size(), buf.data());
+    for(size_t i = 0; i < 1000; i++) {
+        const size_t expected = (i >= 10 && i < 310) ? ((i - 10) * 3) % 100 : (i * 7) % 100;
+        ASSERT_EQ(uint64_t(value_type(iv[i])), expected) << "i=" << i;
+    }
+}
+
+TEST(bulk_int_vector, uint32_t) { bulk_int_vector_template<uint32_t>(); }
+TEST(bulk_int_vector, uint_t_40) { bulk_int_vector_template<uint_t<40>>(); }
+TEST(bulk_int_vector, uint_t_9) { bulk_int_vector_template<uint_t<9>>(); }
+TEST(bulk_int_vector, dynamic_t) { bulk_int_vector_template<dynamic_t>(); }
+
+TEST(bulk_int_vector, change_width) {
+    const uint8_t widths[] = { 1, 5, 8, 13, 17, 31, 33, 40, 63, 64 };
+    const size_t n = 1000; // not a multiple of the chunk size
+
+    for(uint8_t old_w : widths) {
+        for(uint8_t new_w : widths) {
+            const uint64_t mask = int_vector::kernels::low_bits(std::min(old_w, new_w));
+
+            IntVector<dynamic_t> iv(n, 0, old_w);
+            for(size_t i = 0; i < n; i++) iv[i] = (i * 0x9E3779B97F4A7C15ULL) & mask;
+
+            iv.width(new_w);
+            ASSERT_EQ(iv.width(), new_w);
+            ASSERT_EQ(iv.size(), n);
+            for(size_t i = 0; i < n; i++) {
+                ASSERT_EQ(uint64_t(iv[i]), (i * 0x9E3779B97F4A7C15ULL) & mask)
+                    << "old_w=" << int(old_w) << ", new_w=" << int(new_w) << ", i=" << i;
+            }
+        }
+    }
+
+    // resizing while growing the width
+    IntVector<dynamic_t> iv(n, 0, 3);
+    for(size_t i = 0; i < n; i++) iv[i] = i % 8;
+    iv.resize(n + 10, 99, 7);
+    for(size_t i = 0; i < n; i++) ASSERT_EQ(uint64_t(iv[i]), i % 8);
+    for(size_t i = n; i < n + 10; i++) ASSERT_EQ(uint64_t(iv[i]), 99u);
+}
+
+TEST(disk_backed_int_vector, lifecycle) {
+    IntVector<dynamic_t> iv;
+    ASSERT_FALSE(iv.disk_backed());
+    iv.push_back(7);
+    iv.disk_backed(true);
+    ASSERT_TRUE(iv.disk_backed());
+    ASSERT_EQ(iv.size(), 1u);
+    ASSERT_EQ(iv[0], 7u);
+
+    // reallocations stay in a file
+    IntVector<dynamic_t> expected;
+    expected.push_back(7);
+    for(size_t i = 1; i < 100000; i++) {
+        iv.push_back(i * 31);
+        expected.push_back(i * 31);
+    }
+    ASSERT_TRUE(iv.disk_backed());
+    ASSERT_EQ(iv, expected);
+
+    iv.width(23);
+    expected.width(23);
+    iv.shrink_to_fit();
+    ASSERT_TRUE(iv.disk_backed());
+    ASSERT_EQ(iv, expected);
+
+    // copies and moves keep the storage location
+    IntVector<dynamic_t> copy = iv;
+    ASSERT_TRUE(copy.disk_backed());
+    ASSERT_EQ(copy, expected);
+
+    IntVector<dynamic_t> moved = std::move(copy);
+    ASSERT_TRUE(moved.disk_backed());
+    ASSERT_EQ(moved, expected);
+
+    moved.disk_backed(false);
+    ASSERT_FALSE(moved.disk_backed());
+    ASSERT_EQ(moved, expected);
+}
+
+TEST(disk_backed_int_vector, directory) {
+    std::vector<char> tmpl = { '.', '/', 't', 'd', 'c', '.', 'X', 'X', 'X', 'X', 'X', 'X', 0 };
+    ASSERT_NE(mkdtemp(tmpl.data()), nullptr);
+    const std::string dir(tmpl.data());
+
+    // returns whether a temporary file in the directory is mapped
+    auto mapped = [&]() {
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+        while(std::getline(maps, line)) {
+            if(line.find(dir.substr(1) + "/tudocomp.") != std::string::npos) return true;
+        }
+        return false;
+    };
+
+    {
+        IntVector<dynamic_t> iv;
+        for(size_t i = 0; i < 10000; i++) iv.push_back(i);
+        iv.disk_backed(true, dir);
+        ASSERT_TRUE(iv.disk_backed());
+#ifdef __linux__
+        ASSERT_TRUE(mapped());
+#endif
+        for(size_t i = 0; i < 10000; i++) ASSERT_EQ(iv[i], i);
+
+        // moving to the default directory
+        iv.disk_backed(true);
+        ASSERT_TRUE(iv.disk_backed());
+#ifdef __linux__
+        ASSERT_FALSE(mapped());
+#endif
+        for(size_t i = 0; i < 10000; i++) ASSERT_EQ(iv[i], i);
+    }
+
+    // the files are unlinked, so the directory is empty
+    ASSERT_EQ(rmdir(dir.c_str()), 0);
+}
@@ -102,6 +102,10 @@ TEST(huffman, stringgenerators) {
 	test::on_string_generators(func,20);
 }
 
+TEST(huffman, single_character) {
+	test_huff("aaaaaaaaaaaaaaaa");
+}
+
 
 // #include "tudocomp/util/Generators.hpp"
 // TEST(Sandbox, example) {
@@ -9,6 +9,12 @@
 
 #include <tudocomp/io/Input.hpp>
 #include <tudocomp/io/Output.hpp>
+#include <tudocomp/io/ChunkStream.hpp>
+
+#include <tudocomp/generators/FibonacciGenerator.hpp>
+#include <tudocomp/generators/RandomUniformGenerator.hpp>
+#include <tudocomp/generators/RunRichGenerator.hpp>
+#include <tudocomp/generators/ThueMorseGenerator.hpp>
 
 #include "test/util.hpp"
 
@@ -355,6 +361,26 @@ struct StreamSrc {
     }
 };
 
+struct GeneratedSrc {
+    std::string m_str;
+    GeneratedSrc(View v): m_str(v) {}
+
+    Input input() {
+        auto s = m_str;
+        return Input([s]() {
+            // small chunks to test chunk borders
+            size_t pos = 0;
+            return std::unique_ptr<std::istream>(new ChunkStream(
+                [s, pos](char* buf, size_t n) mutable {
+                    n = std::min(n, s.size() - pos);
+                    std::copy(s.begin() + pos, s.begin() + pos + n, buf);
+                    pos += n;
+                    return n;
+                }, 3));
+        }, s.size());
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -551,6 +577,58 @@ TEST(InputMatrix, FileSrc_DriverSplitSize) {
 TEST(InputMatrix, StreamSrc_DriverSplitSize) {
     i_matrix_test<StreamSrc, DriverSplitSize>();
 }
+TEST(InputMatrix, GeneratedSrc_Direct) {
+    i_matrix_test<GeneratedSrc, Direct>();
+}
+TEST(InputMatrix, GeneratedSrc_DriverSplit) {
+    i_matrix_test<GeneratedSrc, DriverSplit>();
+}
+TEST(InputMatrix, GeneratedSrc_DirectSize) {
+    i_matrix_test<GeneratedSrc, DirectSize>();
+}
+TEST(InputMatrix, GeneratedSrc_DriverSplitSize) {
+    i_matrix_test<GeneratedSrc, DriverSplitSize>();
+}
+
+std::string stream_to_string(const Input& i) {
+    auto x = i.as_stream();
+    std::stringstream ss;
+    ss << x.rdbuf();
+    return ss.str();
+}
+
+TEST(GeneratorInput, streams_generated_string) {
+    for(size_t n = 0; n < 24; n++) {
+        std::string fib = FibonacciGenerator::generate(n);
+        ASSERT_EQ(FibonacciGenerator::input(n).size(), fib.size());
+        ASSERT_EQ(stream_to_string(FibonacciGenerator::input(n)), fib) << n;
+
+        std::string tm = ThueMorseGenerator::generate(n);
+        ASSERT_EQ(ThueMorseGenerator::input(n).size(), tm.size());
+        ASSERT_EQ(stream_to_string(ThueMorseGenerator::input(n)), tm) << n;
+
+        std::string rr = RunRichGenerator::generate(n);
+        ASSERT_EQ(RunRichGenerator::input(n).size(), rr.size());
+        ASSERT_EQ(stream_to_string(RunRichGenerator::input(n)), rr) << n;
+    }
+}
+
+TEST(GeneratorInput, random_is_deterministic) {
+    const size_t block = RandomUniformGenerator::block_size;
+    for(size_t length : { size_t(0), size_t(100), block, 3 * block + 17 }) {
+        std::string r = RandomUniformGenerator::generate(length, 42, 'a', 'z', 1);
+        ASSERT_EQ(r, RandomUniformGenerator::generate(length, 42, 'a', 'z', 4));
+
+        for(size_t threads : { 1, 2, 4 }) {
+            Input i = RandomUniformGenerator::input(length, 42, 'a', 'z', threads);
+            ASSERT_EQ(i.size(), length);
+            ASSERT_EQ(stream_to_string(i), r);
+            // every stream yields the same string
+            ASSERT_EQ(stream_to_string(i), r);
+            ASSERT_EQ(View(i.as_view()), View(r));
+        }
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
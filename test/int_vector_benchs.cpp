@@ -1,111 +1,153 @@
-#include <string>
-#include <vector>
+#include <gtest/gtest.h>
+#include "test/util.hpp"
+#include "test/bench_util.hpp"
 
-#include <benchpress/benchpress.hpp>
+#include <iomanip>
+#include <random>
+#include <sstream>
 
-#include <tudocomp/ds/GenericIntVector.hpp>
-#include <tudocomp/util/IntegerBase.hpp>
-#include <tudocomp/ds/uint_t.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/BitPackingKernels.hpp>
 
 using namespace tdc;
-using namespace benchpress;
-
-const uint32_t N_SUB_ITER = 10000;
-
-#define ADD x += 1;
-#define ADD2 ADD ADD
-#define ADD3 ADD2 ADD2
-#define ADD4 ADD3 ADD3
-#define ADD5 ADD4 ADD4
-#define ADD6 ADD5 ADD5
-#define ADD7 ADD6 ADD6
-#define ADD8 ADD7 ADD7
-#define ADD9 ADD8 ADD8
-#define ADD10 ADD9 ADD9
-#define ADD11 ADD10 ADD10
-#define ADD12 ADD11 ADD11
-#define ADD13 ADD12 ADD12
-
-struct Inc {
-    template<class T>
-    static void op(T& x) {
-        x += 1;
-    }
-};
+namespace kernels = tdc::int_vector::kernels;
 
-struct NoOp {
-    template<class T>
-    static void op(T& x) {
-    }
-};
+const size_t BENCH_SIZE = 1 << 22;
+const uint8_t BENCH_WIDTHS[] = { 5, 12, 17, 29, 40, 64 };
 
-template<class T, class Op = Inc>
-inline void int_test(benchpress::context* ctx) {
-    T n = 0;
+/// Prints the median time per element of the given operation.
+template<typename F>
+void bench(const std::string& name, uint8_t w, size_t n, F f) {
+    std::ostringstream label;
+    label << "[w=" << std::setw(2) << int(w) << "] " << name;
+    test::bench_median(label.str(), "ns/element", n, f, 5, 37);
+}
 
-    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
-        escape(&n);
+IntVector<dynamic_t> random_vector(size_t n, uint8_t w) {
+    std::mt19937_64 gen(w);
+    IntVector<dynamic_t> iv(n, 0, w);
+    std::vector<uint64_t> values(n);
+    for (auto& v : values) v = gen() & kernels::low_bits(w);
+    iv.pack(0, n, values.data());
+    return iv;
+}
 
-        for (size_t j = 0; j < N_SUB_ITER; j++) {
-            Op::op(n);
-        }
-    }
+template<typename unpack_f>
+uint64_t run_unpack(const IntVector<dynamic_t>& iv, std::vector<uint64_t>& out, unpack_f unpack) {
+    unpack(iv.data(), 0, iv.width(), iv.size(), out.data());
+    return out[out.size() / 2];
+}
 
-    escape(&n);
+template<typename pack_f>
+uint64_t run_pack(IntVector<dynamic_t>& iv, const std::vector<uint64_t>& in, pack_f pack) {
+    pack(iv.data(), 0, iv.width(), iv.size(), in.data());
+    return iv[iv.size() / 2];
 }
 
-BENCHMARK("inc::empty", (int_test<uint32_t, NoOp>))
-BENCHMARK("inc::uint8_t", int_test<uint8_t>)
-BENCHMARK("inc::uint16_t", int_test<uint16_t>)
-BENCHMARK("inc::uint32_t", int_test<uint32_t>)
-BENCHMARK("inc::uint64_t", int_test<uint64_t>)
-BENCHMARK("inc::uint_t<1>", int_test<uint_t<1>>)
-BENCHMARK("inc::uint_t<8>", int_test<uint_t<8>>)
-BENCHMARK("inc::uint_t<16>", int_test<uint_t<16>>)
-BENCHMARK("inc::uint_t<24>", int_test<uint_t<24>>)
-BENCHMARK("inc::uint_t<32>", int_test<uint_t<32>>)
-BENCHMARK("inc::uint_t<40>", int_test<uint_t<40>>)
-BENCHMARK("inc::uint_t<64>", int_test<uint_t<64>>)
-
-BENCHMARK("ref::uint32_t&", [](benchpress::context* ctx) {
-    uint32_t n = 0;
-
-    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
-        escape(&n);
-        auto& x = n;
-        for (size_t j = 0; j < N_SUB_ITER; j++) {
-            x += 1;
-        }
+TEST(IntVectorBench, unpack) {
+    for (uint8_t w : BENCH_WIDTHS) {
+        auto iv = random_vector(BENCH_SIZE, w);
+        std::vector<uint64_t> out(BENCH_SIZE);
+
+        bench("unpack::element_wise", w, BENCH_SIZE, [&] {
+            for (size_t i = 0; i < iv.size(); i++) out[i] = iv[i];
+            return out[out.size() / 2];
+        });
+        bench("unpack::scalar", w, BENCH_SIZE, [&] {
+            return run_unpack(iv, out, kernels::unpack_scalar<uint64_t>);
+        });
+#ifdef __BMI2__
+        bench("unpack::bmi2", w, BENCH_SIZE, [&] {
+            return run_unpack(iv, out, kernels::unpack_bmi2<uint64_t>);
+        });
+#endif
+#ifdef __AVX2__
+        bench("unpack::avx2", w, BENCH_SIZE, [&] {
+            return run_unpack(iv, out, kernels::unpack_avx2);
+        });
+#endif
+        bench("unpack::IntVector", w, BENCH_SIZE, [&] {
+            iv.unpack(0, iv.size(), out.data());
+            return out[out.size() / 2];
+        });
     }
+}
 
-    escape(&n);
-})
-
-BENCHMARK("ref::uint_t<40>&", [](benchpress::context* ctx) {
-    uint_t<40> n = 0;
-
-    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
-        escape(&n);
-        auto& x = n;
-        for (size_t j = 0; j < N_SUB_ITER; j++) {
-            x += 1;
-        }
+TEST(IntVectorBench, pack) {
+    for (uint8_t w : BENCH_WIDTHS) {
+        auto iv = random_vector(BENCH_SIZE, w);
+        std::vector<uint64_t> in(BENCH_SIZE);
+        iv.unpack(0, iv.size(), in.data());
+
+        bench("pack::element_wise", w, BENCH_SIZE, [&] {
+            for (size_t i = 0; i < iv.size(); i++) iv[i] = in[i];
+            return uint64_t(iv[iv.size() / 2]);
+        });
+        bench("pack::scalar", w, BENCH_SIZE, [&] {
+            return run_pack(iv, in, kernels::pack_scalar<uint64_t>);
+        });
+#ifdef __BMI2__
+        bench("pack::bmi2", w, BENCH_SIZE, [&] {
+            return run_pack(iv, in, kernels::pack_bmi2<uint64_t>);
+        });
+#endif
+#ifdef __AVX2__
+        bench("pack::avx2", w, BENCH_SIZE, [&] {
+            return run_pack(iv, in, kernels::pack_avx2);
+        });
+#endif
+        bench("pack::IntVector", w, BENCH_SIZE, [&] {
+            iv.pack(0, iv.size(), in.data());
+            return uint64_t(iv[iv.size() / 2]);
+        });
     }
+}
 
-    escape(&n);
-})
-
-BENCHMARK("ref::IntRef", [](benchpress::context* ctx) {
-    using namespace tdc::int_vector;
-    uint64_t n = 0;
-
-    for (size_t i = 0; i < ctx->num_iterations(); ++i) {
-        escape(&n);
-        IntRef x(IntPtr(&n, 5, 32));
-        for (size_t j = 0; j < N_SUB_ITER; j++) {
-            x += 1;
+/// The element-wise width change that BitPackingVector used before
+/// kernels::change_width: front to back when shrinking, back to front when
+/// growing.
+void change_width_element_wise(uint64_t* data, uint8_t old_w, uint8_t new_w, size_t n) {
+    if (new_w < old_w) {
+        const uint64_t* old_ptr = data;
+        uint64_t* new_ptr = data;
+        uint8_t old_offset = 0, new_offset = 0;
+        for (size_t i = 0; i < n; i++) {
+            auto v = sdsl::bits::read_int_and_move(old_ptr, old_offset, old_w);
+            sdsl::bits::write_int_and_move(new_ptr, v, new_offset, new_w);
+        }
+    } else {
+        for (size_t i = n; i-- > 0;) {
+            const uint64_t old_p = uint64_t(i) * old_w;
+            const uint64_t new_p = uint64_t(i) * new_w;
+            auto v = sdsl::bits::read_int(data + (old_p >> 6), old_p & 63, old_w);
+            sdsl::bits::write_int(data + (new_p >> 6), v, new_p & 63, new_w);
         }
     }
+}
 
-    escape(&n);
-})
+TEST(IntVectorBench, width) {
+    // each run grows the elements to 64 bits and shrinks them back
+    for (uint8_t w : BENCH_WIDTHS) {
+        if (w == 64) continue;
+
+        auto iv = random_vector(BENCH_SIZE, w);
+        std::vector<uint64_t> data(BENCH_SIZE);
+        std::copy(iv.data(), iv.data() + (uint64_t(BENCH_SIZE) * w + 63) / 64, data.begin());
+
+        bench("width::element_wise", w, BENCH_SIZE, [&] {
+            change_width_element_wise(data.data(), w, 64, BENCH_SIZE);
+            change_width_element_wise(data.data(), 64, w, BENCH_SIZE);
+            return data[0];
+        });
+        bench("width::kernels", w, BENCH_SIZE, [&] {
+            kernels::change_width(data.data(), w, 64, BENCH_SIZE);
+            kernels::change_width(data.data(), 64, w, BENCH_SIZE);
+            return data[0];
+        });
+        bench("width::IntVector", w, BENCH_SIZE, [&] {
+            iv.width(64);
+            iv.width(w);
+            return uint64_t(iv[0]);
+        });
+    }
+}
@@ -25,8 +25,9 @@ using namespace lfs;
 
 
 
+template<typename comp_t = tdc::lfs::LFS2BSTCompressor<> >
 void run_comp(std::string compression_string) {
-    auto c = create_algo<tdc::lfs::LFS2BSTCompressor<> >();
+    auto c = create_algo<comp_t>();
 
     std::string compressed;
     // compress
@@ -74,4 +75,15 @@ TEST(lfs2, no_strat){
 
 }
 
-
+TEST(lfs2, lcp_intervals){
+    using comp_t = tdc::lfs::LFS2Compressor<>;
+
+    run_comp<comp_t>("");
+    run_comp<comp_t>("a");
+    run_comp<comp_t>("foobar");
+    run_comp<comp_t>("abaaabbababb$");
+    run_comp<comp_t>("ccaabbaabbcca$");
+    run_comp<comp_t>("foobarfoobarfoobar");
+    run_comp<comp_t>(FibonacciGenerator::generate(16));
+    run_comp<comp_t>(RandomUniformGenerator::generate(2000, 3, 'a', 'c'));
+}
@@ -83,6 +83,26 @@ TEST(lfs, bst_strat){
 }
 
 
+TEST(lfs, st_strat){
+    typedef tdc::lfs::STStrategy esa_strat;
+
+    run_comp<esa_strat >("");
+    run_comp<esa_strat >("a");
+    run_comp<esa_strat >("foobar");
+
+    run_comp<esa_strat >("ab");
+    run_comp<esa_strat >("abcd$");
+
+    run_comp<esa_strat >("abab");
+
+    run_comp<esa_strat >("abaaabbababb$");
+
+    run_comp<esa_strat >("ccaabbaabbcca$");
+
+    run_comp<esa_strat >("abcabcabcabcabcabcabc");
+
+}
+
 
 TEST(lfs, sim_st_strat){
 
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include <tudocomp/Compressor.hpp>
 #include <tudocomp/Generator.hpp>
 #include <tudocomp/CreateAlgorithm.hpp>
@@ -8,9 +10,16 @@
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
 #include <tudocomp/compressors/lzss/LZSSLiterals.hpp>
 
+#include <tudocomp/compressors/LZSSLCPCompressor.hpp>
+#include <tudocomp/coders/BitCoder.hpp>
+
 #include <tudocomp/compressors/lcpcomp/decompress/CompactDec.hpp>
 #include <tudocomp/compressors/lcpcomp/decompress/DecodeQueueListBuffer.hpp>
+#include <tudocomp/compressors/lcpcomp/decompress/ExtDec.hpp>
 #include <tudocomp/compressors/lcpcomp/decompress/MultiMapBuffer.hpp>
+#include <tudocomp/compressors/lcpcomp/decompress/ParallelDec.hpp>
+
+#include "test/util.hpp"
 
 using namespace tdc;
 
@@ -58,6 +67,51 @@ TEST(lzss, factor_buffer_sort) {
     }
 }
 
+TEST(lzss, factor_buffer_radix_sort) {
+    // large enough to be sorted in parallel if OpenMP is available
+    const size_t n = 1000000;
+    lzss::FactorBuffer buf;
+
+    std::vector<size_t> perm(n);
+    for(size_t i = 0; i < n; i++) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), std::mt19937(42));
+
+    for(size_t i = 0; i < n; i++) {
+        // positions spanning more than one radix digit
+        buf.emplace_back(perm[i] * 4099, perm[i], i);
+    }
+
+    ASSERT_FALSE(buf.is_sorted());
+    buf.sort();
+    ASSERT_TRUE(buf.is_sorted());
+    ASSERT_EQ(n, buf.size());
+
+    for(size_t i = 0; i < n; i++) {
+        ASSERT_EQ(i * 4099, buf.pos(i));
+        ASSERT_EQ(i, buf.src(i));
+        ASSERT_EQ(i, perm[buf.len(i)]);
+    }
+}
+
+TEST(lzss, factor_buffer_flatten) {
+    // text: abcdabcdabcd
+    lzss::FactorBuffer buf;
+    buf.emplace_back(8, 4, 4); // refers to the factor below
+    buf.emplace_back(4, 0, 4);
+    buf.emplace_back(1, 9, 2); // refers into the first factor
+
+    buf.sort();
+    buf.flatten();
+
+    // following the chain further would lead back to the factor itself
+    ASSERT_EQ(1, buf.pos(0));
+    ASSERT_EQ(5, buf.src(0));
+    ASSERT_EQ(4, buf.pos(1));
+    ASSERT_EQ(0, buf.src(1));
+    ASSERT_EQ(8, buf.pos(2));
+    ASSERT_EQ(0, buf.src(2));
+}
+
 TEST(lzss, text_literals_empty) {
     lzss::FactorBuffer empty;
     std::string tmp = "";
@@ -153,6 +207,50 @@ TEST(lzss, decode_back_buffer) {
     ASSERT_EQ("bananabanana", ss.str());
 }
 
+TEST(lzss, lz_copy) {
+    // compare against a character-by-character copy
+    std::vector<uliteral_t> init(512);
+    for(size_t i = 0; i < init.size(); ++i) init[i] = 'a' + (i * 7) % 26;
+
+    for(size_t src = 0; src < 100; src += 33) {
+        for(size_t dst = 0; dst < 200; ++dst) {
+            for(size_t len = 0; len < 150; len += 7) {
+                auto expected = init;
+                for(size_t i = 0; i < len; ++i) expected[dst + i] = expected[src + i];
+
+                auto buffer = init;
+                lz_copy(buffer.data() + dst, buffer.data() + src, len);
+                ASSERT_EQ(expected, buffer)
+                    << "src: " << src << ", dst: " << dst << ", len: " << len;
+            }
+        }
+    }
+}
+
+TEST(lzss, decode_back_buffer_flush) {
+    // decode more than a flush block of "banana"s with short and long factors
+    const size_t block = lzss::DecodeBackBuffer::flush_block_size;
+    const len_t n = block * 2 + 12345;
+    std::string expected(n, 0);
+    for(len_t i = 0; i < n; ++i) expected[i] = "banana"[i % 6];
+
+    std::stringstream ss;
+    lzss::DecodeBackBuffer buffer(n, ss);
+    buffer.decode_literal('b');
+    buffer.decode_literal('a');
+    buffer.decode_literal('n');
+    buffer.decode_factor(1, 3);
+    for(len_t i = 6; i < n;) {
+        const len_t len = std::min<len_t>(i, n - i);
+        buffer.decode_factor(0, len);
+        i += len;
+    }
+    ASSERT_GE(ss.str().size(), block);
+
+    buffer.write_to(ss);
+    ASSERT_EQ(expected, ss.str());
+}
+
 template<typename T>
 void test_forward_decode_buffer_chain() {
     T buffer = create_algo<T>("", 12);
@@ -185,6 +283,39 @@ void test_forward_decode_buffer_multiref() {
     ASSERT_EQ("bananabanana", ss.str());
 }
 
+template<typename T>
+void test_forward_decode_buffer_copies(
+    const std::string& options, size_t block, size_t k, size_t factor_length) {
+
+    // k copies of a random block, each one referring to the next
+    // and split into many small factors
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist('a', 'z');
+
+    std::string x;
+    for(size_t i = 0; i < block; i++) x.push_back(char(dist(gen)));
+
+    std::string expected;
+    for(size_t c = 0; c < k; c++) expected += x;
+
+    auto buffer = create_algo<T>(options, expected.size());
+
+    for(size_t c = 0; c + 1 < k; c++) {
+        for(size_t i = 0; i < block; i += factor_length) {
+            buffer.decode_factor((c + 1) * block + i, std::min(factor_length, block - i));
+        }
+    }
+    for(char c : x) buffer.decode_literal(c);
+    buffer.decode_eagerly();
+
+    IF_STATS(ASSERT_EQ(k - 1, buffer.longest_chain()));
+
+    std::stringstream ss;
+    buffer.write_to(ss);
+
+    ASSERT_EQ(expected, ss.str());
+}
+
 TEST(lzss, decode_forward_lm_buffer_chain) {
     test_forward_decode_buffer_chain<lcpcomp::CompactDec>();
 }
@@ -208,3 +339,144 @@ TEST(lzss, decode_forward_ql_buffer_chain) {
 TEST(lzss, decode_forward_ql_buffer_multiref) {
     test_forward_decode_buffer_multiref<lcpcomp::DecodeForwardQueueListBuffer>();
 }
+
+TEST(lzss, decode_forward_ext_chain) {
+    test_forward_decode_buffer_chain<lcpcomp::ExtDec>();
+}
+
+TEST(lzss, decode_forward_ext_multiref) {
+    test_forward_decode_buffer_multiref<lcpcomp::ExtDec>();
+}
+
+// the minimum memory budget forces several runs and windows
+TEST(lzss, decode_forward_ext_spill) {
+    test_forward_decode_buffer_copies<lcpcomp::ExtDec>("mem=0", 50000, 5, 100);
+}
+
+// more runs than can be merged at once
+TEST(lzss, decode_forward_ext_fan_in) {
+    test_forward_decode_buffer_copies<lcpcomp::ExtDec>("mem=0", 40000, 3, 2);
+}
+
+TEST(lzss, ext_run_buffer) {
+    using lcpcomp::ext::PendingFactor;
+    const size_t capacity = 4;
+    const size_t n = capacity * lcpcomp::ext::MAX_FAN_IN * 70 + 3;
+
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<len_t> dist(0, n);
+
+    lcpcomp::ext::RunBuffer<PendingFactor> buffer("", capacity);
+    std::vector<len_t> expected;
+    for(size_t i = 0; i < n; i++) {
+        const len_t source = dist(gen);
+        buffer.push_back(PendingFactor { len_t(i), source, 1 });
+        expected.push_back(source);
+    }
+    ASSERT_EQ(n, buffer.size());
+
+    auto runs = buffer.finish();
+    ASSERT_LE(runs.size(), lcpcomp::ext::MAX_FAN_IN);
+
+    // the runs only get a single record of buffer each
+    lcpcomp::ext::RunMerger<PendingFactor> merger(runs, 0);
+    std::vector<len_t> sources;
+    PendingFactor f;
+    while(merger.next(f)) sources.push_back(f.source);
+
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(expected, sources);
+}
+
+TEST(lzss, decode_forward_par_chain) {
+    test_forward_decode_buffer_chain<lcpcomp::ParallelDec>();
+}
+
+TEST(lzss, decode_forward_par_multiref) {
+    test_forward_decode_buffer_multiref<lcpcomp::ParallelDec>();
+}
+
+// decoded without the sequential tail
+TEST(lzss, decode_forward_par_levels) {
+    test_forward_decode_buffer_copies<lcpcomp::ParallelDec>("tail=0", 100000, 8, 10);
+}
+
+TEST(lzss, decode_forward_par_deep_chain) {
+    // the first character refers to the last one and every other character
+    // to its predecessor, so each level resolves a single factor and the
+    // rest needs to be left to the sequential decoder
+    const size_t n = 100000;
+
+    auto buffer = create_algo<lcpcomp::ParallelDec>("tail=0", n);
+    buffer.decode_factor(n - 1, 1);
+    for(size_t i = 1; i + 1 < n; i++) buffer.decode_factor(i - 1, 1);
+    buffer.decode_literal('a');
+    buffer.decode_eagerly();
+
+    std::stringstream ss;
+    buffer.write_to(ss);
+
+    ASSERT_EQ(std::string(n, 'a'), ss.str());
+}
+
+std::string lzss_lcp_compress(const std::string& text, const std::string& options) {
+    using comp_t = LZSSLCPCompressor<BitCoder>;
+    auto c = create_algo<comp_t>(options);
+
+    std::vector<uint8_t> compressed;
+    {
+        Input in(text);
+        Input restricted(in, comp_t::meta().textds_flags());
+        Output out(compressed);
+        c.compress(restricted, out);
+    }
+
+    std::vector<uint8_t> decompressed;
+    {
+        Input in(compressed);
+        Output out(decompressed);
+        Output restricted(out, comp_t::meta().textds_flags());
+        c.decompress(in, restricted);
+    }
+    EXPECT_EQ(text, std::string(decompressed.begin(), decompressed.end()));
+
+    return std::string(compressed.begin(), compressed.end());
+}
+
+TEST(lzss, lcp_kkp_equals_scan) {
+    auto check = [](const std::string& text) {
+        for(auto threshold : { "1", "3", "8" }) {
+            const std::string t = std::string("threshold=") + threshold;
+            const auto scan = lzss_lcp_compress(text, t + ", mode=\"scan\"");
+            ASSERT_EQ(scan, lzss_lcp_compress(text, t + ", mode=\"kkp\""))
+                << "text: " << text << ", " << t;
+            ASSERT_EQ(scan, lzss_lcp_compress(text, t + ", mode=\"parallel\""))
+                << "text: " << text << ", " << t;
+        }
+    };
+
+    test::roundtrip_batch([&](View text) { check(std::string(text)); });
+    for(size_t i = 2; i < 16; i++) {
+        check(FibonacciGenerator::generate(i));
+        check(ThueMorseGenerator::generate(i));
+        check(RunRichGenerator::generate(i));
+        check(RandomUniformGenerator::generate(1 << i, i, 'a', 'c'));
+    }
+}
+
+TEST(lzss, lcp_parallel_threads) {
+    // large enough to be split among the threads
+    auto check = [](const std::string& text) {
+        const auto kkp = lzss_lcp_compress(text, "mode=\"kkp\"");
+        for(auto threads : { "1", "2", "4" }) {
+            ASSERT_EQ(kkp, lzss_lcp_compress(text,
+                std::string("mode=\"parallel\", threads=") + threads))
+                << "threads: " << threads;
+        }
+    };
+
+    check(FibonacciGenerator::generate(28));
+    check(RunRichGenerator::generate(18));
+    check(RandomUniformGenerator::generate(1 << 19, 42, 'a', 'c'));
+    check(std::string(1 << 18, 'a')); // decreasing suffix array
+}
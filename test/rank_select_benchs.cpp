@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "test/util.hpp"
+#include "test/bench_util.hpp"
+
+#include <random>
+
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/Rank.hpp>
+#include <tudocomp/ds/Select.hpp>
+
+using namespace tdc;
+
+TEST(RankSelectBench, throughput) {
+    const size_t n = 1ULL << 26;
+    const size_t queries = 1ULL << 20;
+
+    std::mt19937_64 gen(42);
+    for(double density : { 0.01, 0.5 }) {
+        std::bernoulli_distribution bit(density);
+        BitVector bv(n);
+        for(size_t i = 0; i < n; i++) bv[i] = bit(gen);
+
+        Rank r(bv);
+        Select1 s1(bv);
+        Select0 s0(bv);
+        const size_t ones = r.rank1(n - 1);
+
+        std::vector<size_t> pos(queries), ord1(queries), ord0(queries);
+        for(size_t q = 0; q < queries; q++) {
+            pos[q] = gen() % n;
+            ord1[q] = 1 + gen() % ones;
+            ord0[q] = 1 + gen() % (n - ones);
+        }
+
+        std::cout << "density " << density << ":" << std::endl;
+        test::bench_median("rank1", "ns/query", queries, [&]{
+            size_t sum = 0;
+            for(size_t x : pos) sum += r.rank1(x);
+            return sum;
+        });
+        test::bench_median("select1", "ns/query", queries, [&]{
+            size_t sum = 0;
+            for(size_t x : ord1) sum += s1(x);
+            return sum;
+        });
+        test::bench_median("select0", "ns/query", queries, [&]{
+            size_t sum = 0;
+            for(size_t x : ord0) sum += s0(x);
+            return sum;
+        });
+    }
+}
@@ -1,6 +1,8 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include <tudocomp/ds/IntVector.hpp>
 #include <tudocomp/ds/rank_64bit.hpp>
 #include <tudocomp/ds/select_64bit.hpp>
@@ -270,3 +272,39 @@ TEST(rank_select, inverse_property_bv) {
         }
     });
 }
+
+template<typename F>
+void random_bv_test(F f) {
+    std::mt19937_64 gen(42);
+    for(size_t n : { 1, 63, 64, 65, 511, 512, 513, 10000, 100003 }) {
+        for(double density : { 0.0, 0.001, 0.5, 0.999, 1.0 }) {
+            std::bernoulli_distribution bit(density);
+            BitVector bv(n);
+            for(size_t i = 0; i < n; i++) bv[i] = bit(gen);
+            f(bv);
+        }
+    }
+}
+
+TEST(rank_select, random_bv) {
+    random_bv_test([](const BitVector& bv){
+        const size_t n = bv.size();
+        Rank r(bv);
+        Select1 s1(bv);
+        Select0 s0(bv);
+
+        size_t ones = 0;
+        for(size_t i = 0; i < n; i++) {
+            if(bv[i]) {
+                ++ones;
+                ASSERT_EQ(i, s1(ones));
+            } else {
+                ASSERT_EQ(i, s0(i + 1 - ones));
+            }
+            ASSERT_EQ(ones, r.rank1(i));
+            ASSERT_EQ(i + 1 - ones, r.rank0(i));
+        }
+        ASSERT_EQ(n, s1(ones + 1));
+        ASSERT_EQ(n, s0(n - ones + 1));
+    });
+}
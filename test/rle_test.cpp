@@ -19,3 +19,112 @@ TEST(RLE, string_test) {
 	std::function<void(std::string&)> func(test_rle);
 	test::on_string_generators(func,20);
 }
+
+/// The reference implementation the encoding must agree with.
+std::string rle_reference(const std::string& input, size_t offset) {
+	std::ostringstream os;
+	if(input.empty()) return os.str();
+	char prev = input[0];
+	os << prev;
+	for(size_t i = 1; i < input.size(); ++i) {
+		const char c = input[i];
+		if(prev == c) {
+			size_t run = 0;
+			while(i + 1 < input.size() && input[i + 1] == c) { ++run; ++i; }
+			os << c;
+			write_vbyte(os, run + offset);
+		} else {
+			os << c;
+		}
+		prev = c;
+	}
+	return os.str();
+}
+
+TEST(RLE, buffer) {
+	std::vector<std::string> inputs {
+		"", "a", "aa", "aaa", "ab", "aab", "abb", "abba",
+		std::string(1000, 'x'),
+		std::string(40, 'a') + "b" + std::string(17, 'b') + "cdcd" + std::string(300000, 'e'),
+	};
+
+	// runs of all lengths at all positions relative to a block of 16
+	std::string mixed;
+	for(size_t len = 1; len < 40; ++len) {
+		mixed += std::string(len, char('a' + len % 2)) + "xyz";
+	}
+	inputs.push_back(mixed);
+
+	for(size_t offset : { 0, 3 }) {
+		for(auto& input : inputs) {
+			std::ostringstream encoded;
+			rle_encode((const uint8_t*) input.data(), input.size(), encoded, offset);
+			ASSERT_EQ(rle_reference(input, offset), encoded.str());
+
+			const std::string e = encoded.str();
+			std::ostringstream decoded;
+			rle_decode((const uint8_t*) e.data(), e.size(), decoded, offset);
+			ASSERT_EQ(input, decoded.str());
+		}
+	}
+}
+
+TEST(RLE, stream) {
+	// runs and run lengths crossing the border of the blocks read
+	const size_t chunk = rle::STREAM_CHUNK;
+	std::vector<std::string> inputs {
+		std::string(chunk, 'a'), std::string(chunk + 1, 'a'),
+		std::string(3 * chunk + 5, 'a') + "b",
+	};
+	for(size_t d = 0; d < 4; ++d) {
+		inputs.push_back(std::string(chunk - d, 'x') + "y");
+		inputs.push_back(std::string(chunk - 200 - d, 'x') + "yz" + std::string(300, 'z'));
+		inputs.push_back(std::string(chunk - 1 - d, 'x') + "yz" + std::string(2 * chunk, 'w'));
+	}
+	std::string alternating;
+	for(size_t i = 0; alternating.size() < 3 * chunk; ++i) {
+		alternating += std::string(1 + i % 300, char('a' + i % 2));
+	}
+	inputs.push_back(alternating);
+
+	// short runs, so that the encoding spans several blocks, too
+	std::string short_runs;
+	for(size_t i = 0; short_runs.size() < 20 * chunk; ++i) {
+		const size_t len = (i % 16 == 0) ? 150 + i % 50 : 1 + i % 3;
+		short_runs += std::string(len, char('a' + i % 2));
+	}
+	inputs.push_back(short_runs);
+
+	for(size_t offset : { 0, 3 }) {
+		for(auto& input : inputs) {
+			std::istringstream is(input);
+			std::ostringstream encoded;
+			rle_encode(is, encoded, offset);
+			ASSERT_EQ(rle_reference(input, offset), encoded.str());
+
+			// decode with the run lengths at all positions relative to a block
+			// (prepending characters without runs)
+			for(const std::string prefix : { "", "0", "01", "010" }) {
+				std::istringstream es(prefix + encoded.str());
+				std::ostringstream decoded;
+				rle_decode(es, decoded, offset);
+				ASSERT_EQ(prefix + input, decoded.str()) << "prefix=" << prefix;
+			}
+		}
+	}
+}
+
+#ifdef __SSE2__
+TEST(RLE, kernels) {
+	std::string s;
+	for(size_t len = 1; len < 40; ++len) s += std::string(len, char('a' + len % 3)) + "xy";
+	const uint8_t* t = (const uint8_t*) s.data();
+
+	for(size_t from = 1; from < s.size(); ++from) {
+		ASSERT_EQ(rle::find_pair_scalar(t, from, s.size()),
+		          rle::find_pair_sse2(t, from, s.size()));
+		ASSERT_EQ(rle::find_mismatch_scalar(t, from, s.size(), t[from]),
+		          rle::find_mismatch_sse2(t, from, s.size(), t[from]));
+	}
+}
+#endif
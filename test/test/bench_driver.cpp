@@ -1,3 +0,0 @@
-#include <glog/logging.h>
-#define BENCHPRESS_CONFIG_MAIN
-#include "benchpress/benchpress.hpp"
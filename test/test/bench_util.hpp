@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <tudocomp_stat/Timing.hpp>
+
+namespace tdc {
+namespace test {
+
+/// Runs the given operation repeatedly and prints its median running time
+/// divided by the amount of items it processes.
+///
+/// The operation returns a checksum of its results. The sum of all
+/// checksums is printed, so that the work cannot be optimized away.
+///
+/// \param name the name of the benchmark, padded to `width` characters
+/// \param unit the unit of the printed time, e.g., "ns/element"
+/// \param items the amount of items processed by one run
+template<typename F>
+inline void bench_median(
+    const std::string& name, const std::string& unit, size_t items, F f,
+    size_t repetitions = 5, int width = 30, int precision = 3) {
+
+    Timings timings;
+    uint64_t checksum = 0;
+    for(size_t rep = 0; rep < repetitions; rep++) {
+        timings.measure([&]{ checksum += f(); });
+    }
+
+    std::cout << std::setw(width) << std::left << name
+              << std::setw(10) << std::right
+              << std::fixed << std::setprecision(precision)
+              << (timings.median() / items) << " " << unit
+              << "  (checksum " << checksum << ")"
+              << std::endl;
+}
+
+}} //ns
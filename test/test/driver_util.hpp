@@ -51,14 +51,13 @@ std::string shell_escape(const std::string& s) {
     return r;
 }
 
-std::string driver(std::string args) {
+std::string execute(const std::string& cmd_base) {
     using namespace std;
 
     FILE *in;
     char buff[512];
     std::stringstream ss;
 
-    const std::string cmd_base = "./src/tudocomp_driver/tudocomp_driver " + args + " 2>&1";
     const std::string cmd = std::string("sh -c ") + shell_escape(cmd_base) + " 2>&1";
 
     if(!(in = popen(cmd.data(), "r"))) {
@@ -73,6 +72,14 @@ std::string driver(std::string args) {
     return ss.str();
 }
 
+std::string driver(std::string args) {
+    return execute("./src/tudocomp_driver/tudocomp_driver " + args + " 2>&1");
+}
+
+std::string bench(std::string args) {
+    return execute("./src/tudocomp_driver/tudocomp_bench " + args + " 2>&1");
+}
+
 std::string roundtrip_in_file_name_ending() {
     return ".txt";
 }
@@ -1,6 +1,5 @@
-# Grab gtest and microbenchmark support
+# Grab gtest
 find_or_download_package(GTest GTEST gtest)
-#find_or_download_package(Benchpress BENCHPRESS benchpress)
 
 # Custom test target to run the googletest tests
 add_custom_target(check)
@@ -18,7 +17,7 @@ add_custom_command(
     COMMENT "All test builds were successful!" VERBATIM
 )
 
-# Custom test target to run the benchpress benchmarks
+# Custom test target to run the benchmarks
 add_custom_target(bench)
 add_custom_command(
     TARGET bench
@@ -26,7 +25,7 @@ add_custom_command(
     COMMENT "All bench were successful!" VERBATIM
 )
 
-# Custom test target to just build the benchpress benchmarks
+# Custom test target to just build the benchmarks
 add_custom_target(build_bench)
 add_custom_command(
     TARGET build_bench
@@ -139,11 +138,14 @@ generic_run_test(
 )
 endmacro()
 
+# Benchmarks are googletest executables as well, but are only run
+# by the bench target since they take considerably longer.
 macro(run_bench test_target)
 generic_run_test(
     ${test_target}
-    "test/bench_driver.cpp"
-    benchpress
+    "${test_target}.cpp"
+    "test/test_driver.cpp"
+    gtest
     bench
     build_bench
     "Bench"
@@ -48,6 +48,61 @@ TEST(TudocompDriver, algorithm_header) {
 
 }
 
+TEST(TudocompBench, report) {
+    std::string text;
+    for(size_t i = 0; i < 1000; ++i) text += "abcabbbbbbbbcdaaaab";
+    test::write_test_file("bench_input.txt", text);
+
+    const std::string report_file = test::test_file_path("bench_report.json");
+    const std::string out = driver_test::bench(
+        "-n 3 -w 1 -a 'lz78(ascii)' -a rle -o " + report_file + " "
+        + test::test_file_path("bench_input.txt"));
+    ASSERT_EQ(out, "");
+
+    const std::string report = test::read_test_file("bench_report.json");
+    auto count = [&](const std::string& s) {
+        size_t n = 0;
+        for(size_t p = report.find(s); p != std::string::npos; p = report.find(s, p + 1)) ++n;
+        return n;
+    };
+
+    // the report is plottable by the charter
+    ASSERT_EQ(count("\"meta\": "), 1u);
+    ASSERT_EQ(count("\"data\": "), 1u);
+    ASSERT_EQ(count("\"inputSize\": " + std::to_string(text.size())), 1u);
+
+    // both algorithms are measured in both directions
+    ASSERT_EQ(count("\"config\": \"lz78(ascii)\""), 1u);
+    ASSERT_EQ(count("\"config\": \"rle\""), 1u);
+    ASSERT_EQ(count("\"verified\": true"), 2u);
+    ASSERT_EQ(count("\"medianNs\": "), 4u);
+    ASSERT_EQ(count("\"madNs\": "), 4u);
+    ASSERT_EQ(count("\"throughputMiBs\": "), 4u);
+
+    // an unknown algorithm is reported, but does not stop the others
+    const std::string err = driver_test::bench(
+        "-n 1 -a foo -a rle -o " + report_file + " "
+        + test::test_file_path("bench_input.txt"));
+    ASSERT_NE(err.find("foo"), std::string::npos);
+
+    const std::string report2 = test::read_test_file("bench_report.json");
+    ASSERT_NE(report2.find("\"error\": "), std::string::npos);
+    ASSERT_NE(report2.find("\"verified\": true"), std::string::npos);
+
+    // invalid amounts of runs are rejected
+    const std::string input = test::test_file_path("bench_input.txt");
+    for(auto n : { "0", "-1", "x", "3x" }) {
+        const std::string usage = driver_test::bench(
+            std::string("-n ") + n + " -a rle " + input);
+        ASSERT_NE(usage.find("invalid amount of repetitions"), std::string::npos) << n;
+    }
+    for(auto w : { "-1", "x", "99999999999999999999999" }) {
+        const std::string usage = driver_test::bench(
+            std::string("-w ") + w + " -a rle " + input);
+        ASSERT_NE(usage.find("invalid amount of warmup runs"), std::string::npos) << w;
+    }
+}
+
 TEST(Registry, smoketest) {
     using namespace tdc_algorithms;
     using ast::Value;
@@ -1,7 +1,9 @@
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
 #include <gtest/gtest.h>
@@ -16,6 +18,8 @@
 #include <tudocomp/CreateAlgorithm.hpp>
 #include <tudocomp/io/MMapHandle.hpp>
 #include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/util/HugePages.hpp>
+#include <tudocomp_stat/StatPhase.hpp>
 
 #include "test/util.hpp"
 
@@ -726,6 +730,106 @@ TEST(IO, bits_eof) {
     }
 }
 
+TEST(IO, bits_write_ints) {
+    // writing a sequence of integers at once must equal writing them one by
+    // one, for any width and any amount of bits pending in the buffer byte
+    std::vector<uint64_t> values;
+    for(uint64_t i = 0; i < 1000; i++) values.push_back(i * 0x9E3779B97F4A7C15ULL);
+
+    for(size_t bits = 0; bits <= 64; bits += 3) {
+        for(size_t pending = 0; pending < 8; pending++) {
+            std::string expected, result;
+            {
+                std::ostringstream ss;
+                Output output(ss);
+                {
+                    BitOStream out(output);
+                    out.write_int(0x55, pending);
+                    for(auto v : values) out.write_int(v - 7, bits);
+                    out.write_bit(1);
+                }
+                expected = ss.str();
+            }
+            {
+                std::ostringstream ss;
+                Output output(ss);
+                {
+                    BitOStream out(output);
+                    out.write_int(0x55, pending);
+                    out.write_ints(values.data(), values.size(), bits, 7);
+                    out.write_bit(1);
+                }
+                result = ss.str();
+            }
+            ASSERT_EQ(expected, result) << "bits=" << bits << ", pending=" << pending;
+        }
+    }
+}
+
+TEST(IO, bits_universal_codes) {
+    // values of all bit widths, enough for the input to be read in
+    // several blocks
+    std::vector<uint64_t> values;
+    for(uint64_t i = 0; i < 100000; i++) {
+        const size_t bits = i % 65;
+        values.push_back(bits ? (i * 0x9E3779B97F4A7C15ULL) >> (64 - bits) : 0);
+    }
+
+    // codes written at once must equal codes written bit by bit
+    std::string expected, result;
+    {
+        std::ostringstream ss;
+        Output output(ss);
+        {
+            BitOStream out(output);
+            for(auto v : values) {
+                const size_t u = v % 200;
+                for(size_t k = 0; k < u; k++) out.write_bit(0);
+                out.write_bit(1);
+
+                for(size_t k = 0; k < bits_for(v); k++) out.write_bit(0);
+                out.write_bit(1);
+                out.write_int(v, bits_for(v));
+
+                const size_t b = bits_for(v);
+                for(size_t k = 0; k < bits_for(b); k++) out.write_bit(0);
+                out.write_bit(1);
+                out.write_int(b, bits_for(b));
+                out.write_int(v, b);
+            }
+        }
+        expected = ss.str();
+    }
+    {
+        std::ostringstream ss;
+        Output output(ss);
+        {
+            BitOStream out(output);
+            for(auto v : values) {
+                out.write_unary(v % 200);
+                out.write_elias_gamma(v);
+                out.write_elias_delta(v);
+            }
+        }
+        result = ss.str();
+    }
+    ASSERT_EQ(expected, result);
+
+    const size_t block = BitIStream::block_size;
+    ASSERT_GT(result.size(), 2 * block);
+
+    {
+        Input input(result);
+        BitIStream in(input);
+        for(auto v : values) {
+            ASSERT_EQ(v % 200, in.read_unary<uint64_t>());
+            ASSERT_EQ(v, in.read_elias_gamma<uint64_t>());
+            ASSERT_EQ(v, in.read_elias_delta<uint64_t>());
+        }
+        ASSERT_TRUE(in.eof());
+    }
+}
+
 TEST(View, construction) {
     static const uint8_t DATA[3] = { 'f', 'o', 'o' };
 
@@ -1456,6 +1560,51 @@ TEST(KeywordlessEvalOrder, test) {
     r.parse_algorithm_id("eval_order_bug");
 }
 
+size_t lazy_meta_calls[2];
+
+template<class A, size_t family>
+struct LazyComp: public Compressor {
+    inline static Meta meta() {
+        ++lazy_meta_calls[family];
+        Meta y("compressor", family == 0 ? "lazy_a" : "lazy_b");
+        y.option("sub").templated<A, MySubAlgo>("sub_t");
+        return y;
+    }
+
+    using Compressor::Compressor;
+
+    inline virtual void compress(Input&, Output&) {}
+    inline virtual void decompress(Input&, Output&) {}
+};
+
+TEST(Registry, lazy_families) {
+    lazy_meta_calls[0] = lazy_meta_calls[1] = 0;
+
+    Registry<Compressor> r("compressor");
+    r.register_family([](Registry<Compressor>& r) {
+        r.register_algorithm<LazyComp<MySubAlgo, 0>>();
+        r.register_algorithm<LazyComp<MySubAlgo2, 0>>();
+    });
+    r.register_algorithm<LazyComp<MySubAlgo, 1>>();
+
+    // registering evaluates nothing
+    ASSERT_EQ(lazy_meta_calls[0], 0);
+    ASSERT_EQ(lazy_meta_calls[1], 0);
+
+    // only the requested family is evaluated,
+    // the others are only inspected for their name
+    ASSERT_TRUE(r.select("lazy_b(sub1)") != nullptr);
+    ASSERT_EQ(lazy_meta_calls[0], 1);
+    ASSERT_GE(lazy_meta_calls[1], 1);
+
+    ASSERT_TRUE(r.select("lazy_a(sub2)") != nullptr);
+    ASSERT_EQ(lazy_meta_calls[0], 3);
+
+    // the whole registry is available for enumeration
+    ASSERT_EQ(r.all_algorithms_with_static("compressor").size(), 3);
+    ASSERT_EQ(lazy_meta_calls[0], 3);
+}
+
 TEST(MMapHandle, test1) {
     auto s = "asdkfjkasldlasdkflhkasddklashldasldkjalskdd"_v;
     test::write_test_file("mmap1.txt", s);
@@ -1507,3 +1656,110 @@ TEST(Util, power_of_two) {
     ASSERT_EQ(zero_or_next_power_of_two(7), 8);
     ASSERT_EQ(zero_or_next_power_of_two(8), 8);
 }
+
+#ifndef STATS_DISABLED
+// returns the value of the first occurrence of a numeric field
+static uint64_t json_field(const std::string& json, const std::string& key) {
+    const size_t pos = json.find("\"" + key + "\": ");
+    CHECK_NE(pos, std::string::npos) << key;
+    return std::stoull(json.substr(pos + key.size() + 4));
+}
+
+TEST(Stats, resource_usage) {
+    StatPhase root("root");
+
+    const std::string busy = StatPhase::wrap("busy", [](StatPhase& phase){
+        const auto start = std::chrono::steady_clock::now();
+        volatile uint64_t x = 0;
+        while(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(3)) {
+            for(size_t i = 0; i < 1000; ++i) x = x + i;
+        }
+        return phase.to_json().str();
+    });
+
+    const std::string idle = StatPhase::wrap("idle", [](StatPhase& phase){
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return phase.to_json().str();
+    });
+
+    for(auto& json : { busy, idle }) {
+        const uint64_t start = json_field(json, "timeStartNs");
+        const uint64_t end = json_field(json, "timeEndNs");
+        ASSERT_LE(start, end);
+        ASSERT_EQ(json_field(json, "timeStart"), start / 1000000);
+        ASSERT_EQ(json_field(json, "timeEnd"), end / 1000000);
+        ASSERT_NE(json.find("\"cpuUserNs\""), std::string::npos);
+        ASSERT_NE(json.find("\"cpuSysNs\""), std::string::npos);
+    }
+
+    // the busy phase is measured in sub-millisecond precision and spends
+    // its time on the CPU, the idle phase does not
+    const uint64_t busy_wall = json_field(busy, "timeEndNs") - json_field(busy, "timeStartNs");
+    ASSERT_GE(busy_wall, 3000000U);
+    ASSERT_GT(json_field(busy, "cpuThreadNs"), 0U);
+
+    const uint64_t idle_wall = json_field(idle, "timeEndNs") - json_field(idle, "timeStartNs");
+    ASSERT_GE(idle_wall, 20000000U);
+    ASSERT_LT(json_field(idle, "cpuThreadNs"), idle_wall / 2);
+
+    // hardware counters are optional, but complete if present
+    if(busy.find("\"counters\"") != std::string::npos) {
+        const PerfCounters& perf = PerfCounters::get();
+        for(size_t i = 0; i < PerfCounters::num; ++i) {
+            ASSERT_EQ(busy.find(PerfCounters::name(i)) != std::string::npos,
+                      perf.available(i));
+        }
+    }
+}
+
+TEST(HugePages, allocation) {
+    using namespace huge_pages;
+
+    const size_t n = 3 * page_size / sizeof(uint64_t) + 1;
+
+    for(Policy policy : { Policy::none, Policy::transparent, Policy::hugetlb }) {
+        global_policy() = policy;
+
+        const std::string json = StatPhase::wrap("huge pages", [&](StatPhase& phase){
+            {
+                DynamicIntVector iv(n, 0, 64);
+                for(size_t i = 0; i < n; ++i) iv[i] = i * 7;
+                for(size_t i = 0; i < n; ++i) EXPECT_EQ(uint64_t(iv[i]), i * 7);
+                if(policy != Policy::none) {
+                    EXPECT_EQ(uintptr_t(iv.data()) % page_size, 0U);
+                }
+
+                // small allocations are not affected
+                DynamicIntVector small(16, 1, 64);
+                EXPECT_EQ(uint64_t(small[15]), 1U);
+            }
+            {
+                io::MMap map(page_size + 1);
+                auto view = map.view();
+                for(size_t i = 0; i < view.size(); ++i) view[i] = uint8_t(i);
+                if(policy != Policy::none) {
+                    EXPECT_EQ(uintptr_t(view.data()) % page_size, 0U);
+                }
+
+                map.remap(2 * page_size + 1);
+                auto grown = map.view();
+                EXPECT_EQ(grown.size(), 2 * page_size + 1);
+                for(size_t i = 0; i <= page_size; ++i) EXPECT_EQ(grown[i], uint8_t(i));
+                grown[2 * page_size] = 1;
+            }
+            return phase.to_json().str();
+        });
+
+        // mapped memory is accounted for like heap memory, rounded up to
+        // full huge pages
+        const size_t bytes = n * sizeof(uint64_t);
+        const size_t expected_peak = applies(policy, bytes) ? mapped_size(bytes) : bytes;
+        ASSERT_GE(json_field(json, "memPeak"), expected_peak);
+        ASSERT_LT(json_field(json, "memFinal"), page_size);
+    }
+
+    global_policy() = Policy::none;
+    ASSERT_THROW(parse_policy("gigantic"), std::invalid_argument);
+    ASSERT_EQ(parse_policy("thp"), Policy::transparent);
+}
+#endif
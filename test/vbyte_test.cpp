@@ -33,3 +33,26 @@ TEST(VByte, heavy) {
 	}
 
 }
+
+TEST(VByte, buffer) {
+	std::vector<size_t> values;
+	for(size_t i = 0; i < 1ULL<<10; ++i) values.push_back(i);
+	for(size_t i = 1; i < 1ULL<<63; i<<=1) values.push_back(i);
+	values.push_back(~size_t(0));
+
+	// equal to the stream encoding
+	std::stringstream ss;
+	std::vector<uint8_t> buffer(values.size() * VBYTE_MAX_BYTES);
+	uint8_t* end = buffer.data();
+	for(size_t v : values) {
+		write_vbyte(ss, v);
+		end = write_vbyte(end, v);
+	}
+	ASSERT_EQ(ss.str(), std::string(buffer.data(), end));
+
+	const uint8_t* p = buffer.data();
+	for(size_t v : values) {
+		ASSERT_EQ(v, read_vbyte<size_t>(p, (const uint8_t*) end));
+	}
+	ASSERT_EQ(end, p);
+}